@@ -0,0 +1,258 @@
+// Compares the cache behavior of Morton and Hilbert order, reporting the time and cache
+// misses (read from the hardware counters through perf_event_open on Linux, where
+// permitted) of:
+//
+// - Sweeps: a row-major 3D grid is visited in row-major, tiled, Morton, and Hilbert
+//   order with a 7-point stencil. Row-major order streams through memory, so it is the
+//   baseline the curves try to get close to when the traversal cannot be row-major.
+// - Box queries: the grid is stored in row-major, Morton, or Hilbert order and all
+//   cells of randomly placed boxes are read, as for a spatial query.
+//
+// Usage: ufoutility_benchmarks [levels = 8] [repetitions = 5]
+
+// UFO
+#include <ufo/utility/hilbert.hpp>
+#include <ufo/utility/morton.hpp>
+#include <ufo/utility/multi_index_iterator.hpp>
+
+// STL
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+class CacheMissCounter
+{
+ public:
+	CacheMissCounter(std::uint32_t type, std::uint64_t config)
+	{
+#if defined(__linux__)
+		perf_event_attr attr{};
+		attr.size           = sizeof(attr);
+		attr.type           = type;
+		attr.config         = config;
+		attr.disabled       = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv     = 1;
+		fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+		(void)type;
+		(void)config;
+#endif
+	}
+
+	CacheMissCounter(CacheMissCounter const&)            = delete;
+	CacheMissCounter& operator=(CacheMissCounter const&) = delete;
+
+	~CacheMissCounter()
+	{
+#if defined(__linux__)
+		if (valid()) {
+			close(fd_);
+		}
+#endif
+	}
+
+	[[nodiscard]] bool valid() const noexcept { return 0 <= fd_; }
+
+	void start()
+	{
+#if defined(__linux__)
+		if (valid()) {
+			ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	[[nodiscard]] long long stop()
+	{
+		long long count = -1;
+#if defined(__linux__)
+		if (valid()) {
+			ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+			if (sizeof(count) != read(fd_, &count, sizeof(count))) {
+				count = -1;
+			}
+		}
+#endif
+		return count;
+	}
+
+ private:
+	int fd_ = -1;
+};
+
+struct Result {
+	double    ms{};
+	long long l1_misses{};
+	long long llc_misses{};
+	float     sum{};
+};
+
+// The visiting order is computed up front, so only the memory accesses are measured and
+// not the cost of computing the curve
+std::vector<std::uint32_t> visitOrder(int n, ufo::TraversalOrder order)
+{
+	using Index = std::array<int, 3>;
+
+	std::vector<std::uint32_t> offsets;
+	offsets.reserve(static_cast<std::size_t>(n) * n * n);
+
+	// Only the interior cells have all neighbors, but the whole grid is traversed so the
+	// extents are the same power of two
+	ufo::MultiIndexIterator<3, int>(Index{0, 0, 0}, Index{n, n, n}, order)
+	    .forEach([&](Index const& i) {
+		    auto const [x, y, z] = i;
+		    if (0 != x && 0 != y && 0 != z && n - 1 != x && n - 1 != y && n - 1 != z) {
+			    offsets.push_back(static_cast<std::uint32_t>((x * n + y) * n + z));
+		    }
+	    });
+
+	return offsets;
+}
+
+// Offsets of all cells of `num_boxes` randomly placed boxes of `size^3` cells, with the
+// grid stored in the order given by `layout`
+template <class Layout>
+std::vector<std::uint32_t> boxOffsets(int n, int num_boxes, int size, Layout layout)
+{
+	std::mt19937                       gen(42);
+	std::uniform_int_distribution<int> dist(0, n - size);
+
+	std::vector<std::uint32_t> offsets;
+	offsets.reserve(static_cast<std::size_t>(num_boxes) * size * size * size);
+	for (int b{}; num_boxes != b; ++b) {
+		int const x0 = dist(gen);
+		int const y0 = dist(gen);
+		int const z0 = dist(gen);
+		for (int x = x0; x0 + size != x; ++x) {
+			for (int y = y0; y0 + size != y; ++y) {
+				for (int z = z0; z0 + size != z; ++z) {
+					offsets.push_back(static_cast<std::uint32_t>(layout(x, y, z)));
+				}
+			}
+		}
+	}
+	return offsets;
+}
+
+template <bool Stencil>
+Result measure(std::vector<float> const& grid, int n,
+               std::vector<std::uint32_t> const& offsets)
+{
+#if defined(__linux__)
+	CacheMissCounter l1(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+	                                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+	                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+	CacheMissCounter llc(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#else
+	CacheMissCounter l1(0, 0);
+	CacheMissCounter llc(0, 0);
+#endif
+
+	std::size_t const dy = static_cast<std::size_t>(n);
+	std::size_t const dx = dy * dy;
+	float const*      g  = grid.data();
+
+	Result r;
+	l1.start();
+	llc.start();
+	auto const t0 = std::chrono::steady_clock::now();
+	for (std::size_t o : offsets) {
+		if constexpr (Stencil) {
+			r.sum += g[o] + g[o - dx] + g[o + dx] + g[o - dy] + g[o + dy] + g[o - 1] +
+			         g[o + 1];
+		} else {
+			r.sum += g[o];
+		}
+	}
+	auto const t1 = std::chrono::steady_clock::now();
+	r.llc_misses  = llc.stop();
+	r.l1_misses   = l1.stop();
+	r.ms          = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	return r;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+	int const levels      = 1 < argc ? std::atoi(argv[1]) : 8;
+	int const repetitions = 2 < argc ? std::atoi(argv[2]) : 5;
+	int const n           = 1 << levels;
+
+	std::vector<float> grid(static_cast<std::size_t>(n) * n * n);
+	for (std::size_t i{}; grid.size() != i; ++i) {
+		grid[i] = static_cast<float>(i % 7);
+	}
+
+	std::printf("%d^3 grid (%zu MiB), best of %d\n", n,
+	            grid.size() * sizeof(float) / (1024 * 1024), repetitions);
+
+	auto const header = [] {
+		std::printf("%-10s %10s %14s %14s\n", "order", "ms", "L1D misses", "LLC misses");
+	};
+
+	auto const report = [repetitions](char const* name, auto f) {
+		Result best = f();
+		for (int i = 1; repetitions > i; ++i) {
+			Result r = f();
+			if (r.ms < best.ms) {
+				best = r;
+			}
+		}
+
+		if (0 > best.l1_misses && 0 > best.llc_misses) {
+			std::printf("%-10s %10.2f %14s %14s\n", name, best.ms, "n/a", "n/a");
+		} else {
+			std::printf("%-10s %10.2f %14lld %14lld\n", name, best.ms, best.l1_misses,
+			            best.llc_misses);
+		}
+	};
+
+	std::printf("\nSweep, row-major storage\n");
+	header();
+	std::pair<char const*, ufo::TraversalOrder> const orders[] = {
+	    {"row-major", ufo::TraversalOrder::ROW_MAJOR},
+	    {"tiled", ufo::TraversalOrder::TILED},
+	    {"morton", ufo::TraversalOrder::MORTON},
+	    {"hilbert", ufo::TraversalOrder::HILBERT}};
+	for (auto [name, order] : orders) {
+		auto const offsets = visitOrder(n, order);
+		report(name, [&] { return measure<true>(grid, n, offsets); });
+	}
+
+	int const num_boxes = 1 << 14;
+	int const box_size  = 6;
+	std::printf("\nBox queries, %d boxes of %d^3 cells\n", num_boxes, box_size);
+	header();
+
+	auto const row_major = boxOffsets(n, num_boxes, box_size, [n](int x, int y, int z) {
+		return (static_cast<std::size_t>(x) * n + y) * n + z;
+	});
+	report("row-major", [&] { return measure<false>(grid, n, row_major); });
+
+	auto const morton = boxOffsets(n, num_boxes, box_size, [](int x, int y, int z) {
+		return ufo::mortonEncode(static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y),
+		                         static_cast<std::uint32_t>(z));
+	});
+	report("morton", [&] { return measure<false>(grid, n, morton); });
+
+	auto const hilbert = boxOffsets(n, num_boxes, box_size, [](int x, int y, int z) {
+		return ufo::hilbertEncode(static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y),
+		                          static_cast<std::uint32_t>(z));
+	});
+	report("hilbert", [&] { return measure<false>(grid, n, hilbert); });
+}
@@ -0,0 +1,223 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_ADAPTIVE_LOCK_HPP
+#define UFO_UTILITY_ADAPTIVE_LOCK_HPP
+
+// UFO
+#include <ufo/utility/backoff.hpp>
+#include <ufo/utility/futex.hpp>
+
+// STL
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ufo
+{
+struct LockStats {
+	// Total number of times the lock has been acquired
+	std::uint64_t acquisitions{};
+	// Number of acquisitions where the lock was already held
+	std::uint64_t contended{};
+	// Accumulated time spent waiting in contended acquisitions
+	std::chrono::nanoseconds wait_time{};
+};
+
+namespace detail
+{
+template <bool Enable>
+class LockStatsStorage
+{
+ protected:
+	void recordAcquisition() noexcept {}
+
+	void recordContended(std::chrono::steady_clock::time_point) noexcept {}
+
+	[[nodiscard]] static std::chrono::steady_clock::time_point start() noexcept
+	{
+		return {};
+	}
+
+ public:
+	[[nodiscard]] LockStats stats() const noexcept { return {}; }
+
+	void resetStats() noexcept {}
+};
+
+template <>
+class LockStatsStorage<true>
+{
+ protected:
+	// Only called by the thread holding the lock, so a relaxed load followed by a store
+	// suffices and we avoid read-modify-write operations on the hot path.
+
+	void recordAcquisition() noexcept
+	{
+		acquisitions_.store(acquisitions_.load(std::memory_order_relaxed) + 1,
+		                    std::memory_order_relaxed);
+	}
+
+	void recordContended(std::chrono::steady_clock::time_point start) noexcept
+	{
+		auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		                    std::chrono::steady_clock::now() - start)
+		                    .count();
+		contended_.store(contended_.load(std::memory_order_relaxed) + 1,
+		                 std::memory_order_relaxed);
+		wait_ns_.store(wait_ns_.load(std::memory_order_relaxed) + ns,
+		               std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] static std::chrono::steady_clock::time_point start() noexcept
+	{
+		return std::chrono::steady_clock::now();
+	}
+
+ public:
+	[[nodiscard]] LockStats stats() const noexcept
+	{
+		return {acquisitions_.load(std::memory_order_relaxed),
+		        contended_.load(std::memory_order_relaxed),
+		        std::chrono::nanoseconds(wait_ns_.load(std::memory_order_relaxed))};
+	}
+
+	void resetStats() noexcept
+	{
+		acquisitions_.store(0, std::memory_order_relaxed);
+		contended_.store(0, std::memory_order_relaxed);
+		wait_ns_.store(0, std::memory_order_relaxed);
+	}
+
+ private:
+	std::atomic<std::uint64_t> acquisitions_{};
+	std::atomic<std::uint64_t> contended_{};
+	std::atomic<std::int64_t>  wait_ns_{};
+};
+}  // namespace detail
+
+/*!
+ * @brief Spin-then-park lock.
+ *
+ * An uncontended `lock` is a single compare-and-swap. Under contention the lock first
+ * spins with exponential backoff (see `Backoff`), only reading the lock word so the
+ * cache line is not bounced between cores, and if the lock still has not become free
+ * the thread is parked on a futex until the holder releases it.
+ *
+ * Satisfies the Lockable requirements, so it can be used with `std::lock_guard`,
+ * `std::unique_lock`, and `std::scoped_lock` in the same way as `Spinlock`.
+ *
+ * @tparam CollectStats Whether to record the number of acquisitions, contended
+ * acquisitions and time spent waiting. Adds no overhead when false.
+ */
+template <bool CollectStats = false>
+class AdaptiveLock : public detail::LockStatsStorage<CollectStats>
+{
+	using Base = detail::LockStatsStorage<CollectStats>;
+
+	static constexpr std::uint32_t UNLOCKED       = 0;
+	static constexpr std::uint32_t LOCKED         = 1;
+	static constexpr std::uint32_t LOCKED_WAITING = 2;
+
+ public:
+	AdaptiveLock() = default;
+
+	AdaptiveLock(AdaptiveLock const&)            = delete;
+	AdaptiveLock& operator=(AdaptiveLock const&) = delete;
+
+	void lock() noexcept
+	{
+		std::uint32_t expected = UNLOCKED;
+		if (!state_.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire,
+		                                    std::memory_order_relaxed)) {
+			lockContended();
+		}
+		Base::recordAcquisition();
+	}
+
+	bool try_lock() noexcept
+	{
+		std::uint32_t expected = UNLOCKED;
+		if (state_.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire,
+		                                   std::memory_order_relaxed)) {
+			Base::recordAcquisition();
+			return true;
+		}
+		return false;
+	}
+
+	void unlock() noexcept
+	{
+		if (LOCKED_WAITING == state_.exchange(UNLOCKED, std::memory_order_release)) {
+			futexWakeOne(state_);
+		}
+	}
+
+ private:
+	void lockContended() noexcept
+	{
+		auto const start = Base::start();
+
+		for (Backoff backoff; !backoff.completed(); backoff.snooze()) {
+			std::uint32_t expected = UNLOCKED;
+			if (UNLOCKED == state_.load(std::memory_order_relaxed) &&
+			    state_.compare_exchange_weak(expected, LOCKED, std::memory_order_acquire,
+			                                 std::memory_order_relaxed)) {
+				Base::recordContended(start);
+				return;
+			}
+		}
+
+		// We do not know whether there are other threads parked, so the lock is acquired
+		// in the waiting state to make sure the next `unlock` wakes one of them up.
+		while (UNLOCKED != state_.exchange(LOCKED_WAITING, std::memory_order_acquire)) {
+			futexWait(state_, LOCKED_WAITING);
+		}
+
+		Base::recordContended(start);
+	}
+
+ private:
+	std::atomic<std::uint32_t> state_{UNLOCKED};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_ADAPTIVE_LOCK_HPP
\ No newline at end of file
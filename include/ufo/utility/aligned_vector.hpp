@@ -0,0 +1,120 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_ALIGNED_VECTOR_HPP
+#define UFO_UTILITY_ALIGNED_VECTOR_HPP
+
+// UFO
+#include <ufo/utility/cache_line.hpp>
+
+// STL
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace ufo
+{
+/*!
+ * @brief Allocator returning memory aligned to `Alignment` bytes.
+ *
+ * Used to start arrays on a cache line (no false sharing with whatever precedes them,
+ * no element straddling two lines more than necessary) or on a SIMD register boundary
+ * for aligned loads.
+ */
+template <class T, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedAllocator
+{
+	static_assert(0 == (Alignment & (Alignment - 1)), "Alignment has to be a power of two");
+
+ public:
+	using value_type = T;
+
+	static constexpr std::size_t ALIGNMENT =
+	    Alignment < alignof(T) ? alignof(T) : Alignment;
+
+	using is_always_equal = std::true_type;
+
+	template <class U>
+	struct rebind {
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	AlignedAllocator() noexcept = default;
+
+	template <class U>
+	AlignedAllocator(AlignedAllocator<U, Alignment> const&) noexcept
+	{
+	}
+
+	[[nodiscard]] T* allocate(std::size_t n)
+	{
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(ALIGNMENT)));
+	}
+
+	void deallocate(T* p, std::size_t) noexcept
+	{
+		::operator delete(p, std::align_val_t(ALIGNMENT));
+	}
+
+	template <class U>
+	[[nodiscard]] constexpr bool operator==(
+	    AlignedAllocator<U, Alignment> const&) const noexcept
+	{
+		return true;
+	}
+
+	template <class U>
+	[[nodiscard]] constexpr bool operator!=(
+	    AlignedAllocator<U, Alignment> const&) const noexcept
+	{
+		return false;
+	}
+};
+
+/*!
+ * @brief `std::vector` whose data starts at an `Alignment` byte boundary.
+ */
+template <class T, std::size_t Alignment = CACHE_LINE_SIZE>
+using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_ALIGNED_VECTOR_HPP
@@ -0,0 +1,118 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BACKOFF_HPP
+#define UFO_UTILITY_BACKOFF_HPP
+
+// STL
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Hint to the processor that the calling thread is in a spin-wait loop.
+ *
+ * Lowers power usage and frees up execution resources for the sibling hyper-thread
+ * while spinning, without giving up the time slice.
+ */
+inline void cpuRelax() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	asm volatile("yield" ::: "memory");
+#else
+	std::this_thread::yield();
+#endif
+}
+
+/*!
+ * @brief Exponential backoff for spin-wait loops.
+ *
+ * Each call to `spin`/`snooze` doubles the number of `cpuRelax` issued, up to
+ * `2^SPIN_LIMIT`. After that `snooze` yields the time slice instead, and once
+ * `YIELD_LIMIT` steps have been taken `completed` returns true, signaling that the
+ * caller should block (e.g., park on a futex) rather than keep spinning.
+ */
+class Backoff
+{
+ public:
+	static constexpr unsigned SPIN_LIMIT  = 6;
+	static constexpr unsigned YIELD_LIMIT = 10;
+
+	void spin() noexcept
+	{
+		for (unsigned i = 1u << (SPIN_LIMIT < step_ ? SPIN_LIMIT : step_); 0 != i; --i) {
+			cpuRelax();
+		}
+		if (SPIN_LIMIT >= step_) {
+			++step_;
+		}
+	}
+
+	void snooze() noexcept
+	{
+		if (SPIN_LIMIT >= step_) {
+			for (unsigned i = 1u << step_; 0 != i; --i) {
+				cpuRelax();
+			}
+		} else {
+			std::this_thread::yield();
+		}
+		if (YIELD_LIMIT >= step_) {
+			++step_;
+		}
+	}
+
+	[[nodiscard]] bool completed() const noexcept { return YIELD_LIMIT < step_; }
+
+	void reset() noexcept { step_ = 0; }
+
+ private:
+	unsigned step_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BACKOFF_HPP
\ No newline at end of file
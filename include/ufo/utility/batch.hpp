@@ -0,0 +1,167 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BATCH_HPP
+#define UFO_UTILITY_BATCH_HPP
+
+// UFO
+#include <ufo/utility/index_iterator.hpp>
+#include <ufo/utility/span.hpp>
+#include <ufo/utility/tuple_iterator.hpp>
+
+// STL
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ufo
+{
+namespace detail
+{
+template <class... Ts, std::size_t... Is>
+[[nodiscard]] auto columnSpans(TupleIterator<Ts...>& zip, std::size_t first,
+                               std::size_t count, std::index_sequence<Is...>)
+{
+	return std::make_tuple(
+	    Span<std::remove_pointer_t<decltype(std::data(std::declval<Ts&>()))>>(
+	        std::data(zip.template column<Is>()) + first, count)...);
+}
+}  // namespace detail
+
+/*!
+ * @brief `W` indices `first, first + inc, ..., first + (W - 1) * inc`, handed out by
+ * `forEachBatch` for an `IndexIterator`.
+ *
+ * When `inc` is one the lanes are contiguous, so a kernel can load `W` consecutive
+ * elements starting at `first`.
+ */
+template <class T, std::size_t W>
+struct IndexBatch {
+	T first;
+	T inc;
+
+	[[nodiscard]] static constexpr std::size_t size() noexcept { return W; }
+
+	[[nodiscard]] constexpr T operator[](std::size_t lane) const noexcept
+	{
+		return first + static_cast<T>(lane) * inc;
+	}
+
+	[[nodiscard]] constexpr std::array<T, W> lanes() const noexcept
+	{
+		std::array<T, W> l{};
+		for (std::size_t i{}; W != i; ++i) {
+			l[i] = operator[](i);
+		}
+		return l;
+	}
+};
+
+/*!
+ * @brief Splits `range` into batches of `W` indices, calling `f(batch)` with an
+ * `IndexBatch<T, W>` for each full batch and `tail(i)` for each of the remaining (fewer
+ * than `W`) indices.
+ *
+ * Lets kernels be written against SIMD-width chunks, e.g., `W = 8` for 8 floats with
+ * AVX, with a scalar remainder loop.
+ */
+template <std::size_t W, class T, class BatchFunction, class TailFunction>
+void forEachBatch(IndexIterator<T> const& range, BatchFunction f, TailFunction tail)
+{
+	static_assert(0 < W, "The batch width has to be positive");
+
+	T           i    = range.first;
+	T const     step = static_cast<T>(W) * range.inc;
+	std::size_t n    = range.size();
+	for (; W <= n; n -= W, i += step) {
+		f(IndexBatch<T, W>{i, range.inc});
+	}
+	for (; 0 != n; --n, i += range.inc) {
+		tail(i);
+	}
+}
+
+/*!
+ * @brief Splits the zipped containers into batches of `W` elements, calling `f` with
+ * one `Span` per container for each full batch and `tail` with the (fewer than `W`)
+ * remaining elements.
+ *
+ * The spans point directly into the containers, which therefore have to be
+ * contiguous. This avoids building a tuple of references per element, so the kernel
+ * sees plain arrays it can vectorize over.
+ *
+ * @param f Callable taking one `Span` per container, each of size `W`.
+ * @param tail Callable taking one `Span` per container, each of size less than `W`.
+ * Only called if there are remaining elements.
+ */
+template <std::size_t W, class... Ts, class BatchFunction, class TailFunction>
+void forEachBatch(TupleIterator<Ts...>& zip, BatchFunction f, TailFunction tail)
+{
+	static_assert(0 < W, "The batch width has to be positive");
+
+	auto const columns = [&zip](std::size_t first, std::size_t count) {
+		return detail::columnSpans(zip, first, count, std::index_sequence_for<Ts...>{});
+	};
+
+	std::size_t const size = zip.size();
+	std::size_t       i{};
+	for (; W <= size - i; i += W) {
+		std::apply(f, columns(i, W));
+	}
+	if (i != size) {
+		std::apply(tail, columns(i, size - i));
+	}
+}
+
+/*!
+ * @brief Same as above, but `f` also handles the remaining elements.
+ */
+template <std::size_t W, class... Ts, class BatchFunction>
+void forEachBatch(TupleIterator<Ts...>& zip, BatchFunction f)
+{
+	forEachBatch<W>(zip, f, f);
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BATCH_HPP
@@ -0,0 +1,165 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BIT_HPP
+#define UFO_UTILITY_BIT_HPP
+
+// STL
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace ufo
+{
+/*!
+ * @brief Number of consecutive zero bits starting from the least significant bit.
+ *
+ * Same as `std::countr_zero`, which requires C++20.
+ */
+template <class T>
+[[nodiscard]] constexpr int countrZero(T x) noexcept
+{
+	static_assert(std::is_unsigned_v<T>, "countrZero requires an unsigned type");
+#if __cplusplus >= 202002L
+	return std::countr_zero(x);
+#elif defined(__GNUC__) || defined(__clang__)
+	if (0 == x) {
+		return std::numeric_limits<T>::digits;
+	}
+	if constexpr (sizeof(T) <= sizeof(unsigned)) {
+		return __builtin_ctz(x);
+	} else {
+		return __builtin_ctzll(x);
+	}
+#else
+	if (0 == x) {
+		return std::numeric_limits<T>::digits;
+	}
+	int n{};
+	for (; !(x & T(1)); x >>= 1) {
+		++n;
+	}
+	return n;
+#endif
+}
+
+/*!
+ * @brief Number of consecutive zero bits starting from the most significant bit.
+ *
+ * Same as `std::countl_zero`, which requires C++20.
+ */
+template <class T>
+[[nodiscard]] constexpr int countlZero(T x) noexcept
+{
+	static_assert(std::is_unsigned_v<T>, "countlZero requires an unsigned type");
+#if __cplusplus >= 202002L
+	return std::countl_zero(x);
+#elif defined(__GNUC__) || defined(__clang__)
+	if (0 == x) {
+		return std::numeric_limits<T>::digits;
+	}
+	if constexpr (sizeof(T) <= sizeof(unsigned)) {
+		return __builtin_clz(x) -
+		       (std::numeric_limits<unsigned>::digits - std::numeric_limits<T>::digits);
+	} else {
+		return __builtin_clzll(x);
+	}
+#else
+	int n = std::numeric_limits<T>::digits;
+	for (; 0 != x; x >>= 1) {
+		--n;
+	}
+	return n;
+#endif
+}
+
+/*!
+ * @brief Number of set bits.
+ *
+ * Same as `std::popcount`, which requires C++20.
+ */
+template <class T>
+[[nodiscard]] constexpr int popcount(T x) noexcept
+{
+	static_assert(std::is_unsigned_v<T>, "popcount requires an unsigned type");
+#if __cplusplus >= 202002L
+	return std::popcount(x);
+#elif defined(__GNUC__) || defined(__clang__)
+	if constexpr (sizeof(T) <= sizeof(unsigned)) {
+		return __builtin_popcount(x);
+	} else {
+		return __builtin_popcountll(x);
+	}
+#else
+	int n{};
+	for (; 0 != x; x &= x - 1) {
+		++n;
+	}
+	return n;
+#endif
+}
+
+/*!
+ * @brief Smallest power of two not smaller than `x`.
+ */
+template <class T>
+[[nodiscard]] constexpr T bitCeil(T x) noexcept
+{
+	static_assert(std::is_unsigned_v<T>, "bitCeil requires an unsigned type");
+	return 1 >= x ? T(1)
+	              : T(T(1) << (std::numeric_limits<T>::digits - countlZero(T(x - 1))));
+}
+
+/*!
+ * @brief Number of bits needed to represent `x`.
+ */
+template <class T>
+[[nodiscard]] constexpr int bitWidth(T x) noexcept
+{
+	static_assert(std::is_unsigned_v<T>, "bitWidth requires an unsigned type");
+	return std::numeric_limits<T>::digits - countlZero(x);
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BIT_HPP
@@ -0,0 +1,535 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BIT_PACKED_ARRAY_HPP
+#define UFO_UTILITY_BIT_PACKED_ARRAY_HPP
+
+// UFO
+#include <ufo/utility/io/read_buffer.hpp>
+#include <ufo/utility/io/write_buffer.hpp>
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+namespace detail
+{
+// Number of zeroed words kept after the packed values, so that reading a value (or a
+// group of values in the vectorized unpack) never has to check whether it straddles
+// the end of the storage
+inline constexpr std::size_t BIT_PACKED_PADDING = 2;
+
+// Widest value the vectorized unpack handles, each value together with its offset into
+// the first byte has to fit in a 32-bit lane
+inline constexpr unsigned BIT_PACKED_SIMD_MAX_BITS = 25;
+
+[[nodiscard]] constexpr std::uint32_t bitPackedMask(unsigned bits) noexcept
+{
+	return 32 == bits ? ~std::uint32_t(0) : (std::uint32_t(1) << bits) - 1;
+}
+
+[[nodiscard]] constexpr std::size_t bitPackedWords(std::size_t size,
+                                                   unsigned    bits) noexcept
+{
+	return (size * bits + 63) / 64;
+}
+
+[[nodiscard]] inline std::uint32_t bitPackedGet(std::uint64_t const* words,
+                                                std::size_t pos, unsigned bits) noexcept
+{
+	std::size_t const bit = pos * bits;
+	std::size_t const w   = bit / 64;
+	unsigned const    off = bit % 64;
+	// Two shifts for the high part, `<< (64 - off)` is undefined for `off == 0`
+	std::uint64_t const lo = words[w] >> off;
+	std::uint64_t const hi = (words[w + 1] << 1) << (63 - off);
+	return static_cast<std::uint32_t>(lo | hi) & bitPackedMask(bits);
+}
+
+inline void bitPackedSet(std::uint64_t* words, std::size_t pos, unsigned bits,
+                         std::uint32_t value) noexcept
+{
+	std::size_t const   bit  = pos * bits;
+	std::size_t const   w    = bit / 64;
+	unsigned const      off  = bit % 64;
+	std::uint64_t const mask = bitPackedMask(bits);
+	std::uint64_t const v    = value & mask;
+	// The high part is empty if the value does not straddle two words, in which case
+	// the second store writes back the word unchanged
+	words[w] = (words[w] & ~(mask << off)) | (v << off);
+	words[w + 1] =
+	    (words[w + 1] & ~((mask >> 1) >> (63 - off))) | ((v >> 1) >> (63 - off));
+}
+
+inline void bitPack(std::uint64_t* words, unsigned bits, std::size_t first,
+                    std::uint32_t const* in, std::size_t count) noexcept
+{
+	if (0 == count) {
+		return;
+	}
+
+	std::uint64_t const mask = bitPackedMask(bits);
+	std::size_t const   bit  = first * bits;
+	std::size_t         w    = bit / 64;
+	unsigned            used = bit % 64;
+	// Keep the values before `first` that share the first word
+	std::uint64_t acc = words[w] & ((std::uint64_t(1) << used) - 1);
+
+	for (std::size_t i{}; count != i; ++i) {
+		std::uint64_t const v = in[i] & mask;
+		acc |= v << used;
+		used += bits;
+		if (64 <= used) {
+			words[w++] = acc;
+			used -= 64;
+			// The bits of `v` that did not fit in the previous word
+			acc = v >> (bits - used);
+		}
+	}
+
+	// Keep the values after the last one written that share the last word
+	std::uint64_t const keep = ~((std::uint64_t(1) << used) - 1);
+	words[w]                 = (words[w] & keep) | acc;
+}
+
+struct BitUnpackTable {
+	std::array<std::uint8_t, 32> shuffle{};
+	std::array<std::uint32_t, 8> shift{};
+	unsigned                     high_byte{};
+};
+
+/*!
+ * Shuffle and shift controls for unpacking 8 values at a time. A group of 8 values
+ * always starts at a byte boundary, the low 4 values are extracted from the 16 bytes
+ * at the start of the group and the high 4 values from the 16 bytes starting at
+ * `high_byte`. Each value is gathered into its own 32-bit lane together with the bits
+ * preceding it in its first byte, which are then shifted out.
+ */
+[[nodiscard]] constexpr BitUnpackTable bitUnpackTable(unsigned bits) noexcept
+{
+	BitUnpackTable t{};
+	t.high_byte = 4 * bits / 8;
+	for (unsigned lane{}; 2 != lane; ++lane) {
+		unsigned const start = lane ? 4 * bits % 8 : 0;
+		for (unsigned i{}; 4 != i; ++i) {
+			unsigned const p = start + i * bits;
+			for (unsigned b{}; 4 != b; ++b) {
+				t.shuffle[16 * lane + 4 * i + b] = static_cast<std::uint8_t>(p / 8 + b);
+			}
+			t.shift[4 * lane + i] = p % 8;
+		}
+	}
+	return t;
+}
+
+inline void bitUnpack(std::uint64_t const* words, unsigned bits,
+                      [[maybe_unused]] BitUnpackTable const& table, std::size_t first,
+                      std::uint32_t* out, std::size_t count) noexcept
+{
+	std::size_t i{};
+
+#if defined(__AVX2__)
+	if (BIT_PACKED_SIMD_MAX_BITS >= bits) {
+		// Scalar until the first value of a group of 8, which starts at a byte boundary
+		for (; count != i && 0 != (first + i) % 8; ++i) {
+			out[i] = bitPackedGet(words, first + i, bits);
+		}
+
+		auto const*   bytes   = reinterpret_cast<unsigned char const*>(words);
+		__m256i const shuffle = _mm256_loadu_si256(
+		    reinterpret_cast<__m256i const*>(table.shuffle.data()));
+		__m256i const shift =
+		    _mm256_loadu_si256(reinterpret_cast<__m256i const*>(table.shift.data()));
+		__m256i const mask = _mm256_set1_epi32(static_cast<int>(bitPackedMask(bits)));
+
+		// The loads reach at most 16 bytes past the end of the group, which is covered
+		// by the padding words
+		for (; count - i >= 8; i += 8) {
+			unsigned char const* p  = bytes + (first + i) / 8 * bits;
+			__m128i const        lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+			__m128i const        hi =
+			    _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + table.high_byte));
+			__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+			v         = _mm256_shuffle_epi8(v, shuffle);
+			v         = _mm256_and_si256(_mm256_srlv_epi32(v, shift), mask);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+		}
+	}
+#endif
+
+	for (; count != i; ++i) {
+		out[i] = bitPackedGet(words, first + i, bits);
+	}
+}
+
+template <unsigned Bits>
+class BitPackedWidth
+{
+ public:
+	[[nodiscard]] static constexpr unsigned bits() noexcept { return Bits; }
+
+ protected:
+	static constexpr BitUnpackTable UNPACK_TABLE = bitUnpackTable(Bits);
+
+	[[nodiscard]] static constexpr BitUnpackTable unpackTable() noexcept
+	{
+		return UNPACK_TABLE;
+	}
+
+	static void checkBits(unsigned bits)
+	{
+		if (Bits != bits) {
+			throw std::invalid_argument("BitPackedArray: stored width " +
+			                            std::to_string(bits) + " does not match " +
+			                            std::to_string(Bits));
+		}
+	}
+
+	static void setBits(unsigned bits) { checkBits(bits); }
+};
+
+template <>
+class BitPackedWidth<0>
+{
+ public:
+	[[nodiscard]] constexpr unsigned bits() const noexcept { return bits_; }
+
+ protected:
+	[[nodiscard]] constexpr BitUnpackTable unpackTable() const noexcept
+	{
+		return bitUnpackTable(bits_);
+	}
+
+	static void checkBits(unsigned bits)
+	{
+		if (0 == bits || 32 < bits) {
+			throw std::invalid_argument("BitPackedArray: width " + std::to_string(bits) +
+			                            " is not in [1, 32]");
+		}
+	}
+
+	void setBits(unsigned bits)
+	{
+		checkBits(bits);
+		bits_ = bits;
+	}
+
+ private:
+	unsigned bits_ = 32;
+};
+}  // namespace detail
+
+/*!
+ * @brief Array of unsigned integers stored with `Bits` bits each.
+ *
+ * Values are packed back to back, least significant bit first, into 64-bit words, so a
+ * value may straddle two words. Random access `get`/`set` are branchless, `pack` and
+ * `unpack` convert whole ranges at a time (vectorized with AVX2 for widths up to 25
+ * bits), and `write`/`read` copy the packed words straight to/from a buffer.
+ *
+ * With `Bits == 0` the width is instead chosen at runtime, see the constructor. A
+ * default constructed runtime width array uses 32 bits until `read` sets the width.
+ *
+ * @tparam Bits The number of bits per value, in [1, 32], or 0 for a runtime width.
+ */
+template <unsigned Bits = 0>
+class BitPackedArray : public detail::BitPackedWidth<Bits>
+{
+	static_assert(32 >= Bits, "BitPackedArray supports at most 32 bits per value");
+
+	using Base = detail::BitPackedWidth<Bits>;
+
+ public:
+	using value_type = std::uint32_t;
+	using size_type  = std::size_t;
+
+	class Reference
+	{
+		friend class BitPackedArray;
+
+	 public:
+		Reference& operator=(value_type value) noexcept
+		{
+			array_.set(pos_, value);
+			return *this;
+		}
+
+		Reference& operator=(Reference const& other) noexcept
+		{
+			return operator=(static_cast<value_type>(other));
+		}
+
+		operator value_type() const noexcept { return array_.get(pos_); }
+
+	 private:
+		Reference(BitPackedArray& array, size_type pos) noexcept : array_(array), pos_(pos)
+		{
+		}
+
+	 private:
+		BitPackedArray& array_;
+		size_type       pos_;
+	};
+
+	BitPackedArray() : words_(detail::BIT_PACKED_PADDING) {}
+
+	template <unsigned B = Bits, std::enable_if_t<0 != B, bool> = true>
+	explicit BitPackedArray(size_type size, value_type value = 0) : BitPackedArray()
+	{
+		resize(size, value);
+	}
+
+	/*!
+	 * @param bits The number of bits per value, in [1, 32].
+	 * @throws std::invalid_argument If `bits` is not in [1, 32].
+	 */
+	template <unsigned B = Bits, std::enable_if_t<0 == B, bool> = true>
+	explicit BitPackedArray(unsigned bits, size_type size = 0, value_type value = 0)
+	    : BitPackedArray()
+	{
+		Base::setBits(bits);
+		resize(size, value);
+	}
+
+	using Base::bits;
+
+	[[nodiscard]] value_type get(size_type pos) const noexcept
+	{
+		assert(size_ > pos);
+		return detail::bitPackedGet(words_.data(), pos, bits());
+	}
+
+	/*!
+	 * @brief Sets the value at `pos`, only the low `bits()` bits of `value` are stored.
+	 */
+	void set(size_type pos, value_type value) noexcept
+	{
+		assert(size_ > pos);
+		detail::bitPackedSet(words_.data(), pos, bits(), value);
+	}
+
+	[[nodiscard]] value_type at(size_type pos) const
+	{
+		if (size_ <= pos) {
+			throw std::out_of_range("position (which is " + std::to_string(pos) +
+			                        ") >= size (which is " + std::to_string(size_) + ")");
+		}
+		return get(pos);
+	}
+
+	[[nodiscard]] value_type operator[](size_type pos) const noexcept { return get(pos); }
+
+	[[nodiscard]] Reference operator[](size_type pos) noexcept
+	{
+		return Reference(*this, pos);
+	}
+
+	/*!
+	 * @brief Stores `in.size()` values starting at position `first`.
+	 */
+	void pack(size_type first, Span<value_type const> in) noexcept
+	{
+		assert(size_ >= first + in.size());
+		detail::bitPack(words_.data(), bits(), first, in.data(), in.size());
+	}
+
+	/*!
+	 * @brief Loads `out.size()` values starting at position `first`.
+	 */
+	void unpack(size_type first, Span<value_type> out) const noexcept
+	{
+		assert(size_ >= first + out.size());
+		detail::bitUnpack(words_.data(), bits(), Base::unpackTable(), first, out.data(),
+		                  out.size());
+	}
+
+	void fill(value_type value) noexcept
+	{
+		std::array<value_type, 64> buf;
+		buf.fill(value);
+		for (size_type i{}; size_ > i; i += buf.size()) {
+			pack(i, Span<value_type const>(buf.data(), std::min(buf.size(), size_ - i)));
+		}
+	}
+
+	void push_back(value_type value)
+	{
+		resize(size_ + 1);
+		set(size_ - 1, value);
+	}
+
+	void resize(size_type size, value_type value = 0)
+	{
+		size_type const old_size = size_;
+		size_type const num      = detail::bitPackedWords(size, bits());
+
+		if (size < old_size) {
+			// Clear the values that are removed, so the unused bits are always zero
+			std::size_t const bit = size * bits();
+			if (bit % 64) {
+				words_[bit / 64] &= (std::uint64_t(1) << (bit % 64)) - 1;
+			}
+			std::fill(words_.begin() + num, words_.end(), std::uint64_t(0));
+		}
+
+		words_.resize(num + detail::BIT_PACKED_PADDING);
+		size_ = size;
+
+		if (old_size < size && 0 != value) {
+			std::array<value_type, 64> buf;
+			buf.fill(value);
+			for (size_type i = old_size; size > i; i += buf.size()) {
+				pack(i, Span<value_type const>(buf.data(), std::min(buf.size(), size - i)));
+			}
+		}
+	}
+
+	void clear() noexcept
+	{
+		words_.assign(detail::BIT_PACKED_PADDING, 0);
+		size_ = 0;
+	}
+
+	void shrink_to_fit() { words_.shrink_to_fit(); }
+
+	[[nodiscard]] size_type size() const noexcept { return size_; }
+
+	[[nodiscard]] bool empty() const noexcept { return 0 == size_; }
+
+	/*!
+	 * @brief The packed words, `numWords()` long. Bits past the last value are zero.
+	 */
+	[[nodiscard]] std::uint64_t const* data() const noexcept { return words_.data(); }
+
+	[[nodiscard]] size_type numWords() const noexcept
+	{
+		return words_.size() - detail::BIT_PACKED_PADDING;
+	}
+
+	/*!
+	 * @brief Number of bytes used for the values, excluding the object itself.
+	 */
+	[[nodiscard]] size_type memoryUsage() const noexcept
+	{
+		return words_.capacity() * sizeof(std::uint64_t);
+	}
+
+	/*!
+	 * @brief Writes the width, the number of values and the packed words as is.
+	 */
+	void write(WriteBuffer& out) const
+	{
+		out.write(static_cast<std::uint32_t>(bits()));
+		out.write(static_cast<std::uint64_t>(size_));
+		out.write(words_.data(), numWords() * sizeof(std::uint64_t));
+	}
+
+	/*!
+	 * @brief Reads an array written by `write`.
+	 *
+	 * The array is left unchanged if an exception is thrown.
+	 *
+	 * @throws std::invalid_argument If the stored width does not match `Bits`.
+	 * @throws std::out_of_range If `in` does not hold the whole array.
+	 */
+	void read(ReadBuffer& in)
+	{
+		std::uint32_t bits;
+		std::uint64_t size;
+		in.read(bits);
+		in.read(size);
+		Base::checkBits(bits);
+
+		// The size is untrusted, reject it before `size * bits` can wrap around
+		if ((std::numeric_limits<size_type>::max() - 63) / bits < size ||
+		    in.readLeft() / sizeof(std::uint64_t) <
+		        detail::bitPackedWords(size, bits)) {
+			throw std::out_of_range("BitPackedArray: buffer too small for " +
+			                        std::to_string(size) + " values");
+		}
+
+		size_type const            num = detail::bitPackedWords(size, bits);
+		std::vector<std::uint64_t> words(num + detail::BIT_PACKED_PADDING);
+		in.read(words.data(), num * sizeof(std::uint64_t));
+
+		// Do not trust the unused bits of the last word
+		if (std::size_t const bit = size * bits; bit % 64) {
+			words[bit / 64] &= (std::uint64_t(1) << (bit % 64)) - 1;
+		}
+
+		Base::setBits(bits);
+		words_.swap(words);
+		size_ = size;
+	}
+
+	friend bool operator==(BitPackedArray const& lhs, BitPackedArray const& rhs) noexcept
+	{
+		return lhs.bits() == rhs.bits() && lhs.size_ == rhs.size_ &&
+		       lhs.words_ == rhs.words_;
+	}
+
+	friend bool operator!=(BitPackedArray const& lhs, BitPackedArray const& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+ private:
+	std::vector<std::uint64_t> words_;
+	size_type                  size_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BIT_PACKED_ARRAY_HPP
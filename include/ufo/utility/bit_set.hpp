@@ -42,24 +42,43 @@
 #ifndef UFO_UTILITY_BIT_SET_HPP
 #define UFO_UTILITY_BIT_SET_HPP
 
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/hash.hpp>
+
 // STL
 #if __cplusplus >= 202002L
 #include <bit>
 #else
 #include <bitset>
 #endif
+#include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
 namespace ufo
 {
+/*!
+ * @brief Fixed-size set of `N` bits.
+ *
+ * Up to 64 bits the set is stored in the smallest unsigned integer that fits, above
+ * that in an array of 64 bit words (see `BitSet<N, false>`).
+ */
+template <std::size_t N, bool = (64 >= N)>
+class BitSet;
 
 template <std::size_t N>
-class BitSet
+class BitSet<N, true>
 {
-	static_assert(0 < N && 64 >= N, "BitSet is defined for [1..64] bits");
+	static_assert(0 < N, "BitSet requires at least one bit");
 
  public:
 	using T = std::conditional_t<
@@ -74,7 +93,7 @@ class BitSet
 
  public:
 	struct Reference {
-		friend class BitSet<N>;
+		friend class BitSet;
 
 	 public:
 		constexpr Reference& operator=(bool x) noexcept
@@ -148,8 +167,8 @@ class BitSet
 	[[nodiscard]] bool test(std::size_t pos) const
 	{
 		if (size() <= pos) {
-			std::out_of_range("position (which is " + std::to_string(pos) +
-			                  ") >= size (which is " + std::to_string(size()) + ")");
+			throw std::out_of_range("position (which is " + std::to_string(pos) +
+			                        ") >= size (which is " + std::to_string(size()) + ")");
 		}
 		return operator[](pos);
 	}
@@ -196,6 +215,28 @@ class BitSet
 
 	constexpr BitSet operator~() const noexcept { return BitSet(static_cast<T>(~set_)); }
 
+	constexpr BitSet& operator<<=(std::size_t pos) noexcept
+	{
+		set_ = N > pos ? static_cast<T>((set_ << pos) & ALL_SET) : T(0);
+		return *this;
+	}
+
+	constexpr BitSet& operator>>=(std::size_t pos) noexcept
+	{
+		set_ = N > pos ? static_cast<T>(set_ >> pos) : T(0);
+		return *this;
+	}
+
+	constexpr BitSet operator<<(std::size_t pos) const noexcept
+	{
+		return BitSet(*this) <<= pos;
+	}
+
+	constexpr BitSet operator>>(std::size_t pos) const noexcept
+	{
+		return BitSet(*this) >>= pos;
+	}
+
 	constexpr void set() noexcept { set_ = ALL_SET; }
 
 	constexpr void set(std::size_t pos, bool value)
@@ -232,34 +273,515 @@ class BitSet
 	T set_{};
 };
 
+namespace detail
+{
+// Word-parallel kernels of the multi-word `BitSet`, processing 8 (AVX-512) or 4 (AVX2)
+// words at a time and the remaining words one by one
+
+struct BitAnd {
+#if defined(__AVX512F__)
+	static __m512i apply(__m512i a, __m512i b) noexcept { return _mm512_and_si512(a, b); }
+#endif
+#if defined(__AVX2__)
+	static __m256i apply(__m256i a, __m256i b) noexcept { return _mm256_and_si256(a, b); }
+#endif
+	static constexpr std::uint64_t apply(std::uint64_t a, std::uint64_t b) noexcept
+	{
+		return a & b;
+	}
+};
+
+struct BitOr {
+#if defined(__AVX512F__)
+	static __m512i apply(__m512i a, __m512i b) noexcept { return _mm512_or_si512(a, b); }
+#endif
+#if defined(__AVX2__)
+	static __m256i apply(__m256i a, __m256i b) noexcept { return _mm256_or_si256(a, b); }
+#endif
+	static constexpr std::uint64_t apply(std::uint64_t a, std::uint64_t b) noexcept
+	{
+		return a | b;
+	}
+};
+
+struct BitXor {
+#if defined(__AVX512F__)
+	static __m512i apply(__m512i a, __m512i b) noexcept { return _mm512_xor_si512(a, b); }
+#endif
+#if defined(__AVX2__)
+	static __m256i apply(__m256i a, __m256i b) noexcept { return _mm256_xor_si256(a, b); }
+#endif
+	static constexpr std::uint64_t apply(std::uint64_t a, std::uint64_t b) noexcept
+	{
+		return a ^ b;
+	}
+};
+
+// `a & ~b`
+struct BitAndNot {
+#if defined(__AVX512F__)
+	static __m512i apply(__m512i a, __m512i b) noexcept
+	{
+		// The zero-masking form, since GCC warns about the undefined source of the other
+		return _mm512_maskz_andnot_epi64(0xFF, b, a);
+	}
+#endif
+#if defined(__AVX2__)
+	static __m256i apply(__m256i a, __m256i b) noexcept
+	{
+		return _mm256_andnot_si256(b, a);
+	}
+#endif
+	static constexpr std::uint64_t apply(std::uint64_t a, std::uint64_t b) noexcept
+	{
+		return a & ~b;
+	}
+};
+
+template <class Op, std::size_t W>
+void bitApply(std::array<std::uint64_t, W>&       a,
+              std::array<std::uint64_t, W> const& b) noexcept
+{
+	std::size_t i{};
+#if defined(__AVX512F__)
+	for (; i + 8 <= W; i += 8) {
+		__m512i const x = _mm512_loadu_si512(a.data() + i);
+		__m512i const y = _mm512_loadu_si512(b.data() + i);
+		_mm512_storeu_si512(a.data() + i, Op::apply(x, y));
+	}
+#endif
+#if defined(__AVX2__)
+	for (; i + 4 <= W; i += 4) {
+		__m256i const x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a.data() + i));
+		__m256i const y = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b.data() + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(a.data() + i), Op::apply(x, y));
+	}
+#endif
+	for (; W != i; ++i) {
+		a[i] = Op::apply(a[i], b[i]);
+	}
+}
+
+// Whether `a ^ b` (or `a` if `Xor` is false) has no bits set
+template <bool Xor, std::size_t W>
+[[nodiscard]] bool bitNone(std::array<std::uint64_t, W> const& a,
+                           std::array<std::uint64_t, W> const& b) noexcept
+{
+	std::size_t i{};
+#if defined(__AVX512F__)
+	if constexpr (8 <= W) {
+		__m512i acc = _mm512_setzero_si512();
+		for (; i + 8 <= W; i += 8) {
+			__m512i x = _mm512_loadu_si512(a.data() + i);
+			if constexpr (Xor) {
+				x = _mm512_xor_si512(x, _mm512_loadu_si512(b.data() + i));
+			}
+			acc = _mm512_or_si512(acc, x);
+		}
+		if (0 != _mm512_test_epi64_mask(acc, acc)) {
+			return false;
+		}
+	}
+#endif
+#if defined(__AVX2__)
+	if constexpr (4 <= W) {
+		__m256i acc = _mm256_setzero_si256();
+		for (; i + 4 <= W; i += 4) {
+			__m256i x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a.data() + i));
+			if constexpr (Xor) {
+				x = _mm256_xor_si256(
+				    x, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b.data() + i)));
+			}
+			acc = _mm256_or_si256(acc, x);
+		}
+		if (!_mm256_testz_si256(acc, acc)) {
+			return false;
+		}
+	}
+#endif
+	std::uint64_t acc{};
+	for (; W != i; ++i) {
+		acc |= Xor ? a[i] ^ b[i] : a[i];
+	}
+	return 0 == acc;
+}
+
+template <std::size_t W>
+[[nodiscard]] std::size_t bitCount(std::array<std::uint64_t, W> const& a) noexcept
+{
+	std::size_t i{};
+	std::size_t count{};
+#if defined(__AVX512VPOPCNTDQ__)
+	if constexpr (8 <= W) {
+		__m512i acc = _mm512_setzero_si512();
+		for (; i + 8 <= W; i += 8) {
+			acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(a.data() + i)));
+		}
+		alignas(64) std::uint64_t sum[8];
+		_mm512_store_si512(sum, acc);
+		for (auto c : sum) {
+			count += static_cast<std::size_t>(c);
+		}
+	}
+#elif defined(__AVX2__)
+	// W. Muła, N. Kurz, D. Lemire, "Faster Population Counts Using AVX2 Instructions",
+	// the nibbles are counted with a shuffle and summed per 64 bit lane with `vpsadbw`
+	if constexpr (4 <= W) {
+		__m256i const lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		                                     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		__m256i const low = _mm256_set1_epi8(0x0F);
+		__m256i       acc = _mm256_setzero_si256();
+		for (; i + 4 <= W; i += 4) {
+			__m256i const x =
+			    _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a.data() + i));
+			__m256i const c = _mm256_add_epi8(
+			    _mm256_shuffle_epi8(lut, _mm256_and_si256(x, low)),
+			    _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+			acc = _mm256_add_epi64(acc, _mm256_sad_epu8(c, _mm256_setzero_si256()));
+		}
+		alignas(32) std::uint64_t sum[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(sum), acc);
+		count += static_cast<std::size_t>(sum[0] + sum[1] + sum[2] + sum[3]);
+	}
+#endif
+	for (; W != i; ++i) {
+		count += static_cast<std::size_t>(popcount(a[i]));
+	}
+	return count;
+}
+
+// Largest alignment (up to a cache line) that does not add padding
+template <std::size_t W>
+inline constexpr std::size_t BIT_SET_ALIGNMENT =
+    0 == W % 8 ? 64 : (0 == W % 4 ? 32 : (0 == W % 2 ? 16 : 8));
+}  // namespace detail
+
+/*!
+ * @brief Fixed-size set of `N > 64` bits, stored as an array of 64 bit words.
+ *
+ * Has the same interface as the single word `BitSet`, plus access to the words. The
+ * bitwise operations, `count`, and the comparisons are done word-parallel with AVX-512
+ * or AVX2 when available, so a `BitSet<512>` (e.g., the occupancy of an 8x8x8 brick,
+ * see `brick.hpp`) is a handful of vector instructions.
+ *
+ * Bit `i` is bit `i % 64` of word `i / 64`, and the bits of the last word above `N` are
+ * always zero.
+ */
 template <std::size_t N>
-constexpr BitSet<N> operator&(BitSet<N> lhs, BitSet<N> rhs) noexcept
+class alignas(detail::BIT_SET_ALIGNMENT<(N + 63) / 64>) BitSet<N, false>
 {
-	return BitSet<N>(lhs.set_ & rhs.set_);
+ public:
+	using word_type = std::uint64_t;
+
+	static constexpr std::size_t NUM_WORDS = (N + 63) / 64;
+
+ private:
+	static constexpr word_type LAST_WORD_MASK =
+	    0 == N % 64 ? ~word_type(0) : ~(~word_type(0) << (N % 64));
+
+ public:
+	struct Reference {
+		friend class BitSet;
+
+	 public:
+		constexpr Reference& operator=(bool x) noexcept
+		{
+			word_ ^= ((word_type(0) - static_cast<word_type>(x)) ^ word_) & index_;
+			return *this;
+		}
+
+		constexpr Reference& operator=(Reference const& x) noexcept { return operator=(!!x); }
+
+		constexpr operator bool() const noexcept { return word_type(0) != (word_ & index_); }
+
+		constexpr bool operator~() const noexcept { return word_type(0) == (word_ & index_); }
+
+		constexpr Reference& flip() noexcept
+		{
+			word_ ^= index_;
+			return *this;
+		}
+
+	 private:
+		constexpr Reference(word_type& word, std::size_t pos) noexcept
+		    : word_(word), index_(word_type(1) << pos)
+		{
+		}
+
+	 private:
+		word_type& word_;
+		word_type  index_;
+	};
+
+	constexpr BitSet() noexcept = default;
+
+	/*!
+	 * @brief Sets the first 64 bits to `val`, as for `std::bitset`.
+	 */
+	constexpr BitSet(word_type val) noexcept : words_{val} {}
+
+	bool operator==(BitSet const& rhs) const noexcept
+	{
+		return detail::bitNone<true>(words_, rhs.words_);
+	}
+
+	bool operator!=(BitSet const& rhs) const noexcept { return !(*this == rhs); }
+
+	[[nodiscard]] constexpr bool operator[](std::size_t pos) const
+	{
+		assert(N > pos);
+		return (words_[pos / 64] >> (pos % 64)) & word_type(1);
+	}
+
+	[[nodiscard]] constexpr Reference operator[](std::size_t pos)
+	{
+		assert(N > pos);
+		return Reference(words_[pos / 64], pos % 64);
+	}
+
+	[[nodiscard]] bool test(std::size_t pos) const
+	{
+		if (size() <= pos) {
+			throw std::out_of_range("position (which is " + std::to_string(pos) +
+			                        ") >= size (which is " + std::to_string(size()) + ")");
+		}
+		return operator[](pos);
+	}
+
+	[[nodiscard]] bool all() const noexcept
+	{
+		word_type acc = ~words_[NUM_WORDS - 1] & LAST_WORD_MASK;
+		for (std::size_t i{}; NUM_WORDS - 1 != i; ++i) {
+			acc |= ~words_[i];
+		}
+		return 0 == acc;
+	}
+
+	[[nodiscard]] bool any() const noexcept { return !none(); }
+
+	[[nodiscard]] bool none() const noexcept
+	{
+		return detail::bitNone<false>(words_, words_);
+	}
+
+	[[nodiscard]] bool some() const noexcept { return any() && !all(); }
+
+	[[nodiscard]] std::size_t count() const noexcept { return detail::bitCount(words_); }
+
+	[[nodiscard]] static constexpr std::size_t size() noexcept { return N; }
+
+	BitSet& operator&=(BitSet const& other) noexcept
+	{
+		detail::bitApply<detail::BitAnd>(words_, other.words_);
+		return *this;
+	}
+
+	BitSet& operator|=(BitSet const& other) noexcept
+	{
+		detail::bitApply<detail::BitOr>(words_, other.words_);
+		return *this;
+	}
+
+	BitSet& operator^=(BitSet const& other) noexcept
+	{
+		detail::bitApply<detail::BitXor>(words_, other.words_);
+		return *this;
+	}
+
+	/*!
+	 * @brief Clears the bits that are set in `other`, i.e., `*this &= ~other` without the
+	 * temporary.
+	 */
+	BitSet& andNot(BitSet const& other) noexcept
+	{
+		detail::bitApply<detail::BitAndNot>(words_, other.words_);
+		return *this;
+	}
+
+	BitSet operator~() const noexcept
+	{
+		BitSet b(*this);
+		b.flip();
+		return b;
+	}
+
+	constexpr BitSet& operator<<=(std::size_t pos) noexcept
+	{
+		std::size_t const w = pos / 64;
+		std::size_t const b = pos % 64;
+		for (std::size_t i = NUM_WORDS; 0 != i--;) {
+			word_type x{};
+			if (i >= w) {
+				x = words_[i - w] << b;
+				if (0 != b && i > w) {
+					x |= words_[i - w - 1] >> (64 - b);
+				}
+			}
+			words_[i] = x;
+		}
+		words_[NUM_WORDS - 1] &= LAST_WORD_MASK;
+		return *this;
+	}
+
+	constexpr BitSet& operator>>=(std::size_t pos) noexcept
+	{
+		std::size_t const w = pos / 64;
+		std::size_t const b = pos % 64;
+		for (std::size_t i{}; NUM_WORDS != i; ++i) {
+			word_type x{};
+			if (NUM_WORDS > i + w) {
+				x = words_[i + w] >> b;
+				if (0 != b && NUM_WORDS > i + w + 1) {
+					x |= words_[i + w + 1] << (64 - b);
+				}
+			}
+			words_[i] = x;
+		}
+		return *this;
+	}
+
+	constexpr BitSet operator<<(std::size_t pos) const noexcept
+	{
+		return BitSet(*this) <<= pos;
+	}
+
+	constexpr BitSet operator>>(std::size_t pos) const noexcept
+	{
+		return BitSet(*this) >>= pos;
+	}
+
+	constexpr void set() noexcept
+	{
+		for (auto& w : words_) {
+			w = ~word_type(0);
+		}
+		words_[NUM_WORDS - 1] = LAST_WORD_MASK;
+	}
+
+	constexpr void set(std::size_t pos, bool value)
+	{
+		assert(N > pos);
+		word_type& w = words_[pos / 64];
+		w ^= ((word_type(0) - static_cast<word_type>(value)) ^ w) &
+		     (word_type(1) << (pos % 64));
+	}
+
+	constexpr void set(std::size_t pos)
+	{
+		assert(N > pos);
+		words_[pos / 64] |= word_type(1) << (pos % 64);
+	}
+
+	constexpr void reset() noexcept
+	{
+		for (auto& w : words_) {
+			w = 0;
+		}
+	}
+
+	constexpr void reset(std::size_t pos)
+	{
+		assert(N > pos);
+		words_[pos / 64] &= ~(word_type(1) << (pos % 64));
+	}
+
+	constexpr void flip() noexcept
+	{
+		for (auto& w : words_) {
+			w = ~w;
+		}
+		words_[NUM_WORDS - 1] &= LAST_WORD_MASK;
+	}
+
+	constexpr void flip(std::size_t pos)
+	{
+		assert(N > pos);
+		words_[pos / 64] ^= word_type(1) << (pos % 64);
+	}
+
+	[[nodiscard]] constexpr std::array<word_type, NUM_WORDS> const& data() const noexcept
+	{
+		return words_;
+	}
+
+	/*!
+	 * @brief Mutable access to the words, the bits of the last word above `N` have to be
+	 * kept zero.
+	 */
+	[[nodiscard]] constexpr std::array<word_type, NUM_WORDS>& data() noexcept
+	{
+		return words_;
+	}
+
+ private:
+	std::array<word_type, NUM_WORDS> words_{};
+};
+
+template <std::size_t N>
+constexpr BitSet<N, true> operator&(BitSet<N, true> lhs, BitSet<N, true> rhs) noexcept
+{
+	return BitSet<N, true>(lhs.set_ & rhs.set_);
+}
+
+template <std::size_t N>
+constexpr BitSet<N, true> operator|(BitSet<N, true> lhs, BitSet<N, true> rhs) noexcept
+{
+	return BitSet<N, true>(lhs.set_ | rhs.set_);
+}
+
+template <std::size_t N>
+constexpr BitSet<N, true> operator^(BitSet<N, true> lhs, BitSet<N, true> rhs) noexcept
+{
+	return BitSet<N, true>(lhs.set_ ^ rhs.set_);
+}
+
+template <std::size_t N>
+BitSet<N, false> operator&(BitSet<N, false> const& lhs,
+                            BitSet<N, false> const& rhs) noexcept
+{
+	return BitSet<N, false>(lhs) &= rhs;
 }
 
 template <std::size_t N>
-constexpr BitSet<N> operator|(BitSet<N> lhs, BitSet<N> rhs) noexcept
+BitSet<N, false> operator|(BitSet<N, false> const& lhs,
+                            BitSet<N, false> const& rhs) noexcept
 {
-	return BitSet<N>(lhs.set_ | rhs.set_);
+	return BitSet<N, false>(lhs) |= rhs;
 }
 
 template <std::size_t N>
-constexpr BitSet<N> operator^(BitSet<N> lhs, BitSet<N> rhs) noexcept
+BitSet<N, false> operator^(BitSet<N, false> const& lhs,
+                            BitSet<N, false> const& rhs) noexcept
 {
-	return BitSet<N>(lhs.set_ ^ rhs.set_);
+	return BitSet<N, false>(lhs) ^= rhs;
 }
 
 template <class CharT, class Traits, std::size_t N>
 std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os,
-                                              BitSet<N>                          x)
+                                              BitSet<N, true>                    x)
 {
 	return os << +x.set_;
 }
 
+/*!
+ * @brief Writes the bits as `0`s and `1`s, the last bit first as for `std::bitset`.
+ */
+template <class CharT, class Traits, std::size_t N>
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os,
+                                              BitSet<N, false> const&            x)
+{
+	std::basic_string<CharT, Traits> str(N, os.widen('0'));
+	for (std::size_t i{}; N != i; ++i) {
+		if (x[i]) {
+			str[N - 1 - i] = os.widen('1');
+		}
+	}
+	return os << str;
+}
+
 template <class CharT, class Traits, std::size_t N>
 std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is,
-                                              BitSet<N>&                         x)
+                                              BitSet<N, true>&                   x)
 {
 	// TODO: Implement
 	return is;
@@ -269,9 +791,20 @@ std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>&
 namespace std
 {
 template <std::size_t N>
-struct hash<ufo::BitSet<N>> {
-	std::size_t operator()(ufo::BitSet<N> x) const { return x.set_; }
+struct hash<ufo::BitSet<N, true>> {
+	std::size_t operator()(ufo::BitSet<N, true> x) const
+	{
+		return static_cast<std::size_t>(ufo::hashMix(x.set_));
+	}
+};
+
+template <std::size_t N>
+struct hash<ufo::BitSet<N, false>> {
+	std::size_t operator()(ufo::BitSet<N, false> const& x) const
+	{
+		return static_cast<std::size_t>(ufo::hashBytes(x.data().data(), sizeof(x.data())));
+	}
 };
 }  // namespace std
 
-#endif  // UFO_UTILITY_BIT_SET_HPP
\ No newline at end of file
+#endif  // UFO_UTILITY_BIT_SET_HPP
@@ -0,0 +1,375 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BLOOM_FILTER_HPP
+#define UFO_UTILITY_BLOOM_FILTER_HPP
+
+// UFO
+#include <ufo/utility/aligned_vector.hpp>
+#include <ufo/utility/cache_line.hpp>
+#include <ufo/utility/hash.hpp>
+#include <ufo/utility/io/read_buffer.hpp>
+#include <ufo/utility/io/write_buffer.hpp>
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+namespace detail
+{
+// Words in a block, each key sets one bit in every word of its block
+inline constexpr std::size_t BLOOM_BLOCK_WORDS = 8;
+
+// Odd multipliers deriving the eight bit positions from 32 bits of the hash
+inline constexpr std::array<std::uint32_t, BLOOM_BLOCK_WORDS> BLOOM_SALT{
+    0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+    0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u};
+
+/*!
+ * False positive rate of a block that has received on average `load` keys, with the
+ * number of keys per block following a Poisson distribution.
+ */
+[[nodiscard]] inline double bloomBlockFpr(double load) noexcept
+{
+	double const log_load = std::log(load);
+	double       fpr{};
+	auto const   last = static_cast<std::size_t>(load + 10.0 * std::sqrt(load) + 10.0);
+	for (std::size_t j = 1; last >= j; ++j) {
+		double const keys   = static_cast<double>(j);
+		double const p      = std::exp(keys * log_load - load - std::lgamma(keys + 1.0));
+		double const in_set = 1.0 - std::pow(63.0 / 64.0, keys);
+		fpr += p * std::pow(in_set, static_cast<double>(BLOOM_BLOCK_WORDS));
+	}
+	return fpr;
+}
+}  // namespace detail
+
+/*!
+ * @brief Blocked Bloom filter, answers "definitely not present" or "maybe present".
+ *
+ * The filter is divided into blocks of one cache line (8 words of 64 bits). A key
+ * selects a block with the upper half of its hash and sets one bit in each word of
+ * that block with the lower half, so an insert or a query touches a single cache line
+ * no matter the number of bits per key. With AVX2 the eight bit positions are
+ * computed and tested with a handful of vector instructions.
+ *
+ * Compared to a classic Bloom filter a few more bits per key are needed for the same
+ * false positive rate, as the keys are not spread perfectly evenly over the blocks;
+ * the constructor accounts for this.
+ *
+ * Keys can not be removed, see `CuckooFilter` for that.
+ *
+ * @tparam Key The type of the keys.
+ * @tparam HashFn Hash function for `Key`, should mix all bits of the result well.
+ */
+template <class Key, class HashFn = Hash<Key>>
+class BloomFilter
+{
+	static constexpr std::size_t BLOCK_WORDS = detail::BLOOM_BLOCK_WORDS;
+	static constexpr std::size_t BATCH       = 16;
+
+ public:
+	using key_type  = Key;
+	using hasher    = HashFn;
+	using size_type = std::size_t;
+
+	/*!
+	 * @brief Creates a filter of a single block, so it is always safe to insert into.
+	 */
+	BloomFilter() : words_(BLOCK_WORDS, 0) {}
+
+	/*!
+	 * @brief Creates a filter sized for `expected_count` keys at a false positive rate of
+	 * at most `fpr`.
+	 *
+	 * @throws std::invalid_argument If `fpr` is not in (0, 1).
+	 */
+	explicit BloomFilter(size_type expected_count, double fpr = 0.01,
+	                     HashFn const& hash = HashFn())
+	    : hash_(hash)
+	{
+		if (!(0.0 < fpr && 1.0 > fpr)) {
+			throw std::invalid_argument("BloomFilter: false positive rate " +
+			                            std::to_string(fpr) + " not in (0, 1)");
+		}
+
+		// The rate increases with the number of keys per block, so bisect for the
+		// highest load that still meets `fpr`
+		double lo = 0.0;
+		double hi = 512.0;
+		for (int i{}; 64 > i; ++i) {
+			double const mid = (lo + hi) / 2.0;
+			(fpr >= detail::bloomBlockFpr(mid) ? lo : hi) = mid;
+		}
+
+		auto const blocks =
+		    std::ceil(static_cast<double>(std::max<size_type>(expected_count, 1)) /
+		              std::max(lo, 1e-3));
+		words_.assign(static_cast<size_type>(blocks) * BLOCK_WORDS, 0);
+	}
+
+	void insert(Key const& key) { insertHash(hash_(key)); }
+
+	/*!
+	 * @brief Inserts all `keys`, prefetching the blocks of a batch of keys before
+	 * touching any of them.
+	 */
+	void insert(Span<Key const> keys)
+	{
+		std::array<std::uint64_t, BATCH> h;
+		for (size_type i{}; keys.size() > i; i += BATCH) {
+			size_type const n = std::min(BATCH, keys.size() - i);
+			for (size_type j{}; n > j; ++j) {
+				h[j] = hash_(keys[i + j]);
+				prefetch(block(h[j]));
+			}
+			for (size_type j{}; n > j; ++j) {
+				insertHash(h[j]);
+			}
+		}
+	}
+
+	/*!
+	 * @brief Inserts a key by its already computed hash, has to be combined with
+	 * `containsHash`.
+	 */
+	void insertHash(std::uint64_t hash) noexcept
+	{
+		std::uint64_t*      b = block(hash);
+		std::uint32_t const h = static_cast<std::uint32_t>(hash);
+#if defined(__AVX2__)
+		__m256i lo, hi;
+		masks(h, lo, hi);
+		auto* v = reinterpret_cast<__m256i*>(b);
+		_mm256_store_si256(v, _mm256_or_si256(_mm256_load_si256(v), lo));
+		_mm256_store_si256(v + 1, _mm256_or_si256(_mm256_load_si256(v + 1), hi));
+#else
+		for (size_type i{}; BLOCK_WORDS != i; ++i) {
+			b[i] |= std::uint64_t(1) << ((h * detail::BLOOM_SALT[i]) >> 26);
+		}
+#endif
+	}
+
+	/*!
+	 * @return False if `key` has definitely not been inserted, true if it might have
+	 * been.
+	 */
+	[[nodiscard]] bool contains(Key const& key) const { return containsHash(hash_(key)); }
+
+	/*!
+	 * @brief Queries all `keys`, `result[i]` is set to `contains(keys[i])`.
+	 */
+	void contains(Span<Key const> keys, Span<bool> result) const
+	{
+		assert(keys.size() <= result.size());
+
+		std::array<std::uint64_t, BATCH> h;
+		for (size_type i{}; keys.size() > i; i += BATCH) {
+			size_type const n = std::min(BATCH, keys.size() - i);
+			for (size_type j{}; n > j; ++j) {
+				h[j] = hash_(keys[i + j]);
+				prefetch(block(h[j]));
+			}
+			for (size_type j{}; n > j; ++j) {
+				result[i + j] = containsHash(h[j]);
+			}
+		}
+	}
+
+	[[nodiscard]] bool containsHash(std::uint64_t hash) const noexcept
+	{
+		std::uint64_t const* b = block(hash);
+		std::uint32_t const  h = static_cast<std::uint32_t>(hash);
+#if defined(__AVX2__)
+		__m256i lo, hi;
+		masks(h, lo, hi);
+		auto const* v = reinterpret_cast<__m256i const*>(b);
+		return _mm256_testc_si256(_mm256_load_si256(v), lo) &
+		       _mm256_testc_si256(_mm256_load_si256(v + 1), hi);
+#else
+		std::uint64_t found = 1;
+		for (size_type i{}; BLOCK_WORDS != i; ++i) {
+			found &= b[i] >> ((h * detail::BLOOM_SALT[i]) >> 26);
+		}
+		return found & 1;
+#endif
+	}
+
+	/*!
+	 * @brief Expected false positive rate after `count` distinct keys have been
+	 * inserted.
+	 */
+	[[nodiscard]] double falsePositiveRate(size_type count) const noexcept
+	{
+		return 0 == count ? 0.0
+		                  : detail::bloomBlockFpr(static_cast<double>(count) /
+		                                          static_cast<double>(numBlocks()));
+	}
+
+	/*!
+	 * @brief Adds all keys of `other`, which has to have the same number of blocks.
+	 *
+	 * @throws std::invalid_argument If the number of blocks differ.
+	 */
+	BloomFilter& merge(BloomFilter const& other)
+	{
+		if (numBlocks() != other.numBlocks()) {
+			throw std::invalid_argument("BloomFilter: can not merge filters of " +
+			                            std::to_string(numBlocks()) + " and " +
+			                            std::to_string(other.numBlocks()) + " blocks");
+		}
+		for (size_type i{}; words_.size() != i; ++i) {
+			words_[i] |= other.words_[i];
+		}
+		return *this;
+	}
+
+	void clear() noexcept { std::fill(words_.begin(), words_.end(), 0); }
+
+	[[nodiscard]] size_type numBlocks() const noexcept
+	{
+		return words_.size() / BLOCK_WORDS;
+	}
+
+	/*!
+	 * @brief Number of bytes used for the bits, excluding the object itself.
+	 */
+	[[nodiscard]] size_type memoryUsage() const noexcept
+	{
+		return words_.capacity() * sizeof(std::uint64_t);
+	}
+
+	[[nodiscard]] hasher hash_function() const { return hash_; }
+
+	/*!
+	 * @brief Writes the number of blocks followed by the blocks as is.
+	 *
+	 * The hash function is not stored, the reader has to use the same one.
+	 */
+	void write(WriteBuffer& out) const
+	{
+		out.write(static_cast<std::uint64_t>(numBlocks()));
+		out.write(words_.data(), words_.size() * sizeof(std::uint64_t));
+	}
+
+	/*!
+	 * @brief Reads a filter written by `write`.
+	 *
+	 * @throws std::runtime_error If the stored filter has no blocks.
+	 * @throws std::out_of_range If `in` does not hold the whole filter.
+	 */
+	void read(ReadBuffer& in)
+	{
+		std::uint64_t blocks;
+		in.read(blocks);
+		if (0 == blocks) {
+			throw std::runtime_error("BloomFilter: stored filter has no blocks");
+		}
+		if (in.readLeft() / (BLOCK_WORDS * sizeof(std::uint64_t)) < blocks) {
+			throw std::out_of_range("BloomFilter: buffer too small for " +
+			                        std::to_string(blocks) + " blocks");
+		}
+
+		words_.assign(static_cast<size_type>(blocks) * BLOCK_WORDS, 0);
+		in.read(words_.data(), words_.size() * sizeof(std::uint64_t));
+	}
+
+	friend bool operator==(BloomFilter const& lhs, BloomFilter const& rhs) noexcept
+	{
+		return lhs.words_ == rhs.words_;
+	}
+
+	friend bool operator!=(BloomFilter const& lhs, BloomFilter const& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+ private:
+	[[nodiscard]] size_type blockIndex(std::uint64_t hash) const noexcept
+	{
+		// Maps the upper 32 bits onto [0, numBlocks()) without a division
+		return static_cast<size_type>(((hash >> 32) * numBlocks()) >> 32);
+	}
+
+	[[nodiscard]] std::uint64_t* block(std::uint64_t hash) noexcept
+	{
+		return words_.data() + blockIndex(hash) * BLOCK_WORDS;
+	}
+
+	[[nodiscard]] std::uint64_t const* block(std::uint64_t hash) const noexcept
+	{
+		return words_.data() + blockIndex(hash) * BLOCK_WORDS;
+	}
+
+#if defined(__AVX2__)
+	// One bit per word, for the lower and upper four words of a block
+	static void masks(std::uint32_t h, __m256i& lo, __m256i& hi) noexcept
+	{
+		__m256i const salt =
+		    _mm256_loadu_si256(reinterpret_cast<__m256i const*>(detail::BLOOM_SALT.data()));
+		__m256i const key = _mm256_set1_epi32(static_cast<int>(h));
+		__m256i const bit = _mm256_srli_epi32(_mm256_mullo_epi32(key, salt), 26);
+		__m256i const one = _mm256_set1_epi64x(1);
+		lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bit)));
+		hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bit, 1)));
+	}
+#endif
+
+ private:
+	AlignedVector<std::uint64_t> words_;
+	HashFn                       hash_;
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BLOOM_FILTER_HPP
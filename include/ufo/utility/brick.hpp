@@ -0,0 +1,269 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BRICK_HPP
+#define UFO_UTILITY_BRICK_HPP
+
+// UFO
+#include <ufo/utility/bit_set.hpp>
+
+// STL
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Occupancy (or any other per voxel flag) of an 8x8x8 brick, with voxel
+ * `(x, y, z)` at bit `x + 8 * y + 64 * z`.
+ *
+ * Each word of the bit set is an xy-slice and each byte a row along x, so shifting the
+ * brick one voxel along x or y is a shift of all words (masking the bits that would
+ * wrap into the next row) and along z a shift of the words themselves. The morphology
+ * below is built from these shifts and works on all 512 voxels at once.
+ */
+using Brick = BitSet<512>;
+
+inline constexpr std::size_t BRICK_SIZE = 8;
+
+[[nodiscard]] constexpr std::size_t brickIndex(std::size_t x, std::size_t y,
+                                               std::size_t z) noexcept
+{
+	assert(BRICK_SIZE > x && BRICK_SIZE > y && BRICK_SIZE > z);
+	return x + BRICK_SIZE * y + BRICK_SIZE * BRICK_SIZE * z;
+}
+
+enum class BrickConnectivity {
+	// The 6 voxels sharing a face
+	FACE,
+	// The 18 voxels sharing a face or an edge
+	EDGE,
+	// The 26 voxels sharing a face, an edge, or a corner
+	VERTEX
+};
+
+namespace detail
+{
+// Replicates the row (byte) mask `row` to all rows of a word
+[[nodiscard]] constexpr std::uint64_t brickRows(std::uint64_t row) noexcept
+{
+	return (row & 0xFFu) * 0x0101010101010101u;
+}
+
+// Shifts all words left by `s` (right if negative) and keeps the bits in `mask`
+[[nodiscard]] inline Brick brickShiftWords(Brick const& b, int s,
+                                           std::uint64_t mask) noexcept
+{
+	Brick r;
+	auto const& src = b.data();
+	auto&       dst = r.data();
+#if defined(__AVX512F__)
+	// The zero-masking forms, since GCC warns about the undefined source of the others
+	__m512i const x = _mm512_loadu_si512(src.data());
+	__m128i const c = _mm_cvtsi32_si128(0 <= s ? s : -s);
+	__m512i const y = 0 <= s ? _mm512_maskz_sll_epi64(0xFF, x, c)
+	                         : _mm512_maskz_srl_epi64(0xFF, x, c);
+	__m512i const m = _mm512_set1_epi64(static_cast<long long>(mask));
+	_mm512_storeu_si512(dst.data(), _mm512_and_si512(y, m));
+#elif defined(__AVX2__)
+	__m128i const c = _mm_cvtsi32_si128(0 <= s ? s : -s);
+	__m256i const m = _mm256_set1_epi64x(static_cast<long long>(mask));
+	for (std::size_t i{}; 8 != i; i += 4) {
+		__m256i const x =
+		    _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src.data() + i));
+		__m256i const y = 0 <= s ? _mm256_sll_epi64(x, c) : _mm256_srl_epi64(x, c);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst.data() + i),
+		                    _mm256_and_si256(y, m));
+	}
+#else
+	for (std::size_t i{}; 8 != i; ++i) {
+		dst[i] = (0 <= s ? src[i] << s : src[i] >> -s) & mask;
+	}
+#endif
+	return r;
+}
+}  // namespace detail
+
+/*!
+ * @brief Moves the content of the brick `n` voxels along `Axis` (0 = x, 1 = y, 2 = z),
+ * i.e., voxel `p` of the result is voxel `p - n * e_Axis` of `b`.
+ *
+ * Voxels moved in from outside the brick are empty, and those moved out are lost.
+ *
+ * @param n Number of voxels, negative to move in the negative direction.
+ */
+template <std::size_t Axis>
+[[nodiscard]] Brick brickShift(Brick const& b, int n) noexcept
+{
+	static_assert(3 > Axis, "Axis out of range");
+
+	int const size = static_cast<int>(BRICK_SIZE);
+	if (size <= n || -size >= n) {
+		return Brick();
+	}
+
+	if constexpr (0 == Axis) {
+		// Clear the columns that would receive the bits of the neighboring row
+		std::uint64_t const row = 0 <= n ? 0xFFu << n : 0xFFu >> -n;
+		return detail::brickShiftWords(b, n, detail::brickRows(row));
+	} else if constexpr (1 == Axis) {
+		return detail::brickShiftWords(b, 8 * n, ~std::uint64_t(0));
+	} else {
+		Brick r;
+		auto const& src = b.data();
+		auto&       dst = r.data();
+#if defined(__AVX512F__)
+		// Lane `i` takes word `i - n`, lanes outside the brick are zeroed
+		__m512i const  idx = _mm512_sub_epi64(_mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7),
+		                                      _mm512_set1_epi64(n));
+		__mmask8 const k   = static_cast<__mmask8>(0 <= n ? 0xFFu << n : 0xFFu >> -n);
+		__m512i const  x   = _mm512_loadu_si512(src.data());
+		_mm512_storeu_si512(dst.data(), _mm512_maskz_permutexvar_epi64(k, idx, x));
+#else
+		for (int z{}; size != z; ++z) {
+			int const from = z - n;
+			dst[z]         = 0 <= from && size > from ? src[from] : 0;
+		}
+#endif
+		return r;
+	}
+}
+
+/*!
+ * @brief Same as above, but the voxels moved in from outside the brick are taken from
+ * `next`, the neighboring brick they come from (i.e., the one in the negative `Axis`
+ * direction if `n` is positive).
+ *
+ * Used to apply the morphology across brick boundaries.
+ */
+template <std::size_t Axis>
+[[nodiscard]] Brick brickShift(Brick const& b, int n, Brick const& next) noexcept
+{
+	int const size = static_cast<int>(BRICK_SIZE);
+	Brick     r    = brickShift<Axis>(b, n);
+	if (0 != n) {
+		r |= brickShift<Axis>(next, 0 < n ? n - size : n + size);
+	}
+	return r;
+}
+
+/*!
+ * @brief Voxels with at least one set neighbor, not counting the voxel itself.
+ *
+ * Voxels outside the brick count as empty. Typical uses are frontier detection (free
+ * voxels with an unknown neighbor: `free & brickNeighborAny(unknown)`) and finding the
+ * surface of a region.
+ */
+[[nodiscard]] inline Brick brickNeighborAny(
+    Brick const& b, BrickConnectivity connectivity = BrickConnectivity::FACE) noexcept
+{
+	// The neighbors are split by the first non-zero offset: along x (any y and z), along y
+	// (no x offset), and along z (no x and y offset)
+	Brick const x = brickShift<0>(b, 1) | brickShift<0>(b, -1);
+	Brick const y = brickShift<1>(b, 1) | brickShift<1>(b, -1);
+
+	switch (connectivity) {
+		case BrickConnectivity::FACE:
+			return x | y | brickShift<2>(b, 1) | brickShift<2>(b, -1);
+		case BrickConnectivity::EDGE: {
+			// The 8 neighbors in the same slice, and the 5 voxel plus in the slices above and
+			// below
+			Brick const plane = x | brickShift<1>(x, 1) | brickShift<1>(x, -1) | y;
+			Brick const plus  = b | x | y;
+			return plane | brickShift<2>(plus, 1) | brickShift<2>(plus, -1);
+		}
+		case BrickConnectivity::VERTEX: {
+			Brick const plane  = x | brickShift<1>(x, 1) | brickShift<1>(x, -1) | y;
+			Brick const column = plane | b;
+			return plane | brickShift<2>(column, 1) | brickShift<2>(column, -1);
+		}
+	}
+	return Brick();
+}
+
+/*!
+ * @brief Sets all voxels with a set neighbor, e.g., to inflate obstacles by one voxel.
+ *
+ * Repeat (or alternate connectivities) to dilate further, and use `brickShift` with the
+ * neighboring bricks to take voxels across the brick boundary into account.
+ */
+[[nodiscard]] inline Brick brickDilate(
+    Brick const& b, BrickConnectivity connectivity = BrickConnectivity::FACE) noexcept
+{
+	return b | brickNeighborAny(b, connectivity);
+}
+
+/*!
+ * @brief Keeps the voxels whose neighbors are all set.
+ *
+ * Voxels outside the brick count as empty, so the voxels on the boundary of the brick
+ * are always cleared.
+ */
+[[nodiscard]] inline Brick brickErode(
+    Brick const& b, BrickConnectivity connectivity = BrickConnectivity::FACE) noexcept
+{
+	Brick const x = b & brickShift<0>(b, 1) & brickShift<0>(b, -1);
+
+	switch (connectivity) {
+		case BrickConnectivity::FACE:
+			return x & brickShift<1>(b, 1) & brickShift<1>(b, -1) & brickShift<2>(b, 1) &
+			       brickShift<2>(b, -1);
+		case BrickConnectivity::EDGE: {
+			Brick const plane = x & brickShift<1>(x, 1) & brickShift<1>(x, -1);
+			Brick const plus  = x & brickShift<1>(b, 1) & brickShift<1>(b, -1);
+			return plane & brickShift<2>(plus, 1) & brickShift<2>(plus, -1);
+		}
+		case BrickConnectivity::VERTEX: {
+			Brick const plane = x & brickShift<1>(x, 1) & brickShift<1>(x, -1);
+			return plane & brickShift<2>(plane, 1) & brickShift<2>(plane, -1);
+		}
+	}
+	return Brick();
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BRICK_HPP
@@ -0,0 +1,118 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_CACHE_LINE_HPP
+#define UFO_UTILITY_CACHE_LINE_HPP
+
+// STL
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace ufo
+{
+/*!
+ * @brief Assumed size of a cache line, in bytes.
+ *
+ * `std::hardware_destructive_interference_size` is not used since it is not available
+ * everywhere and its value may differ between translation units compiled with
+ * different flags, which would break the ABI of types aligned with it.
+ *
+ * Apple silicon uses 128 byte cache lines, and modern x86 processors prefetch cache
+ * lines in pairs, but 64 bytes is the common denominator.
+ */
+#if defined(__APPLE__) && defined(__aarch64__)
+inline constexpr std::size_t CACHE_LINE_SIZE = 128;
+#else
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+#endif
+
+/*!
+ * @brief Hints that the cache line containing `p` will soon be read.
+ *
+ * Only worth it when the address is known well ahead of the access, e.g., when probing
+ * a large table for a batch of keys.
+ */
+inline void prefetch(void const* p) noexcept
+{
+#if defined(__GNUC__)
+	__builtin_prefetch(p);
+#else
+	(void)p;
+#endif
+}
+
+/*!
+ * @brief Stores a `T` in cache lines of its own.
+ *
+ * The wrapper is aligned to, and its size is a multiple of, `CACHE_LINE_SIZE`, so
+ * neighbouring objects in an array (e.g., locks or per-thread counters) never share a
+ * cache line and writes to one do not invalidate the others (false sharing).
+ */
+template <class T>
+struct alignas(CACHE_LINE_SIZE) CacheAligned {
+	T value{};
+
+	CacheAligned() = default;
+
+	template <class... Args,
+	          std::enable_if_t<std::is_constructible_v<T, Args&&...>, bool> = true>
+	explicit CacheAligned(std::in_place_t, Args&&... args)
+	    : value(std::forward<Args>(args)...)
+	{
+	}
+
+	CacheAligned(T const& value) : value(value) {}
+
+	CacheAligned(T&& value) : value(std::move(value)) {}
+
+	[[nodiscard]] T&       get() noexcept { return value; }
+	[[nodiscard]] T const& get() const noexcept { return value; }
+
+	[[nodiscard]] T&       operator*() noexcept { return value; }
+	[[nodiscard]] T const& operator*() const noexcept { return value; }
+
+	[[nodiscard]] T*       operator->() noexcept { return &value; }
+	[[nodiscard]] T const* operator->() const noexcept { return &value; }
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_CACHE_LINE_HPP
@@ -0,0 +1,300 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_CONCURRENT_FLAT_HASH_MAP_HPP
+#define UFO_UTILITY_CONCURRENT_FLAT_HASH_MAP_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/cache_line.hpp>
+#include <ufo/utility/flat_hash_map.hpp>
+#include <ufo/utility/hash.hpp>
+#include <ufo/utility/rw_spinlock.hpp>
+
+// STL
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+namespace ufo
+{
+/*!
+ * @brief Thread-safe hash map made of independently locked `FlatHashMap` shards.
+ *
+ * The shard of a key is taken from the high bits of its hash (the shards themselves
+ * use the low bits), and each shard sits in its own cache lines behind a
+ * `RWSpinlock`, so threads working on different keys rarely contend and concurrent
+ * lookups never block each other.
+ *
+ * Since references into a shard are only valid while its lock is held, elements are
+ * accessed through copies (`find`) or callbacks run under the lock (`visit`,
+ * `forEach`). The callbacks must not access the map.
+ */
+template <class Key, class T, class HashFn = Hash<Key>,
+          class KeyEqual = std::equal_to<Key>>
+class ConcurrentFlatHashMap
+{
+	struct Shard {
+		Shard(HashFn const& hash, KeyEqual const& equal) : map(0, hash, equal) {}
+
+		mutable RWSpinlock                    lock;
+		FlatHashMap<Key, T, HashFn, KeyEqual> map;
+	};
+
+	// The shards are built in place from the functors, so neither has to be default
+	// constructible
+	struct ShardDeleter {
+		std::size_t num_shards;
+
+		void operator()(CacheAligned<Shard>* p) const noexcept
+		{
+			std::destroy_n(p, num_shards);
+			::operator delete(p, std::align_val_t(alignof(CacheAligned<Shard>)));
+		}
+	};
+
+	using Shards = std::unique_ptr<CacheAligned<Shard>[], ShardDeleter>;
+
+ public:
+	using key_type    = Key;
+	using mapped_type = T;
+	using size_type   = std::size_t;
+
+	/*!
+	 * @param num_shards Rounded up to a power of two, a few times the number of threads
+	 * is a good choice.
+	 * @param hash Picks the shard and is copied into every shard's map.
+	 * @param equal Copied into every shard's map.
+	 */
+	explicit ConcurrentFlatHashMap(size_type num_shards = 64, HashFn const& hash = HashFn(),
+	                               KeyEqual const& equal = KeyEqual())
+	    : shift_(64 - countrZero(bitCeil(std::max(num_shards, size_type(2)))))
+	    , shards_(makeShards(size_type(1) << (64 - shift_), hash, equal))
+	    , hash_(hash)
+	{
+	}
+
+	/*!
+	 * @brief Inserts `(key, T(args...))` if `key` is not present.
+	 *
+	 * @return Whether the element was inserted.
+	 */
+	template <class... Args>
+	bool tryEmplace(Key const& key, Args&&... args)
+	{
+		Shard&                            s = shard(key);
+		std::lock_guard<RWSpinlock> const lock(s.lock);
+		return s.map.try_emplace(key, std::forward<Args>(args)...).second;
+	}
+
+	bool insert(Key const& key, T const& value) { return tryEmplace(key, value); }
+
+	/*!
+	 * @brief Inserts `(key, value)`, or assigns `value` if `key` is present.
+	 *
+	 * @return Whether the element was inserted.
+	 */
+	template <class M>
+	bool insertOrAssign(Key const& key, M&& value)
+	{
+		Shard&                            s = shard(key);
+		std::lock_guard<RWSpinlock> const lock(s.lock);
+		return s.map.insert_or_assign(key, std::forward<M>(value)).second;
+	}
+
+	/*!
+	 * @brief Returns a copy of the value of `key`, if present.
+	 */
+	[[nodiscard]] std::optional<T> find(Key const& key) const
+	{
+		Shard const&                       s = shard(key);
+		std::shared_lock<RWSpinlock> const lock(s.lock);
+		if (auto it = s.map.find(key); s.map.end() != it) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	[[nodiscard]] bool contains(Key const& key) const
+	{
+		Shard const&                       s = shard(key);
+		std::shared_lock<RWSpinlock> const lock(s.lock);
+		return s.map.contains(key);
+	}
+
+	/*!
+	 * @brief Calls `f(value)` on the value of `key`, if present, under an exclusive
+	 * lock.
+	 *
+	 * @return Whether `key` was present.
+	 */
+	template <class UnaryFunction>
+	bool visit(Key const& key, UnaryFunction f)
+	{
+		Shard&                            s = shard(key);
+		std::lock_guard<RWSpinlock> const lock(s.lock);
+		if (auto it = s.map.find(key); s.map.end() != it) {
+			f(it->second);
+			return true;
+		}
+		return false;
+	}
+
+	/*!
+	 * @brief Calls `f(value)` on the value of `key` under an exclusive lock, inserting
+	 * `T(args...)` first if not present (e.g., to accumulate into a voxel).
+	 *
+	 * @return Whether the element was inserted.
+	 */
+	template <class UnaryFunction, class... Args>
+	bool emplaceOrVisit(Key const& key, UnaryFunction f, Args&&... args)
+	{
+		Shard&                            s = shard(key);
+		std::lock_guard<RWSpinlock> const lock(s.lock);
+		auto [it, inserted] = s.map.try_emplace(key, std::forward<Args>(args)...);
+		f(it->second);
+		return inserted;
+	}
+
+	bool erase(Key const& key)
+	{
+		Shard&                            s = shard(key);
+		std::lock_guard<RWSpinlock> const lock(s.lock);
+		return 0 != s.map.erase(key);
+	}
+
+	/*!
+	 * @brief Calls `f(key, value)` for all elements, one shard at a time under a shared
+	 * lock.
+	 */
+	template <class BinaryFunction>
+	void forEach(BinaryFunction f) const
+	{
+		for (size_type i{}; numShards() != i; ++i) {
+			Shard const&                       s = *shards_[i];
+			std::shared_lock<RWSpinlock> const lock(s.lock);
+			for (auto const& [key, value] : s.map) {
+				f(key, value);
+			}
+		}
+	}
+
+	/*!
+	 * @brief Number of elements; only a snapshot when there are concurrent writers.
+	 */
+	[[nodiscard]] size_type size() const
+	{
+		size_type n{};
+		for (size_type i{}; numShards() != i; ++i) {
+			Shard const&                       s = *shards_[i];
+			std::shared_lock<RWSpinlock> const lock(s.lock);
+			n += s.map.size();
+		}
+		return n;
+	}
+
+	[[nodiscard]] bool empty() const { return 0 == size(); }
+
+	void clear()
+	{
+		for (size_type i{}; numShards() != i; ++i) {
+			Shard&                            s = *shards_[i];
+			std::lock_guard<RWSpinlock> const lock(s.lock);
+			s.map.clear();
+		}
+	}
+
+	/*!
+	 * @brief Makes room for `count` elements, assuming they are evenly spread over the
+	 * shards.
+	 */
+	void reserve(size_type count)
+	{
+		size_type const per_shard = (count + numShards() - 1) / numShards();
+		for (size_type i{}; numShards() != i; ++i) {
+			Shard&                            s = *shards_[i];
+			std::lock_guard<RWSpinlock> const lock(s.lock);
+			s.map.reserve(per_shard + per_shard / 8);
+		}
+	}
+
+	[[nodiscard]] size_type numShards() const noexcept
+	{
+		return size_type(1) << (64 - shift_);
+	}
+
+ private:
+	[[nodiscard]] Shard& shard(Key const& key) const
+	{
+		return *shards_[static_cast<std::uint64_t>(hash_(key)) >> shift_];
+	}
+
+	[[nodiscard]] static Shards makeShards(size_type num_shards, HashFn const& hash,
+	                                       KeyEqual const& equal)
+	{
+		auto* p = static_cast<CacheAligned<Shard>*>(
+		    ::operator new(num_shards * sizeof(CacheAligned<Shard>),
+		                   std::align_val_t(alignof(CacheAligned<Shard>))));
+		size_type i{};
+		try {
+			for (; num_shards != i; ++i) {
+				::new (static_cast<void*>(p + i)) CacheAligned<Shard>(std::in_place, hash, equal);
+			}
+		} catch (...) {
+			ShardDeleter{i}(p);
+			throw;
+		}
+		return Shards(p, ShardDeleter{num_shards});
+	}
+
+ private:
+	unsigned shift_;
+	Shards   shards_;
+	HashFn   hash_;
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_CONCURRENT_FLAT_HASH_MAP_HPP
@@ -0,0 +1,534 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_CUCKOO_FILTER_HPP
+#define UFO_UTILITY_CUCKOO_FILTER_HPP
+
+// UFO
+#include <ufo/utility/aligned_vector.hpp>
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/cache_line.hpp>
+#include <ufo/utility/hash.hpp>
+#include <ufo/utility/io/read_buffer.hpp>
+#include <ufo/utility/io/write_buffer.hpp>
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Cuckoo filter, answers "definitely not present" or "maybe present" and, unlike
+ * `BloomFilter`, supports removing keys.
+ *
+ * Stores a small fingerprint of each key in one of two candidate buckets of four
+ * slots. A bucket is a single 32 or 64 bit word, so a query loads two words and
+ * compares all eight slots against the fingerprint at once (SSE2, or bit tricks on the
+ * words elsewhere), and the two buckets can be prefetched together in the bulk
+ * functions.
+ *
+ * The false positive rate is set by the fingerprint width: about 3% with 8 bits and
+ * about 0.012% with 16 bits at full load. The filter holds up to about 95% of
+ * `capacity()` keys; when an insert can not find room it returns false.
+ *
+ * Only remove keys that have been inserted, removing anything else may remove the
+ * fingerprint of another key and cause a false negative.
+ *
+ * @tparam Key The type of the keys.
+ * @tparam HashFn Hash function for `Key`, should mix all bits of the result well.
+ * @tparam Fingerprint `std::uint8_t` or `std::uint16_t`.
+ */
+template <class Key, class HashFn = Hash<Key>, class Fingerprint = std::uint16_t>
+class CuckooFilter
+{
+	static_assert(std::is_same_v<std::uint8_t, Fingerprint> ||
+	                  std::is_same_v<std::uint16_t, Fingerprint>,
+	              "CuckooFilter fingerprints have to be 8 or 16 bits");
+
+	using Bucket =
+	    std::conditional_t<1 == sizeof(Fingerprint), std::uint32_t, std::uint64_t>;
+
+	static constexpr std::size_t SLOTS     = 4;
+	static constexpr unsigned    BITS      = 8 * sizeof(Fingerprint);
+	static constexpr Bucket      LOW       = Bucket(~Bucket(0)) / Fingerprint(~0u);
+	static constexpr Bucket      HIGH      = LOW << (BITS - 1);
+	static constexpr std::size_t MAX_KICKS = 500;
+	static constexpr std::size_t BATCH     = 16;
+	static constexpr double      MAX_LOAD  = 0.95;
+
+	struct Victim {
+		std::uint64_t index{};
+		Fingerprint   fp{};
+		bool          used{};
+	};
+
+ public:
+	using key_type  = Key;
+	using hasher    = HashFn;
+	using size_type = std::size_t;
+
+	CuckooFilter() = default;
+
+	/*!
+	 * @brief Creates a filter with room for at least `expected_count` keys.
+	 */
+	explicit CuckooFilter(size_type expected_count, HashFn const& hash = HashFn())
+	    : hash_(hash)
+	{
+		// Rounding up to a power of two leaves room to spare, unless it is a close call
+		size_type buckets =
+		    bitCeil(std::max<size_type>((expected_count + SLOTS - 1) / SLOTS, 2));
+		if (static_cast<double>(expected_count) >
+		    MAX_LOAD * static_cast<double>(buckets * SLOTS)) {
+			buckets *= 2;
+		}
+		buckets_.assign(buckets, 0);
+	}
+
+	/*!
+	 * @return Whether `key` was inserted, false if the filter is full.
+	 */
+	bool insert(Key const& key) { return insertHash(hash_(key)); }
+
+	/*!
+	 * @brief Inserts `keys` in order until the filter is full.
+	 *
+	 * @return The number of keys inserted.
+	 */
+	size_type insert(Span<Key const> keys)
+	{
+		if (buckets_.empty()) {
+			return 0;
+		}
+
+		std::array<std::uint64_t, BATCH> h;
+		for (size_type i{}; keys.size() > i; i += BATCH) {
+			size_type const n = std::min(BATCH, keys.size() - i);
+			for (size_type j{}; n > j; ++j) {
+				h[j] = hash_(keys[i + j]);
+				prefetchBuckets(h[j]);
+			}
+			for (size_type j{}; n > j; ++j) {
+				if (!insertHash(h[j])) {
+					return i + j;
+				}
+			}
+		}
+		return keys.size();
+	}
+
+	/*!
+	 * @brief Inserts a key by its already computed hash, has to be combined with
+	 * `containsHash` and `eraseHash`.
+	 */
+	bool insertHash(std::uint64_t hash) noexcept
+	{
+		// Once a fingerprint has been left without a slot the filter is considered full
+		if (victim_.used || buckets_.empty()) {
+			return false;
+		}
+		insertFingerprint(index(hash), fingerprint(hash));
+		return true;
+	}
+
+	/*!
+	 * @return False if `key` has definitely not been inserted, true if it might have
+	 * been.
+	 */
+	[[nodiscard]] bool contains(Key const& key) const { return containsHash(hash_(key)); }
+
+	/*!
+	 * @brief Queries all `keys`, `result[i]` is set to `contains(keys[i])`.
+	 */
+	void contains(Span<Key const> keys, Span<bool> result) const
+	{
+		assert(keys.size() <= result.size());
+
+		if (buckets_.empty()) {
+			std::fill(result.begin(), result.begin() + keys.size(), false);
+			return;
+		}
+
+		std::array<size_type, BATCH>   i1;
+		std::array<size_type, BATCH>   i2;
+		std::array<Fingerprint, BATCH> fp;
+		for (size_type i{}; keys.size() > i; i += BATCH) {
+			size_type const n = std::min(BATCH, keys.size() - i);
+			for (size_type j{}; n > j; ++j) {
+				std::uint64_t const h = hash_(keys[i + j]);
+				fp[j]                 = fingerprint(h);
+				i1[j]                 = index(h);
+				i2[j]                 = altIndex(i1[j], fp[j]);
+				prefetch(buckets_.data() + i1[j]);
+				prefetch(buckets_.data() + i2[j]);
+			}
+			for (size_type j{}; n > j; ++j) {
+				result[i + j] = probe(buckets_[i1[j]], buckets_[i2[j]], fp[j]) ||
+				                inVictim(i1[j], i2[j], fp[j]);
+			}
+		}
+	}
+
+	[[nodiscard]] bool containsHash(std::uint64_t hash) const noexcept
+	{
+		if (buckets_.empty()) {
+			return false;
+		}
+
+		Fingerprint const fp = fingerprint(hash);
+		size_type const   i1 = index(hash);
+		size_type const   i2 = altIndex(i1, fp);
+		return probe(buckets_[i1], buckets_[i2], fp) || inVictim(i1, i2, fp);
+	}
+
+	/*!
+	 * @brief Removes one copy of `key`, which has to have been inserted.
+	 *
+	 * @return Whether a matching fingerprint was found and removed.
+	 */
+	bool erase(Key const& key) { return eraseHash(hash_(key)); }
+
+	bool eraseHash(std::uint64_t hash) noexcept
+	{
+		if (buckets_.empty()) {
+			return false;
+		}
+
+		Fingerprint const fp = fingerprint(hash);
+		size_type const   i1 = index(hash);
+		size_type const   i2 = altIndex(i1, fp);
+
+		if (remove(i1, fp) || remove(i2, fp)) {
+			--size_;
+			// There is room now, so give the fingerprint without a slot another try
+			if (victim_.used) {
+				victim_.used = false;
+				--size_;
+				insertFingerprint(victim_.index, victim_.fp);
+			}
+			return true;
+		}
+
+		if (inVictim(i1, i2, fp)) {
+			victim_.used = false;
+			--size_;
+			return true;
+		}
+
+		return false;
+	}
+
+	void clear() noexcept
+	{
+		std::fill(buckets_.begin(), buckets_.end(), Bucket(0));
+		victim_ = Victim{};
+		size_   = 0;
+	}
+
+	/*!
+	 * @brief Number of keys in the filter.
+	 */
+	[[nodiscard]] size_type size() const noexcept { return size_; }
+
+	[[nodiscard]] bool empty() const noexcept { return 0 == size_; }
+
+	/*!
+	 * @brief Number of slots, inserts start failing somewhat before all are used.
+	 */
+	[[nodiscard]] size_type capacity() const noexcept { return buckets_.size() * SLOTS; }
+
+	[[nodiscard]] size_type numBuckets() const noexcept { return buckets_.size(); }
+
+	[[nodiscard]] double loadFactor() const noexcept
+	{
+		return buckets_.empty()
+		           ? 0.0
+		           : static_cast<double>(size_) / static_cast<double>(capacity());
+	}
+
+	/*!
+	 * @brief Expected false positive rate at the current load.
+	 */
+	[[nodiscard]] double falsePositiveRate() const noexcept
+	{
+		// Each occupied slot of the two buckets matches with probability 1 / (2^BITS - 1)
+		double const miss = 1.0 - 1.0 / static_cast<double>(Fingerprint(~0u));
+		return 1.0 - std::pow(miss, 2.0 * SLOTS * loadFactor());
+	}
+
+	/*!
+	 * @brief Number of bytes used for the buckets, excluding the object itself.
+	 */
+	[[nodiscard]] size_type memoryUsage() const noexcept
+	{
+		return buckets_.capacity() * sizeof(Bucket);
+	}
+
+	[[nodiscard]] hasher hash_function() const { return hash_; }
+
+	/*!
+	 * @brief Writes the fingerprint width, the number of buckets and keys, the pending
+	 * victim, and the buckets as is.
+	 *
+	 * The hash function is not stored, the reader has to use the same one.
+	 */
+	void write(WriteBuffer& out) const
+	{
+		out.write(static_cast<std::uint8_t>(BITS));
+		out.write(static_cast<std::uint64_t>(buckets_.size()));
+		out.write(static_cast<std::uint64_t>(size_));
+		out.write(victim_.index);
+		out.write(victim_.fp);
+		out.write(static_cast<std::uint8_t>(victim_.used));
+		if (!buckets_.empty()) {
+			out.write(buckets_.data(), buckets_.size() * sizeof(Bucket));
+		}
+	}
+
+	/*!
+	 * @brief Reads a filter written by `write`.
+	 *
+	 * @throws std::invalid_argument If the stored fingerprint width does not match.
+	 * @throws std::runtime_error If the stored filter is malformed.
+	 * @throws std::out_of_range If `in` does not hold the whole filter.
+	 */
+	void read(ReadBuffer& in)
+	{
+		std::uint8_t  bits;
+		std::uint64_t buckets;
+		std::uint64_t size;
+		Victim        victim;
+		std::uint8_t  used;
+		in.read(bits);
+		if (BITS != bits) {
+			throw std::invalid_argument("CuckooFilter: stored fingerprint width " +
+			                            std::to_string(bits) + " does not match " +
+			                            std::to_string(BITS));
+		}
+		in.read(buckets);
+		in.read(size);
+		in.read(victim.index);
+		in.read(victim.fp);
+		in.read(used);
+		victim.used = 0 != used;
+
+		if (in.readLeft() / sizeof(Bucket) < buckets) {
+			throw std::out_of_range("CuckooFilter: buffer too small for " +
+			                        std::to_string(buckets) + " buckets");
+		}
+		if ((buckets & (buckets - 1)) || (victim.used && victim.index >= buckets) ||
+		    size > buckets * SLOTS + victim.used) {
+			throw std::runtime_error("CuckooFilter: malformed filter");
+		}
+
+		buckets_.assign(static_cast<size_type>(buckets), Bucket(0));
+		if (!buckets_.empty()) {
+			in.read(buckets_.data(), buckets_.size() * sizeof(Bucket));
+		}
+		size_   = static_cast<size_type>(size);
+		victim_ = victim;
+	}
+
+	friend bool operator==(CuckooFilter const& lhs, CuckooFilter const& rhs) noexcept
+	{
+		return lhs.size_ == rhs.size_ && lhs.victim_.used == rhs.victim_.used &&
+		       (!lhs.victim_.used || (lhs.victim_.index == rhs.victim_.index &&
+		                              lhs.victim_.fp == rhs.victim_.fp)) &&
+		       lhs.buckets_ == rhs.buckets_;
+	}
+
+	friend bool operator!=(CuckooFilter const& lhs, CuckooFilter const& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+ private:
+	[[nodiscard]] static Fingerprint fingerprint(std::uint64_t hash) noexcept
+	{
+		// Zero marks an empty slot
+		auto const fp = static_cast<Fingerprint>(hash >> (64 - BITS));
+		return static_cast<Fingerprint>(fp + (0 == fp));
+	}
+
+	[[nodiscard]] size_type index(std::uint64_t hash) const noexcept
+	{
+		return static_cast<size_type>(hash) & (buckets_.size() - 1);
+	}
+
+	/*!
+	 * The other bucket of a fingerprint in bucket `i`, only depends on the fingerprint
+	 * so it can be found without the key when evicting. `altIndex(altIndex(i, fp), fp)`
+	 * is `i`.
+	 */
+	[[nodiscard]] size_type altIndex(size_type i, Fingerprint fp) const noexcept
+	{
+		return (i ^ (static_cast<size_type>(fp) * 0x5BD1E995u)) & (buckets_.size() - 1);
+	}
+
+	void prefetchBuckets(std::uint64_t hash) const noexcept
+	{
+		size_type const i = index(hash);
+		prefetch(buckets_.data() + i);
+		prefetch(buckets_.data() + altIndex(i, fingerprint(hash)));
+	}
+
+	[[nodiscard]] bool inVictim(size_type i1, size_type i2, Fingerprint fp) const noexcept
+	{
+		return victim_.used && fp == victim_.fp &&
+		       (i1 == victim_.index || i2 == victim_.index);
+	}
+
+	// Marks the high bit of the lowest slot that is zero, higher slots may be marked
+	// falsely
+	[[nodiscard]] static constexpr Bucket zeroSlots(Bucket b) noexcept
+	{
+		return (b - LOW) & ~b & HIGH;
+	}
+
+	[[nodiscard]] static bool probe(Bucket b1, Bucket b2, Fingerprint fp) noexcept
+	{
+#if defined(__SSE2__)
+		__m128i const b =
+		    _mm_set_epi64x(static_cast<long long>(b2), static_cast<long long>(b1));
+		if constexpr (1 == sizeof(Fingerprint)) {
+			// The upper half of each 64 bit lane is zero, which never equals `fp`
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(b, _mm_set1_epi8(static_cast<char>(fp))));
+		} else {
+			return _mm_movemask_epi8(
+			    _mm_cmpeq_epi16(b, _mm_set1_epi16(static_cast<short>(fp))));
+		}
+#else
+		Bucket const f = LOW * fp;
+		return zeroSlots(b1 ^ f) | zeroSlots(b2 ^ f);
+#endif
+	}
+
+	[[nodiscard]] static Bucket setSlot(Bucket b, int slot, Fingerprint fp) noexcept
+	{
+		unsigned const shift = static_cast<unsigned>(slot) * BITS;
+		return (b & ~(Bucket(Fingerprint(~0u)) << shift)) | (Bucket(fp) << shift);
+	}
+
+	[[nodiscard]] static Fingerprint getSlot(Bucket b, int slot) noexcept
+	{
+		return static_cast<Fingerprint>(b >> (static_cast<unsigned>(slot) * BITS));
+	}
+
+	bool put(size_type i, Fingerprint fp) noexcept
+	{
+		Bucket const z = zeroSlots(buckets_[i]);
+		if (!z) {
+			return false;
+		}
+		buckets_[i] = setSlot(buckets_[i], countrZero(z) / static_cast<int>(BITS), fp);
+		return true;
+	}
+
+	bool remove(size_type i, Fingerprint fp) noexcept
+	{
+		Bucket const z = zeroSlots(buckets_[i] ^ (LOW * fp));
+		if (!z) {
+			return false;
+		}
+		buckets_[i] = setSlot(buckets_[i], countrZero(z) / static_cast<int>(BITS), 0);
+		return true;
+	}
+
+	void insertFingerprint(size_type i, Fingerprint fp) noexcept
+	{
+		++size_;
+
+		if (put(i, fp) || put(altIndex(i, fp), fp)) {
+			return;
+		}
+
+		// Both buckets are full, evict random fingerprints to their other bucket until
+		// one of them finds a free slot
+		if (random() & 1u) {
+			i = altIndex(i, fp);
+		}
+		for (size_type kick{}; MAX_KICKS != kick; ++kick) {
+			auto const        slot    = static_cast<int>(random() & (SLOTS - 1));
+			Fingerprint const evicted = getSlot(buckets_[i], slot);
+			buckets_[i]               = setSlot(buckets_[i], slot, fp);
+			fp                        = evicted;
+			i                         = altIndex(i, fp);
+			if (put(i, fp)) {
+				return;
+			}
+		}
+
+		// Keep the last evicted fingerprint on the side so there are no false negatives
+		victim_ = Victim{i, fp, true};
+	}
+
+	// xorshift64, only used for picking which fingerprint to evict
+	std::uint64_t random() noexcept
+	{
+		rng_ ^= rng_ << 13;
+		rng_ ^= rng_ >> 7;
+		rng_ ^= rng_ << 17;
+		return rng_;
+	}
+
+ private:
+	AlignedVector<Bucket> buckets_;
+	size_type             size_{};
+	Victim                victim_;
+	std::uint64_t         rng_ = 0x9E3779B97F4A7C15u;
+	HashFn                hash_;
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_CUCKOO_FILTER_HPP
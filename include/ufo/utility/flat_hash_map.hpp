@@ -0,0 +1,774 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_FLAT_HASH_MAP_HPP
+#define UFO_UTILITY_FLAT_HASH_MAP_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/hash.hpp>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace ufo
+{
+namespace detail
+{
+using ctrl_t = std::int8_t;
+
+// Control bytes: a full slot stores the 7 low bits of its hash (non-negative), the
+// special states are negative
+inline constexpr ctrl_t CTRL_EMPTY   = -128;
+inline constexpr ctrl_t CTRL_DELETED = -2;
+
+#if defined(__SSE2__) || defined(_M_X64)
+/*!
+ * @brief The control bytes of 16 consecutive slots, matched with SSE2.
+ */
+class Group
+{
+ public:
+	static constexpr std::size_t WIDTH = 16;
+
+	explicit Group(ctrl_t const* ctrl) noexcept
+	    : ctrl_(_mm_loadu_si128(reinterpret_cast<__m128i const*>(ctrl)))
+	{
+	}
+
+	[[nodiscard]] std::uint32_t match(ctrl_t h2) const noexcept
+	{
+		return static_cast<std::uint32_t>(
+		    _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+	}
+
+	[[nodiscard]] std::uint32_t matchEmpty() const noexcept { return match(CTRL_EMPTY); }
+
+	[[nodiscard]] std::uint32_t matchEmptyOrDeleted() const noexcept
+	{
+		// Both are smaller than -1, full slots are not
+		return static_cast<std::uint32_t>(
+		    _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl_)));
+	}
+
+ private:
+	__m128i ctrl_;
+};
+#else
+/*!
+ * @brief The control bytes of 8 consecutive slots, matched with scalar code.
+ */
+class Group
+{
+ public:
+	static constexpr std::size_t WIDTH = 8;
+
+	explicit Group(ctrl_t const* ctrl) noexcept { std::memcpy(ctrl_, ctrl, WIDTH); }
+
+	[[nodiscard]] std::uint32_t match(ctrl_t h2) const noexcept
+	{
+		std::uint32_t m{};
+		for (std::size_t i{}; WIDTH != i; ++i) {
+			m |= std::uint32_t(h2 == ctrl_[i]) << i;
+		}
+		return m;
+	}
+
+	[[nodiscard]] std::uint32_t matchEmpty() const noexcept { return match(CTRL_EMPTY); }
+
+	[[nodiscard]] std::uint32_t matchEmptyOrDeleted() const noexcept
+	{
+		std::uint32_t m{};
+		for (std::size_t i{}; WIDTH != i; ++i) {
+			m |= std::uint32_t(-1 > ctrl_[i]) << i;
+		}
+		return m;
+	}
+
+ private:
+	ctrl_t ctrl_[WIDTH];
+};
+#endif
+
+/*!
+ * @brief Open addressing hash table with SwissTable style group probing.
+ *
+ * Each slot has a control byte holding 7 bits of its hash, kept in a separate array.
+ * Lookups compare the control bytes of a whole group of slots at once and only touch
+ * the slots whose 7 bits match, so in practice a lookup is one or two cache misses.
+ *
+ * The capacity is a power of two (at least one group) and the maximum load factor
+ * 7/8. The first group of control bytes is mirrored after the last one, so groups can
+ * be loaded at any position without wrapping.
+ */
+template <class Key, class Value, class KeyOf, class HashFn, class KeyEqual>
+class FlatHashTable
+{
+	static constexpr std::size_t WIDTH = Group::WIDTH;
+
+ public:
+	using key_type        = Key;
+	using value_type      = Value;
+	using size_type       = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using hasher          = HashFn;
+	using key_equal       = KeyEqual;
+	using reference       = value_type&;
+	using const_reference = value_type const&;
+
+	template <bool Const>
+	class Iterator
+	{
+		friend class FlatHashTable;
+
+	 public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = Value;
+		using difference_type   = std::ptrdiff_t;
+		using pointer   = std::conditional_t<Const, Value const*, Value*>;
+		using reference = std::conditional_t<Const, Value const&, Value&>;
+
+		Iterator() = default;
+
+		template <bool C, std::enable_if_t<Const && !C, bool> = true>
+		Iterator(Iterator<C> const& other) noexcept
+		    : ctrl_(other.ctrl_), end_(other.end_), slot_(other.slot_)
+		{
+		}
+
+		Iterator& operator++() noexcept
+		{
+			++ctrl_;
+			++slot_;
+			skipEmpty();
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		[[nodiscard]] reference operator*() const noexcept { return *slot_; }
+
+		[[nodiscard]] pointer operator->() const noexcept { return slot_; }
+
+		template <bool C>
+		[[nodiscard]] bool operator==(Iterator<C> const& rhs) const noexcept
+		{
+			return ctrl_ == rhs.ctrl_;
+		}
+
+		template <bool C>
+		[[nodiscard]] bool operator!=(Iterator<C> const& rhs) const noexcept
+		{
+			return ctrl_ != rhs.ctrl_;
+		}
+
+	 private:
+		Iterator(ctrl_t const* ctrl, ctrl_t const* end, pointer slot) noexcept
+		    : ctrl_(ctrl), end_(end), slot_(slot)
+		{
+		}
+
+		void skipEmpty() noexcept
+		{
+			for (; end_ != ctrl_ && 0 > *ctrl_; ++ctrl_, ++slot_) {
+			}
+		}
+
+	 private:
+		template <bool>
+		friend class Iterator;
+
+		ctrl_t const* ctrl_{};
+		ctrl_t const* end_{};
+		pointer       slot_{};
+	};
+
+	using iterator       = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	FlatHashTable() = default;
+
+	explicit FlatHashTable(size_type bucket_count, HashFn const& hash = HashFn(),
+	                       KeyEqual const& equal = KeyEqual())
+	    : hash_(hash), equal_(equal)
+	{
+		reserve(bucket_count);
+	}
+
+	FlatHashTable(FlatHashTable const& other)
+	    : hash_(other.hash_), equal_(other.equal_)
+	{
+		reserve(other.size());
+		for (auto const& v : other) {
+			insertUnique(v);
+		}
+	}
+
+	FlatHashTable(FlatHashTable&& other) noexcept
+	    : ctrl_(std::exchange(other.ctrl_, nullptr))
+	    , slots_(std::exchange(other.slots_, nullptr))
+	    , capacity_(std::exchange(other.capacity_, 0))
+	    , size_(std::exchange(other.size_, 0))
+	    , growth_left_(std::exchange(other.growth_left_, 0))
+	    , hash_(std::move(other.hash_))
+	    , equal_(std::move(other.equal_))
+	{
+	}
+
+	~FlatHashTable() { destroy(); }
+
+	FlatHashTable& operator=(FlatHashTable const& rhs)
+	{
+		if (this != &rhs) {
+			FlatHashTable tmp(rhs);
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	FlatHashTable& operator=(FlatHashTable&& rhs) noexcept
+	{
+		FlatHashTable tmp(std::move(rhs));
+		swap(tmp);
+		return *this;
+	}
+
+	[[nodiscard]] iterator begin() noexcept
+	{
+		iterator it(ctrl_, ctrl_ + capacity_, slots_);
+		it.skipEmpty();
+		return it;
+	}
+
+	[[nodiscard]] const_iterator begin() const noexcept { return cbegin(); }
+
+	[[nodiscard]] const_iterator cbegin() const noexcept
+	{
+		const_iterator it(ctrl_, ctrl_ + capacity_, slots_);
+		it.skipEmpty();
+		return it;
+	}
+
+	[[nodiscard]] iterator end() noexcept
+	{
+		return iterator(ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_);
+	}
+
+	[[nodiscard]] const_iterator end() const noexcept { return cend(); }
+
+	[[nodiscard]] const_iterator cend() const noexcept
+	{
+		return const_iterator(ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_);
+	}
+
+	[[nodiscard]] bool empty() const noexcept { return 0 == size_; }
+
+	[[nodiscard]] size_type size() const noexcept { return size_; }
+
+	/*!
+	 * @brief Number of slots.
+	 */
+	[[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+
+	[[nodiscard]] float load_factor() const noexcept
+	{
+		return 0 == capacity_ ? 0.0f : static_cast<float>(size_) / capacity_;
+	}
+
+	[[nodiscard]] static constexpr float max_load_factor() noexcept { return 0.875f; }
+
+	/*!
+	 * @brief Makes room for `count` elements without rehashing.
+	 */
+	void reserve(size_type count)
+	{
+		if (count > size_ + growth_left_) {
+			rehash(count);
+		}
+	}
+
+	/*!
+	 * @brief Rebuilds the table with room for at least `count` (and all current)
+	 * elements, also dropping all tombstones of erased elements.
+	 */
+	void rehash(size_type count)
+	{
+		count = std::max(count, size_);
+		if (0 == count) {
+			FlatHashTable tmp(std::move(*this));
+			return;
+		}
+		resize(bitCeil(std::max(WIDTH, count + (count + 6) / 7)));
+	}
+
+	void clear() noexcept
+	{
+		destroyElements();
+		if (0 != capacity_) {
+			std::fill_n(ctrl_, capacity_ + WIDTH, CTRL_EMPTY);
+			growth_left_ = maxSize(capacity_);
+		}
+	}
+
+	size_type erase(Key const& key)
+	{
+		size_type const i = findIndex(key, hash_(key));
+		if (capacity_ == i) {
+			return 0;
+		}
+		eraseAt(i);
+		return 1;
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		size_type const i = static_cast<size_type>(pos.ctrl_ - ctrl_);
+		eraseAt(i);
+		iterator it(ctrl_ + i, ctrl_ + capacity_, slots_ + i);
+		it.skipEmpty();
+		return it;
+	}
+
+	iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+	void swap(FlatHashTable& other) noexcept
+	{
+		using std::swap;
+		swap(ctrl_, other.ctrl_);
+		swap(slots_, other.slots_);
+		swap(capacity_, other.capacity_);
+		swap(size_, other.size_);
+		swap(growth_left_, other.growth_left_);
+		swap(hash_, other.hash_);
+		swap(equal_, other.equal_);
+	}
+
+	[[nodiscard]] iterator find(Key const& key)
+	{
+		size_type const i = findIndex(key, hash_(key));
+		return iterator(ctrl_ + i, ctrl_ + capacity_, slots_ + i);
+	}
+
+	[[nodiscard]] const_iterator find(Key const& key) const
+	{
+		size_type const i = findIndex(key, hash_(key));
+		return const_iterator(ctrl_ + i, ctrl_ + capacity_, slots_ + i);
+	}
+
+	[[nodiscard]] bool contains(Key const& key) const
+	{
+		return capacity_ != findIndex(key, hash_(key));
+	}
+
+	[[nodiscard]] size_type count(Key const& key) const { return contains(key) ? 1 : 0; }
+
+	[[nodiscard]] hasher hash_function() const { return hash_; }
+
+	[[nodiscard]] key_equal key_eq() const { return equal_; }
+
+ protected:
+	/*!
+	 * @brief Finds `key`, or inserts a `Value` constructed from `args` if not present.
+	 */
+	template <class... Args>
+	std::pair<iterator, bool> tryEmplace(Key const& key, Args&&... args)
+	{
+		std::size_t const hash = hash_(key);
+		size_type         i    = findIndex(key, hash);
+		if (capacity_ != i) {
+			return {iterator(ctrl_ + i, ctrl_ + capacity_, slots_ + i), false};
+		}
+
+		i = prepareInsert(hash);
+		::new (static_cast<void*>(slots_ + i)) Value(std::forward<Args>(args)...);
+		commitInsert(i, hash);
+		return {iterator(ctrl_ + i, ctrl_ + capacity_, slots_ + i), true};
+	}
+
+ private:
+	[[nodiscard]] static constexpr size_type maxSize(size_type capacity) noexcept
+	{
+		return capacity - capacity / 8;
+	}
+
+	[[nodiscard]] static constexpr ctrl_t h2(std::size_t hash) noexcept
+	{
+		return static_cast<ctrl_t>(hash & 0x7F);
+	}
+
+	[[nodiscard]] size_type findIndex(Key const& key, std::size_t hash) const
+	{
+		if (0 == capacity_) {
+			return 0;
+		}
+
+		size_type const mask = capacity_ - 1;
+		size_type       pos  = (hash >> 7) & mask;
+		for (size_type step{};;) {
+			Group const g(ctrl_ + pos);
+			for (std::uint32_t m = g.match(h2(hash)); 0 != m; m &= m - 1) {
+				size_type const i = (pos + countrZero(m)) & mask;
+				if (equal_(KeyOf{}(slots_[i]), key)) {
+					return i;
+				}
+			}
+			if (g.matchEmpty()) {
+				return capacity_;
+			}
+			// Triangular probing over groups visits every group once
+			step += WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	/*!
+	 * @brief Returns the first empty or deleted slot in the probe sequence of `hash`.
+	 */
+	[[nodiscard]] size_type findInsertIndex(std::size_t hash) const noexcept
+	{
+		size_type const mask = capacity_ - 1;
+		size_type       pos  = (hash >> 7) & mask;
+		for (size_type step{};;) {
+			if (std::uint32_t const m = Group(ctrl_ + pos).matchEmptyOrDeleted()) {
+				return (pos + countrZero(m)) & mask;
+			}
+			step += WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	[[nodiscard]] size_type prepareInsert(std::size_t hash)
+	{
+		if (0 == capacity_) {
+			resize(WIDTH);
+		}
+
+		size_type i = findInsertIndex(hash);
+		if (0 == growth_left_ && CTRL_DELETED != ctrl_[i]) {
+			// Mostly tombstones: clean up in place, otherwise grow
+			resize(size_ <= maxSize(capacity_) / 2 ? capacity_ : 2 * capacity_);
+			i = findInsertIndex(hash);
+		}
+		return i;
+	}
+
+	/*!
+	 * @brief Marks slot `i`, returned by `prepareInsert` and now holding a value, as
+	 * full.
+	 */
+	void commitInsert(size_type i, std::size_t hash) noexcept
+	{
+		if (CTRL_EMPTY == ctrl_[i]) {
+			--growth_left_;
+		}
+		setCtrl(i, h2(hash));
+		++size_;
+	}
+
+	void setCtrl(size_type i, ctrl_t h) noexcept
+	{
+		ctrl_[i] = h;
+		if (WIDTH > i) {
+			ctrl_[capacity_ + i] = h;
+		}
+	}
+
+	void eraseAt(size_type i)
+	{
+		std::destroy_at(slots_ + i);
+		setCtrl(i, CTRL_DELETED);
+		--size_;
+	}
+
+	/*!
+	 * @brief Inserts `v`, which is known not to be in the table.
+	 */
+	template <class V>
+	void insertUnique(V&& v)
+	{
+		std::size_t const hash = hash_(KeyOf{}(v));
+		size_type const   i    = prepareInsert(hash);
+		::new (static_cast<void*>(slots_ + i)) Value(std::forward<V>(v));
+		commitInsert(i, hash);
+	}
+
+	void resize(size_type capacity)
+	{
+		// Copies the functors, so they need not be default constructible
+		FlatHashTable tmp(0, hash_, equal_);
+		tmp.ctrl_        = new ctrl_t[capacity + WIDTH];
+		tmp.slots_       = std::allocator<Value>{}.allocate(capacity);
+		tmp.capacity_    = capacity;
+		tmp.growth_left_ = maxSize(capacity);
+		std::fill_n(tmp.ctrl_, capacity + WIDTH, CTRL_EMPTY);
+
+		for (size_type i{}; capacity_ != i; ++i) {
+			if (0 <= ctrl_[i]) {
+				tmp.insertUnique(std::move(slots_[i]));
+				std::destroy_at(slots_ + i);
+				ctrl_[i] = CTRL_EMPTY;
+				--size_;
+			}
+		}
+
+		swap(tmp);
+	}
+
+	void destroyElements() noexcept
+	{
+		if constexpr (!std::is_trivially_destructible_v<Value>) {
+			for (size_type i{}; capacity_ != i; ++i) {
+				if (0 <= ctrl_[i]) {
+					std::destroy_at(slots_ + i);
+				}
+			}
+		}
+		size_ = 0;
+	}
+
+	void destroy() noexcept
+	{
+		if (0 == capacity_) {
+			return;
+		}
+		destroyElements();
+		std::allocator<Value>{}.deallocate(slots_, capacity_);
+		delete[] ctrl_;
+		ctrl_        = nullptr;
+		slots_       = nullptr;
+		capacity_    = 0;
+		growth_left_ = 0;
+	}
+
+ private:
+	ctrl_t*   ctrl_{};
+	Value*    slots_{};
+	size_type capacity_{};
+	size_type size_{};
+	size_type growth_left_{};
+
+	HashFn    hash_{};
+	KeyEqual  equal_{};
+};
+
+struct FlatSetKeyOf {
+	template <class T>
+	[[nodiscard]] constexpr T const& operator()(T const& v) const noexcept
+	{
+		return v;
+	}
+};
+
+struct FlatMapKeyOf {
+	template <class T>
+	[[nodiscard]] constexpr auto const& operator()(T const& v) const noexcept
+	{
+		return v.first;
+	}
+};
+}  // namespace detail
+
+/*!
+ * @brief Open addressing hash map storing its elements inline, for small keys such as
+ * voxel keys and Morton codes.
+ *
+ * A drop-in for the common subset of `std::unordered_map`, but iterators and
+ * references are invalidated by rehashing (i.e., by any insertion that grows the
+ * table) and there is no bucket interface.
+ *
+ * Uses `ufo::Hash` by default, which mixes integer keys so structured keys do not
+ * collide.
+ */
+template <class Key, class T, class HashFn = Hash<Key>,
+          class KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+    : public detail::FlatHashTable<Key, std::pair<Key const, T>, detail::FlatMapKeyOf,
+                                   HashFn, KeyEqual>
+{
+	using Base = detail::FlatHashTable<Key, std::pair<Key const, T>, detail::FlatMapKeyOf,
+	                                   HashFn, KeyEqual>;
+
+ public:
+	using mapped_type = T;
+	using typename Base::const_iterator;
+	using typename Base::iterator;
+	using typename Base::size_type;
+	using typename Base::value_type;
+
+	using Base::Base;
+
+	FlatHashMap() = default;
+
+	FlatHashMap(std::initializer_list<value_type> init)
+	{
+		Base::reserve(init.size());
+		insert(init.begin(), init.end());
+	}
+
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(Key const& key, Args&&... args)
+	{
+		return Base::tryEmplace(key, std::piecewise_construct, std::forward_as_tuple(key),
+		                        std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	std::pair<iterator, bool> insert(value_type const& value)
+	{
+		return Base::tryEmplace(value.first, value);
+	}
+
+	std::pair<iterator, bool> insert(value_type&& value)
+	{
+		return Base::tryEmplace(value.first, std::move(value));
+	}
+
+	template <class InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+
+	template <class K, class V>
+	std::pair<iterator, bool> emplace(K&& key, V&& value)
+	{
+		return try_emplace(std::forward<K>(key), std::forward<V>(value));
+	}
+
+	template <class M>
+	std::pair<iterator, bool> insert_or_assign(Key const& key, M&& value)
+	{
+		auto res = try_emplace(key, std::forward<M>(value));
+		if (!res.second) {
+			res.first->second = std::forward<M>(value);
+		}
+		return res;
+	}
+
+	T& operator[](Key const& key) { return try_emplace(key).first->second; }
+
+	[[nodiscard]] T& at(Key const& key)
+	{
+		auto it = Base::find(key);
+		if (Base::end() == it) {
+			throw std::out_of_range("FlatHashMap::at: key not found");
+		}
+		return it->second;
+	}
+
+	[[nodiscard]] T const& at(Key const& key) const
+	{
+		auto it = Base::find(key);
+		if (Base::end() == it) {
+			throw std::out_of_range("FlatHashMap::at: key not found");
+		}
+		return it->second;
+	}
+};
+
+/*!
+ * @brief Open addressing hash set storing its elements inline, see `FlatHashMap`.
+ */
+template <class Key, class HashFn = Hash<Key>, class KeyEqual = std::equal_to<Key>>
+class FlatHashSet
+    : public detail::FlatHashTable<Key, Key, detail::FlatSetKeyOf, HashFn, KeyEqual>
+{
+	using Base = detail::FlatHashTable<Key, Key, detail::FlatSetKeyOf, HashFn, KeyEqual>;
+
+ public:
+	using typename Base::iterator;
+	using typename Base::value_type;
+
+	using Base::Base;
+
+	FlatHashSet() = default;
+
+	FlatHashSet(std::initializer_list<Key> init)
+	{
+		Base::reserve(init.size());
+		insert(init.begin(), init.end());
+	}
+
+	std::pair<iterator, bool> insert(Key const& key) { return Base::tryEmplace(key, key); }
+
+	std::pair<iterator, bool> insert(Key&& key)
+	{
+		return Base::tryEmplace(key, std::move(key));
+	}
+
+	template <class InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+
+	template <class... Args>
+	std::pair<iterator, bool> emplace(Args&&... args)
+	{
+		return insert(Key(std::forward<Args>(args)...));
+	}
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_FLAT_HASH_MAP_HPP
@@ -0,0 +1,114 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_FUTEX_HPP
+#define UFO_UTILITY_FUTEX_HPP
+
+// STL
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#if !(defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L) && \
+    defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Blocks the calling thread as long as `word` holds `expected`.
+ *
+ * Uses `std::atomic::wait` since C++20, the futex system call on Linux before that,
+ * and falls back to yielding elsewhere. As with the underlying primitives, the call
+ * may return spuriously, so it should always be used in a loop re-checking the
+ * condition.
+ */
+inline void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept
+{
+#if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+	word.wait(expected, std::memory_order_relaxed);
+#elif defined(__linux__)
+	static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+	syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE,
+	        expected, nullptr, nullptr, 0);
+#else
+	if (word.load(std::memory_order_relaxed) == expected) {
+		std::this_thread::yield();
+	}
+#endif
+}
+
+/*!
+ * @brief Wakes up one thread blocked in `futexWait` on `word`.
+ */
+inline void futexWakeOne(std::atomic<std::uint32_t>& word) noexcept
+{
+#if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+	word.notify_one();
+#elif defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1,
+	        nullptr, nullptr, 0);
+#else
+	(void)word;
+#endif
+}
+
+/*!
+ * @brief Wakes up all threads blocked in `futexWait` on `word`.
+ */
+inline void futexWakeAll(std::atomic<std::uint32_t>& word) noexcept
+{
+#if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+	word.notify_all();
+#elif defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE,
+	        INT_MAX, nullptr, nullptr, 0);
+#else
+	(void)word;
+#endif
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_FUTEX_HPP
\ No newline at end of file
@@ -0,0 +1,410 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_HASH_HPP
+#define UFO_UTILITY_HASH_HPP
+
+// UFO
+#include <ufo/utility/type_traits.hpp>
+
+// STL
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace ufo
+{
+/*!
+ * @brief Mixes the bits of `x` such that every input bit affects every output bit.
+ *
+ * The finalizer of SplitMix64. Used to turn integers with structure in their bits,
+ * such as Morton codes or voxel keys whose low bits barely change between neighbours,
+ * into well-distributed hashes: open addressing tables take their bucket from some
+ * bits and other metadata from others, so all bits have to be good.
+ */
+[[nodiscard]] constexpr std::uint64_t hashMix(std::uint64_t x) noexcept
+{
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9u;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBu;
+	x ^= x >> 31;
+	return x;
+}
+
+/*!
+ * @brief Combines the hash `h` into `seed`.
+ */
+[[nodiscard]] constexpr std::uint64_t hashCombine(std::uint64_t seed,
+                                                  std::uint64_t h) noexcept
+{
+	return hashMix(seed + 0x9E3779B97F4A7C15u + h);
+}
+
+/*!
+ * @brief Hash function with well-mixed output, default for the hash tables of this
+ * library.
+ *
+ * Integers, enums and pointers are hashed with `hashMix`; other types are hashed with
+ * `std::hash` and the result mixed, as `std::hash` is the identity for integers on
+ * common standard libraries.
+ */
+template <class T, class = void>
+struct Hash {
+	[[nodiscard]] std::size_t operator()(T const& x) const
+	    noexcept(noexcept(std::hash<T>{}(x)))
+	{
+		return static_cast<std::size_t>(hashMix(std::hash<T>{}(x)));
+	}
+};
+
+template <class T>
+struct Hash<T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>> {
+	[[nodiscard]] constexpr std::size_t operator()(T x) const noexcept
+	{
+		return static_cast<std::size_t>(hashMix(static_cast<std::uint64_t>(x)));
+	}
+};
+
+template <class T>
+struct Hash<T*> {
+	[[nodiscard]] std::size_t operator()(T const* x) const noexcept
+	{
+		return static_cast<std::size_t>(hashMix(reinterpret_cast<std::uintptr_t>(x)));
+	}
+};
+
+//
+// Bytes
+//
+
+namespace detail
+{
+inline constexpr std::array<std::uint64_t, 4> HASH_SECRET{
+    0x2D358DCCAA6C78A5u, 0x8BB84B93962EACC9u, 0x4B33A62ED433D4A3u, 0x4D5A2DA51DE1AA47u};
+
+// Full 64x64 -> 128 bit multiplication, low half in `a` and high half in `b`
+inline void hashMum(std::uint64_t& a, std::uint64_t& b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+	__extension__ using UInt128 = unsigned __int128;
+	UInt128 const r = static_cast<UInt128>(a) * b;
+	a               = static_cast<std::uint64_t>(r);
+	b               = static_cast<std::uint64_t>(r >> 64);
+#else
+	std::uint64_t const ha = a >> 32, la = a & 0xFFFFFFFF;
+	std::uint64_t const hb = b >> 32, lb = b & 0xFFFFFFFF;
+	std::uint64_t const rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	std::uint64_t const t  = rl + (rm0 << 32);
+	std::uint64_t const lo = t + (rm1 << 32);
+	b                      = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+	a                      = lo;
+#endif
+}
+
+// Folds the 128 bit product of `a` and `b` into 64 bits
+[[nodiscard]] inline std::uint64_t hashMumXor(std::uint64_t a, std::uint64_t b) noexcept
+{
+	hashMum(a, b);
+	return a ^ b;
+}
+
+[[nodiscard]] inline std::uint64_t hashRead8(unsigned char const* p) noexcept
+{
+	std::uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+[[nodiscard]] inline std::uint64_t hashRead4(unsigned char const* p) noexcept
+{
+	std::uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// Up to 3 bytes, reads each byte at least once without branching on the length
+[[nodiscard]] inline std::uint64_t hashRead3(unsigned char const* p,
+                                             std::size_t          k) noexcept
+{
+	return (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[k >> 1]) << 8) | p[k - 1];
+}
+
+// Consumes 48 bytes with three independent multiply chains
+inline void hashBlock(unsigned char const* p, std::uint64_t& seed, std::uint64_t& see1,
+                      std::uint64_t& see2) noexcept
+{
+	seed = hashMumXor(hashRead8(p) ^ HASH_SECRET[1], hashRead8(p + 8) ^ seed);
+	see1 = hashMumXor(hashRead8(p + 16) ^ HASH_SECRET[2], hashRead8(p + 24) ^ see1);
+	see2 = hashMumXor(hashRead8(p + 32) ^ HASH_SECRET[3], hashRead8(p + 40) ^ see2);
+}
+
+// Inputs of at most 16 bytes
+inline void hashShort(unsigned char const* p, std::size_t len, std::uint64_t& a,
+                      std::uint64_t& b) noexcept
+{
+	if (4 <= len) {
+		std::size_t const off = (len >> 3) << 2;
+		a = (hashRead4(p) << 32) | hashRead4(p + off);
+		b = (hashRead4(p + len - 4) << 32) | hashRead4(p + len - 4 - off);
+	} else if (0 < len) {
+		a = hashRead3(p, len);
+		b = 0;
+	} else {
+		a = 0;
+		b = 0;
+	}
+}
+
+// Less than 48 bytes remaining of an input longer than 16 bytes. The 16 bytes before
+// `p` have to be readable if `16 > len`.
+inline void hashTail(unsigned char const* p, std::size_t len, std::uint64_t& seed,
+                     std::uint64_t& a, std::uint64_t& b) noexcept
+{
+	for (; 16 < len; len -= 16, p += 16) {
+		seed = hashMumXor(hashRead8(p) ^ HASH_SECRET[1], hashRead8(p + 8) ^ seed);
+	}
+	// The last 16 bytes, which may overlap with bytes already consumed
+	a = hashRead8(p + len - 16);
+	b = hashRead8(p + len - 8);
+}
+
+[[nodiscard]] inline std::uint64_t hashFinal(std::uint64_t a, std::uint64_t b,
+                                             std::uint64_t seed, std::size_t len) noexcept
+{
+	a ^= HASH_SECRET[1];
+	b ^= seed;
+	hashMum(a, b);
+	return hashMumXor(a ^ HASH_SECRET[0] ^ len, b ^ HASH_SECRET[1]);
+}
+
+[[nodiscard]] inline std::uint64_t hashSeed(std::uint64_t seed) noexcept
+{
+	return seed ^ hashMumXor(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+}
+}  // namespace detail
+
+/*!
+ * @brief Hashes `len` bytes starting at `data`.
+ *
+ * Follows the construction of wyhash (final version 4): 48-byte blocks are consumed
+ * by three independent 64x64 -> 128 bit multiply chains, and inputs of up to 16 bytes
+ * take a single multiplication, so short keys are cheap. Not cryptographic, but passes
+ * SMHasher and is much faster than a byte-wise hash on large inputs.
+ *
+ * Gives the same result as feeding the bytes to `Hasher` in any number of pieces.
+ */
+[[nodiscard]] inline std::uint64_t hashBytes(void const* data, std::size_t len,
+                                             std::uint64_t seed = 0) noexcept
+{
+	auto const* p = static_cast<unsigned char const*>(data);
+	seed          = detail::hashSeed(seed);
+
+	std::uint64_t a;
+	std::uint64_t b;
+	if (16 >= len) {
+		detail::hashShort(p, len, a, b);
+	} else {
+		std::size_t i = len;
+		if (48 <= i) {
+			std::uint64_t see1 = seed;
+			std::uint64_t see2 = seed;
+			do {
+				detail::hashBlock(p, seed, see1, see2);
+				p += 48;
+				i -= 48;
+			} while (48 <= i);
+			seed ^= see1 ^ see2;
+		}
+		detail::hashTail(p, i, seed, a, b);
+	}
+
+	return detail::hashFinal(a, b, seed, len);
+}
+
+[[nodiscard]] inline std::uint64_t hashBytes(std::string_view str,
+                                             std::uint64_t    seed = 0) noexcept
+{
+	return hashBytes(str.data(), str.size(), seed);
+}
+
+/*!
+ * @brief Incremental version of `hashBytes`, for data that arrives in pieces.
+ *
+ * `update` can be called any number of times with pieces of any size, `digest`
+ * returns the same hash as `hashBytes` over all bytes passed so far.
+ */
+class Hasher
+{
+	static constexpr std::size_t BLOCK   = 48;
+	static constexpr std::size_t HISTORY = 16;
+
+ public:
+	explicit Hasher(std::uint64_t seed = 0) noexcept
+	    : seed_(detail::hashSeed(seed)), see1_(seed_), see2_(seed_)
+	{
+	}
+
+	Hasher& update(void const* data, std::size_t len) noexcept
+	{
+		auto const* p = static_cast<unsigned char const*>(data);
+		len_ += len;
+
+		// A block is only consumed once it is known not to be the last one, as
+		// `hashBytes` treats the final bytes differently
+		if (pending_ && BLOCK - pending_ < len) {
+			std::size_t const n = BLOCK - pending_;
+			std::memcpy(buf_.data() + HISTORY + pending_, p, n);
+			p += n;
+			len -= n;
+			detail::hashBlock(buf_.data() + HISTORY, seed_, see1_, see2_);
+			std::memcpy(buf_.data(), buf_.data() + BLOCK, HISTORY);
+			pending_ = 0;
+		}
+
+		if (BLOCK < len) {
+			do {
+				detail::hashBlock(p, seed_, see1_, see2_);
+				p += BLOCK;
+				len -= BLOCK;
+			} while (BLOCK < len);
+			std::memcpy(buf_.data(), p - HISTORY, HISTORY);
+		}
+
+		std::memcpy(buf_.data() + HISTORY + pending_, p, len);
+		pending_ += len;
+		return *this;
+	}
+
+	Hasher& update(std::string_view str) noexcept
+	{
+		return update(str.data(), str.size());
+	}
+
+	[[nodiscard]] std::uint64_t digest() const noexcept
+	{
+		unsigned char const* p    = buf_.data() + HISTORY;
+		std::uint64_t        seed = seed_;
+		std::uint64_t        a;
+		std::uint64_t        b;
+		if (16 >= len_) {
+			detail::hashShort(p, len_, a, b);
+		} else {
+			std::size_t i = pending_;
+			if (48 <= len_) {
+				std::uint64_t see1 = see1_;
+				std::uint64_t see2 = see2_;
+				if (BLOCK == i) {
+					detail::hashBlock(p, seed, see1, see2);
+					p += BLOCK;
+					i = 0;
+				}
+				seed ^= see1 ^ see2;
+			}
+			detail::hashTail(p, i, seed, a, b);
+		}
+		return detail::hashFinal(a, b, seed, len_);
+	}
+
+	void reset(std::uint64_t seed = 0) noexcept { *this = Hasher(seed); }
+
+	[[nodiscard]] std::size_t size() const noexcept { return len_; }
+
+ private:
+	std::uint64_t seed_;
+	std::uint64_t see1_;
+	std::uint64_t see2_;
+	// The last 16 bytes consumed followed by the pending bytes
+	std::array<unsigned char, HISTORY + BLOCK> buf_{};
+	std::size_t                                pending_{};
+	std::size_t                                len_{};
+};
+
+//
+// Tuples
+//
+
+/*!
+ * @brief Hashes `xs` with `Hash` and combines the results.
+ */
+template <class... Ts>
+[[nodiscard]] std::uint64_t hashValues(Ts const&... xs)
+{
+	std::uint64_t seed{};
+	((seed = hashCombine(seed, Hash<Ts>{}(xs))), ...);
+	return seed;
+}
+
+template <class T>
+struct Hash<T, std::enable_if_t<is_tuple_v<T> || is_pair_v<T>>> {
+	[[nodiscard]] std::size_t operator()(T const& x) const
+	{
+		return static_cast<std::size_t>(
+		    std::apply([](auto const&... xs) { return hashValues(xs...); }, x));
+	}
+};
+
+template <class CharT, class Traits, class Allocator>
+struct Hash<std::basic_string<CharT, Traits, Allocator>> {
+	[[nodiscard]] std::size_t operator()(
+	    std::basic_string<CharT, Traits, Allocator> const& x) const noexcept
+	{
+		return static_cast<std::size_t>(hashBytes(x.data(), x.size() * sizeof(CharT)));
+	}
+};
+
+template <class CharT, class Traits>
+struct Hash<std::basic_string_view<CharT, Traits>> {
+	[[nodiscard]] std::size_t operator()(
+	    std::basic_string_view<CharT, Traits> x) const noexcept
+	{
+		return static_cast<std::size_t>(hashBytes(x.data(), x.size() * sizeof(CharT)));
+	}
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_HASH_HPP
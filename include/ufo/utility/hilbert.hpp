@@ -0,0 +1,350 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_HILBERT_HPP
+#define UFO_UTILITY_HILBERT_HPP
+
+// UFO
+#include <ufo/utility/morton.hpp>
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace ufo
+{
+namespace detail
+{
+// J. Skilling, "Programming the Hilbert curve", AIP Conference Proceedings 707, 2004.
+//
+// The Hilbert index is computed in "transposed" form, where the `Dim` words together
+// hold the bits of the index: bit `l` of `x[0]`, `x[1]`, ..., `x[Dim - 1]` are bits
+// `l * Dim + Dim - 1`, ..., `l * Dim` of the index. The (in)versions and exchanges are
+// done with masks instead of branches, since the branches are unpredictable.
+
+template <class Coord, std::size_t Dim>
+constexpr void hilbertAxesToTranspose(std::array<Coord, Dim>& x, unsigned levels) noexcept
+{
+	for (unsigned l = levels - 1; 0 < l; --l) {
+		Coord const p = (Coord(1) << l) - 1;
+		for (std::size_t i{}; Dim != i; ++i) {
+			Coord const invert = Coord(0) - ((x[i] >> l) & Coord(1));
+			Coord const t      = (x[0] ^ x[i]) & p & ~invert;
+			x[0] ^= (p & invert) | t;
+			x[i] ^= t;
+		}
+	}
+
+	// Gray encode
+	for (std::size_t i = 1; Dim != i; ++i) {
+		x[i] ^= x[i - 1];
+	}
+	Coord t{};
+	for (unsigned l = levels - 1; 0 < l; --l) {
+		t ^= ((Coord(1) << l) - 1) & (Coord(0) - ((x[Dim - 1] >> l) & Coord(1)));
+	}
+	for (auto& e : x) {
+		e ^= t;
+	}
+}
+
+template <class Coord, std::size_t Dim>
+constexpr void hilbertTransposeToAxes(std::array<Coord, Dim>& x, unsigned levels) noexcept
+{
+	// Gray decode
+	Coord const t = x[Dim - 1] >> 1;
+	for (std::size_t i = Dim - 1; 0 != i; --i) {
+		x[i] ^= x[i - 1];
+	}
+	x[0] ^= t;
+
+	// Undo excess work
+	for (unsigned l = 1; levels != l; ++l) {
+		Coord const p = (Coord(1) << l) - 1;
+		for (std::size_t i = Dim; 0 != i--;) {
+			Coord const invert = Coord(0) - ((x[i] >> l) & Coord(1));
+			Coord const t      = (x[0] ^ x[i]) & p & ~invert;
+			x[0] ^= (p & invert) | t;
+			x[i] ^= t;
+		}
+	}
+}
+
+// The first word holds the most significant bit of each group of `Dim` bits, so it is
+// Morton order with the axes reversed
+template <class Code, std::size_t Dim>
+[[nodiscard]] constexpr Code hilbertInterleave(
+    std::array<MortonCoord<Code, Dim>, Dim> const& x, unsigned levels) noexcept
+{
+	if constexpr (2 == Dim) {
+		return ufo::mortonEncode<Code>(x[1], x[0]);
+	} else if constexpr (3 == Dim) {
+		return ufo::mortonEncode<Code>(x[2], x[1], x[0]);
+	} else {
+		Code h{};
+		for (unsigned l = levels; 0 != l--;) {
+			for (std::size_t d{}; Dim != d; ++d) {
+				h = (h << 1) | static_cast<Code>((x[d] >> l) & 1u);
+			}
+		}
+		return h;
+	}
+}
+
+template <class Code, std::size_t Dim>
+[[nodiscard]] constexpr std::array<MortonCoord<Code, Dim>, Dim> hilbertDeinterleave(
+    Code h, unsigned levels) noexcept
+{
+	using Coord = MortonCoord<Code, Dim>;
+
+	if constexpr (2 == Dim) {
+		auto const c = ufo::mortonDecode<2>(h);
+		return {c[1], c[0]};
+	} else if constexpr (3 == Dim) {
+		auto const c = ufo::mortonDecode<3>(h);
+		return {c[2], c[1], c[0]};
+	} else {
+		std::array<Coord, Dim> x{};
+		for (unsigned l{}; levels != l; ++l) {
+			for (std::size_t d = Dim; 0 != d--; h >>= 1) {
+				x[d] |= static_cast<Coord>(h & Code(1)) << l;
+			}
+		}
+		return x;
+	}
+}
+
+template <class Code, std::size_t Dim>
+[[nodiscard]] constexpr Code hilbertEncode(std::array<MortonCoord<Code, Dim>, Dim> x,
+                                           unsigned levels) noexcept
+{
+	assert((MORTON_COORD_BITS<Code, Dim> >= static_cast<int>(levels)));
+
+	if (0 == levels) {
+		return Code(0);
+	}
+
+	using Coord = MortonCoord<Code, Dim>;
+	Coord const valid =
+	    static_cast<Coord>(~Coord(0) >> (CODE_BITS<Coord> - static_cast<int>(levels)));
+	for (auto& e : x) {
+		e &= valid;
+	}
+
+	hilbertAxesToTranspose(x, levels);
+	return hilbertInterleave<Code, Dim>(x, levels);
+}
+
+template <class Code, std::size_t Dim>
+[[nodiscard]] constexpr std::array<MortonCoord<Code, Dim>, Dim> hilbertDecode(
+    Code h, unsigned levels) noexcept
+{
+	assert((MORTON_COORD_BITS<Code, Dim> >= static_cast<int>(levels)));
+
+	if (0 == levels) {
+		return {};
+	}
+
+	auto x = hilbertDeinterleave<Code, Dim>(h, levels);
+	hilbertTransposeToAxes(x, levels);
+	return x;
+}
+}  // namespace detail
+
+/*!
+ * @brief Index of `(x, y)` along the 2D Hilbert curve.
+ *
+ * Neighboring indices are always neighboring cells, unlike Morton (Z-order) where the
+ * curve jumps between quadrants, which gives better locality when the index is used to
+ * lay out tiles or points in memory or on disk. Computing it is about an order of
+ * magnitude more expensive than the Morton code though, so it is best used for layouts
+ * computed once.
+ *
+ * The curve covers all `bits(Code) / 2` bits of the coordinates. Its restriction to any
+ * power of two sized box at the origin is itself a Hilbert curve, so codes of small
+ * coordinates are as good as those of a smaller curve.
+ *
+ * @tparam Code `std::uint32_t`, `std::uint64_t`, or `Morton128` where supported.
+ */
+template <class Code = std::uint64_t>
+[[nodiscard]] constexpr Code hilbertEncode(MortonCoord<Code, 2> x,
+                                           MortonCoord<Code, 2> y) noexcept
+{
+	return detail::hilbertEncode<Code, 2>({x, y}, detail::MORTON_COORD_BITS<Code, 2>);
+}
+
+/*!
+ * @brief Index of `(x, y, z)` along the 3D Hilbert curve.
+ *
+ * @tparam Code `std::uint32_t`, `std::uint64_t`, or `Morton128` where supported.
+ */
+template <class Code = std::uint64_t>
+[[nodiscard]] constexpr Code hilbertEncode(MortonCoord<Code, 3> x, MortonCoord<Code, 3> y,
+                                           MortonCoord<Code, 3> z) noexcept
+{
+	return detail::hilbertEncode<Code, 3>({x, y, z}, detail::MORTON_COORD_BITS<Code, 3>);
+}
+
+/*!
+ * @brief Inverse of `hilbertEncode`, returns the `Dim` coordinates of index `h`.
+ */
+template <std::size_t Dim, class Code>
+[[nodiscard]] constexpr std::array<MortonCoord<Code, Dim>, Dim> hilbertDecode(
+    Code h) noexcept
+{
+	static_assert(2 == Dim || 3 == Dim, "Hilbert indices are 2D or 3D");
+	return detail::hilbertDecode<Code, Dim>(h, detail::MORTON_COORD_BITS<Code, Dim>);
+}
+
+/*!
+ * @brief Encodes the 2D coordinates `(x[i], y[i])` into `codes[i]`.
+ *
+ * @note All spans must have the same size.
+ */
+template <class Code>
+void hilbertEncode(Span<MortonCoord<Code, 2> const> x, Span<MortonCoord<Code, 2> const> y,
+                   Span<Code> codes)
+{
+	assert(x.size() == codes.size() && y.size() == codes.size());
+	for (std::size_t i{}; codes.size() != i; ++i) {
+		codes[i] = hilbertEncode<Code>(x[i], y[i]);
+	}
+}
+
+/*!
+ * @brief Encodes the 3D coordinates `(x[i], y[i], z[i])` into `codes[i]`.
+ *
+ * @note All spans must have the same size.
+ */
+template <class Code>
+void hilbertEncode(Span<MortonCoord<Code, 3> const> x, Span<MortonCoord<Code, 3> const> y,
+                   Span<MortonCoord<Code, 3> const> z, Span<Code> codes)
+{
+	assert(x.size() == codes.size() && y.size() == codes.size() &&
+	       z.size() == codes.size());
+	for (std::size_t i{}; codes.size() != i; ++i) {
+		codes[i] = hilbertEncode<Code>(x[i], y[i], z[i]);
+	}
+}
+
+/*!
+ * @brief Decodes `codes[i]` into the 2D coordinates `(x[i], y[i])`.
+ *
+ * @note All spans must have the same size.
+ */
+template <class Code>
+void hilbertDecode(Span<Code const> codes, Span<MortonCoord<Code, 2>> x,
+                   Span<MortonCoord<Code, 2>> y)
+{
+	assert(x.size() == codes.size() && y.size() == codes.size());
+	for (std::size_t i{}; codes.size() != i; ++i) {
+		auto const c = hilbertDecode<2>(codes[i]);
+		x[i]         = c[0];
+		y[i]         = c[1];
+	}
+}
+
+/*!
+ * @brief Decodes `codes[i]` into the 3D coordinates `(x[i], y[i], z[i])`.
+ *
+ * @note All spans must have the same size.
+ */
+template <class Code>
+void hilbertDecode(Span<Code const> codes, Span<MortonCoord<Code, 3>> x,
+                   Span<MortonCoord<Code, 3>> y, Span<MortonCoord<Code, 3>> z)
+{
+	assert(x.size() == codes.size() && y.size() == codes.size() &&
+	       z.size() == codes.size());
+	for (std::size_t i{}; codes.size() != i; ++i) {
+		auto const c = hilbertDecode<3>(codes[i]);
+		x[i]         = c[0];
+		y[i]         = c[1];
+		z[i]         = c[2];
+	}
+}
+
+/*!
+ * @brief Projection returning the Hilbert index of a point, with coordinates accessed
+ * through `operator[]` and converted to unsigned integers.
+ *
+ * Intended as the key of `radixSort`, or to fill the keys of `radixSortByKey` and
+ * `sortPermutation`, which is much faster than sorting with `HilbertLess` since the
+ * index is only computed once per point. Floating point coordinates have to be
+ * quantized (e.g., to voxel keys) first.
+ */
+template <std::size_t Dim, class Code = std::uint64_t>
+struct HilbertKey {
+	static_assert(2 == Dim || 3 == Dim, "Hilbert indices are 2D or 3D");
+
+	template <class Point>
+	[[nodiscard]] constexpr Code operator()(Point const& p) const noexcept
+	{
+		return (*this)(p, std::make_index_sequence<Dim>{});
+	}
+
+ private:
+	template <class Point, std::size_t... Is>
+	[[nodiscard]] constexpr Code operator()(Point const& p,
+	                                        std::index_sequence<Is...>) const noexcept
+	{
+		return hilbertEncode<Code>(static_cast<MortonCoord<Code, Dim>>(p[Is])...);
+	}
+};
+
+/*!
+ * @brief Orders points along the Hilbert curve, see `HilbertKey`.
+ */
+template <std::size_t Dim, class Code = std::uint64_t>
+struct HilbertLess {
+	template <class Point>
+	[[nodiscard]] constexpr bool operator()(Point const& a, Point const& b) const noexcept
+	{
+		HilbertKey<Dim, Code> const key;
+		return key(a) < key(b);
+	}
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_HILBERT_HPP
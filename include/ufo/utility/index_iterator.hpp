@@ -44,17 +44,29 @@
 
 // UFO
 #include <ufo/utility/proxy_arrow_result.hpp>
+#include <ufo/utility/split.hpp>
 
 // STL
+#include <cassert>
+#include <cstddef>
 #include <iterator>
 
 namespace ufo
 {
+/*!
+ * @brief The indices `first, first + inc, first + 2 * inc, ...` up to, but not
+ * including, `last`.
+ *
+ * Also models the TBB Range concept (like `tbb::blocked_range`), so it can be split up
+ * and handed to a scheduler, see `parallel_for`. Ranges containing more than `grain`
+ * indices are divisible.
+ */
 template <class T = std::size_t>
 struct IndexIterator {
-	T first{};
-	T last{};
-	T inc = T(1);
+	T           first{};
+	T           last{};
+	T           inc   = T(1);
+	std::size_t grain = 1;
 
 	class Iterator
 	{
@@ -135,7 +147,9 @@ struct IndexIterator {
 
 		friend constexpr difference_type operator-(Iterator const& lhs, Iterator const& rhs)
 		{
-			return lhs.inc * (lhs.pos - rhs.pos);
+			return (static_cast<difference_type>(lhs.pos) -
+			        static_cast<difference_type>(rhs.pos)) /
+			       static_cast<difference_type>(lhs.inc);
 		}
 
 		friend constexpr bool operator==(Iterator const& lhs, Iterator const& rhs)
@@ -177,12 +191,46 @@ struct IndexIterator {
 
 	constexpr IndexIterator() = default;
 
-	constexpr IndexIterator(T first, T last, T inc = T(1))
-	    : first(first), last(last), inc(inc)
+	constexpr IndexIterator(T first, T last, T inc = T(1), std::size_t grain = 1)
+	    : first(first), last(last), inc(inc), grain(grain)
 	{
 		assert(T(0) != inc);
 	}
 
+	/*!
+	 * @brief Splitting constructor, `r` keeps the first half of the indices and the
+	 * constructed range gets the second half.
+	 */
+	constexpr IndexIterator(IndexIterator& r, split)
+	    : first(r.first + static_cast<T>(r.size() / 2) * r.inc)
+	    , last(r.last)
+	    , inc(r.inc)
+	    , grain(r.grain)
+	{
+		assert(r.is_divisible());
+		r.last = first;
+	}
+
+	/*!
+	 * @brief Number of indices in the range.
+	 */
+	[[nodiscard]] constexpr std::size_t size() const noexcept
+	{
+		if (T(0) < inc) {
+			return first < last ? static_cast<std::size_t>((last - first + inc - T(1)) / inc)
+			                    : 0;
+		} else {
+			return last < first ? static_cast<std::size_t>((first - last - inc - T(1)) / -inc)
+			                    : 0;
+		}
+	}
+
+	[[nodiscard]] constexpr bool empty() const noexcept { return 0 == size(); }
+
+	[[nodiscard]] constexpr bool is_divisible() const noexcept { return grain < size(); }
+
+	[[nodiscard]] constexpr std::size_t grainsize() const noexcept { return grain; }
+
 	[[nodiscard]] Iterator begin() { return cbegin(); }
 
 	[[nodiscard]] Iterator begin() const { return cbegin(); }
@@ -193,7 +241,12 @@ struct IndexIterator {
 
 	[[nodiscard]] Iterator end() const { return cend(); }
 
-	[[nodiscard]] Iterator cend() const { return Iterator(last, inc); }
+	// The last index might not be a multiple of `inc` away from the first, so the end
+	// is the first index past the range that is
+	[[nodiscard]] Iterator cend() const
+	{
+		return Iterator(first + static_cast<T>(size()) * inc, inc);
+	}
 };
 }  // namespace ufo
 
@@ -0,0 +1,234 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BIT_READER_HPP
+#define UFO_UTILITY_BIT_READER_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/io/read_buffer.hpp>
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ufo
+{
+/*!
+ * @brief Reads a stream of bit fields written by `BitWriter` from a `ReadBuffer`.
+ *
+ * Reading starts at the current read position of the buffer. Bits are kept in a 64-bit
+ * accumulator that is refilled without branching on the number of bits left in it: 8
+ * bytes are loaded and only the whole bytes that fit are consumed, after which at least
+ * 56 bits are available. Only the last few bytes of the buffer take a slower path.
+ *
+ * Reading past the end of the buffer yields zero bits, check with `overrun`. Call
+ * `sync` to continue byte-wise reading from the buffer afterwards.
+ *
+ * @note The buffer must not be modified while it is being read.
+ */
+class BitReader
+{
+ public:
+	using size_type = std::size_t;
+
+	explicit BitReader(ReadBuffer& buffer) noexcept
+	    : buffer_(buffer)
+	    , data_(reinterpret_cast<unsigned char const*>(buffer.data()))
+	    , size_(buffer.size())
+	    , pos_(std::min(buffer.readPos(), size_))
+	    , start_(pos_)
+	{
+	}
+
+	BitReader(BitReader const&)            = delete;
+	BitReader& operator=(BitReader const&) = delete;
+
+	/*!
+	 * @brief Returns the next `n` bits without consuming them.
+	 *
+	 * @param n The number of bits, in [0, 56].
+	 */
+	[[nodiscard]] std::uint64_t peekBits(unsigned n) noexcept
+	{
+		assert(56 >= n);
+		refill();
+		return acc_ & mask(n);
+	}
+
+	/*!
+	 * @brief Consumes `n` bits, which have to be available through a previous `peekBits`.
+	 */
+	void skipBits(unsigned n) noexcept
+	{
+		assert(count_ >= n);
+		acc_ >>= n;
+		count_ -= n;
+	}
+
+	/*!
+	 * @brief Reads `n` bits.
+	 *
+	 * @param n The number of bits, in [0, 64].
+	 */
+	[[nodiscard]] std::uint64_t readBits(unsigned n) noexcept
+	{
+		assert(64 >= n);
+
+		if (56 < n) {
+			std::uint64_t const low = get(32);
+			return low | (get(n - 32) << 32);
+		}
+		return get(n);
+	}
+
+	[[nodiscard]] bool readBit() noexcept { return get(1); }
+
+	/*!
+	 * @brief Reads a value written by `BitWriter::writeUnary`.
+	 */
+	[[nodiscard]] std::uint64_t readUnary() noexcept
+	{
+		std::uint64_t value{};
+		refill();
+		// Stop at the end of the buffer, as everything after it reads as zero
+		while (0 == (acc_ & mask(count_)) && !overrun()) {
+			value += count_;
+			skipBits(count_);
+			refill();
+		}
+		unsigned const n = static_cast<unsigned>(countrZero(acc_));
+		skipBits(std::min(n + 1, count_));
+		return value + n;
+	}
+
+	/*!
+	 * @brief Reads a value written by `BitWriter::writeEliasGamma`.
+	 */
+	[[nodiscard]] std::uint64_t readEliasGamma() noexcept
+	{
+		refill();
+		if (0 != acc_ && 28 > countrZero(acc_)) {
+			// Unary length and the bits below the leading one are already in the
+			// accumulator
+			unsigned const n     = static_cast<unsigned>(countrZero(acc_));
+			std::uint64_t  value = (acc_ >> (n + 1)) & mask(n);
+			skipBits(2 * n + 1);
+			return value | (std::uint64_t(1) << n);
+		}
+
+		unsigned const n = static_cast<unsigned>(std::min<std::uint64_t>(readUnary(), 63));
+		return readBits(n) | (std::uint64_t(1) << n);
+	}
+
+	/*!
+	 * @brief Discards bits up to the next byte boundary.
+	 */
+	void align() noexcept { skipBits(count_ % 8); }
+
+	/*!
+	 * @brief Aligns to the next byte boundary and moves the read position of the buffer
+	 * past the bytes consumed.
+	 */
+	void sync() noexcept
+	{
+		align();
+		buffer_.readPos(std::min(size_, pos_ - count_ / 8));
+	}
+
+	/*!
+	 * @brief Total number of bits consumed.
+	 */
+	[[nodiscard]] size_type bitsRead() const noexcept
+	{
+		return 8 * (pos_ - start_) - count_;
+	}
+
+	/*!
+	 * @brief Whether more bits have been consumed than there are in the buffer.
+	 */
+	[[nodiscard]] bool overrun() const noexcept { return 8 * size_ < 8 * pos_ - count_; }
+
+ private:
+	[[nodiscard]] static constexpr std::uint64_t mask(unsigned n) noexcept
+	{
+		return 64 <= n ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+	}
+
+	[[nodiscard]] std::uint64_t get(unsigned n) noexcept
+	{
+		std::uint64_t const value = peekBits(n);
+		skipBits(n);
+		return value;
+	}
+
+	void refill() noexcept
+	{
+		std::uint64_t word{};
+		if (size_ >= pos_ + sizeof(word)) {
+			std::memcpy(&word, data_ + pos_, sizeof(word));
+		} else if (size_ > pos_) {
+			std::memcpy(&word, data_ + pos_, size_ - pos_);
+		}
+
+		acc_ |= word << count_;
+		pos_ += (63 - count_) / 8;
+		count_ |= 56;
+	}
+
+ private:
+	ReadBuffer& buffer_;
+
+	unsigned char const* data_;
+	size_type            size_;
+	// Position of the next byte to load into the accumulator, may go past `size_`
+	size_type pos_;
+	size_type start_;
+
+	std::uint64_t acc_{};
+	unsigned      count_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BIT_READER_HPP
@@ -0,0 +1,207 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BIT_WRITER_HPP
+#define UFO_UTILITY_BIT_WRITER_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/io/write_buffer.hpp>
+
+// STL
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ufo
+{
+/*!
+ * @brief Writes a stream of bit fields to a `WriteBuffer`.
+ *
+ * Bits are written least significant first, so the first field ends up in the low bits
+ * of the first byte. Fields are collected in a 64-bit accumulator and whole bytes are
+ * moved to a small staging area after every write without branching on how many bits
+ * are pending; the staging area is appended to the buffer when it fills up and on
+ * `flush`.
+ *
+ * `flush` has to be called when done, anything written after the last `flush` is not
+ * in the buffer.
+ */
+class BitWriter
+{
+	static constexpr std::size_t STAGE_SIZE = 512;
+
+ public:
+	using size_type = std::size_t;
+
+	explicit BitWriter(WriteBuffer& buffer) noexcept : buffer_(buffer) {}
+
+	BitWriter(BitWriter const&)            = delete;
+	BitWriter& operator=(BitWriter const&) = delete;
+
+	/*!
+	 * @brief Writes the `n` low bits of `value`.
+	 *
+	 * @param value The bits to write, must not have any bits set at or above `n`.
+	 * @param n The number of bits, in [0, 64].
+	 */
+	void writeBits(std::uint64_t value, unsigned n)
+	{
+		assert(64 >= n);
+		assert(64 == n || 0 == (value >> n));
+
+		if (56 < n) {
+			put(value & 0xFFFFFFFF, 32);
+			value >>= 32;
+			n -= 32;
+		}
+		put(value, n);
+	}
+
+	void writeBit(bool bit) { put(bit, 1); }
+
+	/*!
+	 * @brief Writes `value` as `value` zero bits followed by a one bit.
+	 */
+	void writeUnary(std::uint64_t value)
+	{
+		for (; 56 <= value; value -= 32) {
+			put(0, 32);
+		}
+		put(std::uint64_t(1) << value, static_cast<unsigned>(value) + 1);
+	}
+
+	/*!
+	 * @brief Writes `value` using Elias gamma coding, i.e., the number of bits after the
+	 * leading one in unary followed by those bits.
+	 *
+	 * Takes `2 * floor(log2(value)) + 1` bits, so small values are cheap.
+	 *
+	 * @param value The value to write, must be at least 1.
+	 */
+	void writeEliasGamma(std::uint64_t value)
+	{
+		assert(0 != value);
+
+		unsigned const n = static_cast<unsigned>(bitWidth(value)) - 1;
+		if (28 > n) {
+			// Unary length and the bits below the leading one in a single write
+			std::uint64_t const low = value ^ (std::uint64_t(1) << n);
+			put((low << (n + 1)) | (std::uint64_t(1) << n), 2 * n + 1);
+		} else {
+			writeUnary(n);
+			writeBits(value ^ (std::uint64_t(1) << n), n);
+		}
+	}
+
+	/*!
+	 * @brief Pads with zero bits to the next byte boundary.
+	 */
+	void align()
+	{
+		count_ = (count_ + 7) & ~7u;
+		put(0, 0);
+	}
+
+	/*!
+	 * @brief Aligns to the next byte boundary and appends everything written so far to
+	 * the buffer.
+	 */
+	void flush()
+	{
+		align();
+		if (len_) {
+			buffer_.write(stage_.data(), len_);
+			written_ += len_;
+			len_ = 0;
+		}
+	}
+
+	/*!
+	 * @brief Total number of bits written, including the ones not yet flushed.
+	 */
+	[[nodiscard]] size_type bitsWritten() const noexcept
+	{
+		return 8 * (written_ + len_) + count_;
+	}
+
+ private:
+	void put(std::uint64_t value, unsigned n)
+	{
+		assert(56 >= n);
+
+		// Work on copies, the store to the staging area could otherwise alias the members
+		std::uint64_t acc   = acc_ | (value << count_);
+		unsigned      count = count_ + n;
+		size_type     len   = len_;
+
+		// Always store the whole accumulator and only advance past the complete bytes,
+		// the incomplete byte is overwritten by the next store
+		std::memcpy(stage_.data() + len, &acc, sizeof(acc));
+		unsigned const bytes = count / 8;
+		len += bytes;
+		acc_   = acc >> (8 * bytes);
+		count_ = count % 8;
+		len_   = len;
+
+		if (STAGE_SIZE - sizeof(acc) < len) {
+			buffer_.write(stage_.data(), len);
+			written_ += len;
+			len_ = 0;
+		}
+	}
+
+ private:
+	WriteBuffer& buffer_;
+
+	std::uint64_t acc_{};
+	unsigned      count_{};
+
+	// Extra room so the accumulator can always be stored in full
+	std::array<std::byte, STAGE_SIZE + sizeof(std::uint64_t)> stage_;
+	size_type                                                 len_{};
+	size_type                                                 written_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BIT_WRITER_HPP
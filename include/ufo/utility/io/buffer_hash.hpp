@@ -0,0 +1,88 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_BUFFER_HASH_HPP
+#define UFO_UTILITY_BUFFER_HASH_HPP
+
+// UFO
+#include <ufo/utility/hash.hpp>
+#include <ufo/utility/io/read_buffer.hpp>
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace ufo
+{
+/*!
+ * @brief Hashes the unread part of `in`, i.e., `[readPos(), size())`, without
+ * consuming it.
+ */
+[[nodiscard]] inline std::uint64_t hashBytes(ReadBuffer const& in,
+                                             std::uint64_t     seed = 0) noexcept
+{
+	return hashBytes(in.data() + in.readPos(), in.readLeft(), seed);
+}
+
+/*!
+ * @brief Consumes the next `count` bytes of `in` and feeds them to `hasher`.
+ *
+ * Useful for checksumming a section of a stream while it is being parsed; the result
+ * equals `hashBytes` over the same bytes.
+ *
+ * @throws std::out_of_range If fewer than `count` bytes are left to read.
+ */
+inline Hasher& hashRead(Hasher& hasher, ReadBuffer& in, std::size_t count)
+{
+	if (in.readLeft() < count) {
+		throw std::out_of_range("Tried to hash " + std::to_string(count) +
+		                        " bytes but only " + std::to_string(in.readLeft()) +
+		                        " are left in the buffer");
+	}
+	hasher.update(in.data() + in.readPos(), count);
+	in.readSkip(count);
+	return hasher;
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_BUFFER_HASH_HPP
@@ -0,0 +1,568 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_FLOAT_CODEC_HPP
+#define UFO_UTILITY_FLOAT_CODEC_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/bit_packed_array.hpp>
+#include <ufo/utility/io/bit_reader.hpp>
+#include <ufo/utility/io/bit_writer.hpp>
+#include <ufo/utility/io/read_buffer.hpp>
+#include <ufo/utility/io/write_buffer.hpp>
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+namespace detail
+{
+// Number of values converted at a time between the buffers and the caller's floats
+inline constexpr std::size_t FLOAT_CODEC_CHUNK = 256;
+
+template <class T>
+using FloatBits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+template <class To, class From>
+[[nodiscard]] To bitCast(From from) noexcept
+{
+	static_assert(sizeof(To) == sizeof(From));
+	To to;
+	std::memcpy(&to, &from, sizeof(to));
+	return to;
+}
+
+inline void fixedPointQuantize(float const* in, std::uint32_t* out, std::size_t count,
+                               double min, double inv_step) noexcept
+{
+	std::size_t i{};
+#if defined(__AVX2__)
+	// In double precision so that the quantization itself adds no error
+	__m256d const vmin = _mm256_set1_pd(min);
+	__m256d const vinv = _mm256_set1_pd(inv_step);
+	for (; count / 8 * 8 > i; i += 8) {
+		__m256 const  v  = _mm256_loadu_ps(in + i);
+		__m256d const lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+		__m256d const hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+		__m128i const qlo =
+		    _mm256_cvtpd_epi32(_mm256_mul_pd(_mm256_sub_pd(lo, vmin), vinv));
+		__m128i const qhi =
+		    _mm256_cvtpd_epi32(_mm256_mul_pd(_mm256_sub_pd(hi, vmin), vinv));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+		                    _mm256_inserti128_si256(_mm256_castsi128_si256(qlo), qhi, 1));
+	}
+#endif
+	for (; count > i; ++i) {
+		// Round to nearest even, same as the vectorized conversion
+		out[i] = static_cast<std::uint32_t>(std::nearbyint((in[i] - min) * inv_step));
+	}
+}
+
+inline void fixedPointDequantize(std::uint32_t const* in, float* out, std::size_t count,
+                                 double min, double step) noexcept
+{
+	std::size_t i{};
+#if defined(__AVX2__)
+	__m256d const vmin  = _mm256_set1_pd(min);
+	__m256d const vstep = _mm256_set1_pd(step);
+	for (; count / 8 * 8 > i; i += 8) {
+		__m256i const q  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+		__m256d const lo = _mm256_add_pd(
+		    vmin, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(q)), vstep));
+		__m256d const hi = _mm256_add_pd(
+		    vmin, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(q, 1)), vstep));
+		_mm256_storeu_ps(out + i, _mm256_insertf128_ps(
+		                              _mm256_castps128_ps256(_mm256_cvtpd_ps(lo)),
+		                              _mm256_cvtpd_ps(hi), 1));
+	}
+#endif
+	for (; count > i; ++i) {
+		out[i] = static_cast<float>(min + static_cast<double>(in[i]) * step);
+	}
+}
+
+[[nodiscard]] inline float maxAbsError(float const* a, float const* b,
+                                       std::size_t count) noexcept
+{
+	std::size_t i{};
+	float       error{};
+#if defined(__AVX2__)
+	__m256 const sign = _mm256_set1_ps(-0.0f);
+	__m256       verr = _mm256_setzero_ps();
+	for (; count / 8 * 8 > i; i += 8) {
+		__m256 const d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+		verr           = _mm256_max_ps(verr, _mm256_andnot_ps(sign, d));
+	}
+	alignas(32) std::array<float, 8> lanes;
+	_mm256_store_ps(lanes.data(), verr);
+	error = *std::max_element(lanes.begin(), lanes.end());
+#endif
+	for (; count > i; ++i) {
+		error = std::max(error, std::abs(a[i] - b[i]));
+	}
+	return error;
+}
+
+[[nodiscard]] inline std::pair<float, float> minMax(float const* values,
+                                                    std::size_t  count) noexcept
+{
+	assert(0 < count);
+	std::size_t i{};
+	float       min = values[0];
+	float       max = values[0];
+#if defined(__AVX2__)
+	// Compare-and-branch per value is several times slower
+	__m256 vmin = _mm256_set1_ps(min);
+	__m256 vmax = vmin;
+	for (; count / 8 * 8 > i; i += 8) {
+		__m256 const v = _mm256_loadu_ps(values + i);
+		vmin           = _mm256_min_ps(vmin, v);
+		vmax           = _mm256_max_ps(vmax, v);
+	}
+	alignas(32) std::array<float, 8> lanes;
+	_mm256_store_ps(lanes.data(), vmin);
+	min = *std::min_element(lanes.begin(), lanes.end());
+	_mm256_store_ps(lanes.data(), vmax);
+	max = *std::max_element(lanes.begin(), lanes.end());
+#endif
+	for (; count > i; ++i) {
+		min = std::min(min, values[i]);
+		max = std::max(max, values[i]);
+	}
+	return {min, max};
+}
+}  // namespace detail
+
+//
+// Fixed-point
+//
+
+/*!
+ * @brief Writes `values` as fixed-point numbers that are at most `max_error` off.
+ *
+ * The values are quantized to multiples of `2 * max_error` above the smallest value
+ * and stored with as few bits as the range requires (see `BitPackedArray`). Rounding
+ * the reconstructed value back to `float` can add up to half a unit in the last place
+ * on top of `max_error`.
+ *
+ * @param values The values, must be finite.
+ * @param max_error The largest absolute error allowed, must be positive.
+ * @return The largest absolute error actually introduced.
+ * @throws std::invalid_argument If `max_error` is not positive or the range of the
+ * values needs more than 31 bits at that precision.
+ */
+inline float writeFixedPoint(WriteBuffer& out, Span<float const> values, float max_error)
+{
+	if (!(0 < max_error)) {
+		throw std::invalid_argument("writeFixedPoint: max_error has to be positive");
+	}
+
+	double min{};
+	double max{};
+	if (!values.empty()) {
+		auto const [lo, hi] = detail::minMax(values.data(), values.size());
+		min                 = lo;
+		max                 = hi;
+	}
+
+	double const step     = 2.0 * max_error;
+	double const inv_step = 1.0 / step;
+	// Same expression as the quantization, so the largest value gets the same code
+	double const range = std::nearbyint((max - min) * inv_step);
+	if (!(double(std::uint32_t(1) << 31) > range)) {
+		throw std::invalid_argument(
+		    "writeFixedPoint: range needs more than 31 bits with max_error " +
+		    std::to_string(max_error));
+	}
+
+	unsigned const bits = std::max(1, bitWidth(static_cast<std::uint32_t>(range)));
+	BitPackedArray<> q(bits, values.size());
+
+	float error{};
+	std::array<std::uint32_t, detail::FLOAT_CODEC_CHUNK> buf;
+	std::array<float, detail::FLOAT_CODEC_CHUNK>         rec;
+	for (std::size_t i{}; values.size() != i;) {
+		std::size_t const n = std::min(buf.size(), values.size() - i);
+		detail::fixedPointQuantize(values.data() + i, buf.data(), n, min, inv_step);
+		q.pack(i, Span<std::uint32_t const>(buf.data(), n));
+		detail::fixedPointDequantize(buf.data(), rec.data(), n, min, step);
+		error = std::max(error, detail::maxAbsError(values.data() + i, rec.data(), n));
+		i += n;
+	}
+
+	out.write(min);
+	out.write(step);
+	q.write(out);
+	return error;
+}
+
+/*!
+ * @brief Reads values written by `writeFixedPoint`, replacing the content of `values`.
+ *
+ * `values` is left unchanged if an exception is thrown.
+ *
+ * @throws std::invalid_argument If the stored width is not in [1, 32].
+ * @throws std::out_of_range If `in` does not hold all values.
+ */
+inline void readFixedPoint(ReadBuffer& in, std::vector<float>& values)
+{
+	double           min;
+	double           step;
+	BitPackedArray<> q;
+	in.read(min);
+	in.read(step);
+	q.read(in);
+
+	std::vector<float>                                   result(q.size());
+	std::array<std::uint32_t, detail::FLOAT_CODEC_CHUNK> buf;
+	for (std::size_t i{}; result.size() != i;) {
+		std::size_t const n = std::min(buf.size(), result.size() - i);
+		q.unpack(i, Span<std::uint32_t>(buf.data(), n));
+		detail::fixedPointDequantize(buf.data(), result.data() + i, n, min, step);
+		i += n;
+	}
+	values.swap(result);
+}
+
+//
+// Half-precision
+//
+
+/*!
+ * @brief Converts to IEEE 754 half precision, rounding to nearest even.
+ *
+ * Values above the half precision range become infinity, NaN stays NaN. Gives the same
+ * results as the F16C instructions.
+ */
+[[nodiscard]] inline std::uint16_t floatToHalf(float value) noexcept
+{
+	// See Fabian Giesen's float_to_half_fast3_rtne
+	constexpr std::uint32_t F32_INF  = 255u << 23;
+	constexpr std::uint32_t F16_MAX  = (127u + 16) << 23;
+	constexpr std::uint32_t DENORM   = ((127u - 15) + (23 - 10) + 1) << 23;
+	constexpr std::uint32_t MIN_NORM = 113u << 23;
+
+	std::uint32_t       f    = detail::bitCast<std::uint32_t>(value);
+	std::uint32_t const sign = f & 0x80000000u;
+	f ^= sign;
+
+	std::uint32_t h;
+	if (F16_MAX <= f) {
+		// Quiet NaN keeping the top of the payload, as F16C does
+		h = F32_INF < f ? 0x7E00 | ((f >> 13) & 0x3FF) : 0x7C00;
+	} else if (MIN_NORM > f) {
+		// Subnormal or zero, adding the magic number aligns the mantissa and rounds
+		float const magic = detail::bitCast<float>(DENORM);
+		h = detail::bitCast<std::uint32_t>(detail::bitCast<float>(f) + magic) - DENORM;
+	} else {
+		std::uint32_t const odd = (f >> 13) & 1u;
+		f += ((15u - 127u) << 23) + 0xFFF + odd;
+		h = f >> 13;
+	}
+
+	return static_cast<std::uint16_t>(h | (sign >> 16));
+}
+
+[[nodiscard]] inline float halfToFloat(std::uint16_t value) noexcept
+{
+	constexpr std::uint32_t SHIFTED_EXP = 0x7C00u << 13;
+
+	std::uint32_t       f   = (value & 0x7FFFu) << 13;
+	std::uint32_t const exp = SHIFTED_EXP & f;
+	f += (127u - 15) << 23;
+
+	if (SHIFTED_EXP == exp) {
+		// Infinity or NaN, NaNs are made quiet as F16C does
+		f += (128u - 16) << 23;
+		f |= (f & 0x7FFFFFu) ? 0x400000u : 0u;
+	} else if (0 == exp) {
+		// Zero or subnormal, renormalize
+		f += 1u << 23;
+		f = detail::bitCast<std::uint32_t>(detail::bitCast<float>(f) -
+		                                   detail::bitCast<float>(113u << 23));
+	}
+
+	return detail::bitCast<float>(f | (std::uint32_t(value & 0x8000u) << 16));
+}
+
+inline void floatToHalf(Span<float const> in, Span<std::uint16_t> out) noexcept
+{
+	assert(in.size() == out.size());
+	std::size_t i{};
+#if defined(__F16C__)
+	for (; in.size() - i >= 8; i += 8) {
+		_mm_storeu_si128(
+		    reinterpret_cast<__m128i*>(out.data() + i),
+		    _mm256_cvtps_ph(_mm256_loadu_ps(in.data() + i), _MM_FROUND_TO_NEAREST_INT));
+	}
+#endif
+	for (; in.size() != i; ++i) {
+		out[i] = floatToHalf(in[i]);
+	}
+}
+
+inline void halfToFloat(Span<std::uint16_t const> in, Span<float> out) noexcept
+{
+	assert(in.size() == out.size());
+	std::size_t i{};
+#if defined(__F16C__)
+	for (; in.size() - i >= 8; i += 8) {
+		_mm256_storeu_ps(out.data() + i,
+		                 _mm256_cvtph_ps(_mm_loadu_si128(
+		                     reinterpret_cast<__m128i const*>(in.data() + i))));
+	}
+#endif
+	for (; in.size() != i; ++i) {
+		out[i] = halfToFloat(in[i]);
+	}
+}
+
+/*!
+ * @brief Writes `values` in half precision.
+ *
+ * The relative error is at most 2^-11 for magnitudes in [2^-14, 65504], values below
+ * that lose precision gradually and values above become infinity.
+ *
+ * @return The largest absolute error introduced.
+ */
+inline float writeHalf(WriteBuffer& out, Span<float const> values)
+{
+	out.write(static_cast<std::uint64_t>(values.size()));
+
+	float error{};
+	std::array<std::uint16_t, detail::FLOAT_CODEC_CHUNK> buf;
+	std::array<float, detail::FLOAT_CODEC_CHUNK>         rec;
+	for (std::size_t i{}; values.size() != i;) {
+		std::size_t const n = std::min(buf.size(), values.size() - i);
+		floatToHalf(values.subspan(i, n), Span<std::uint16_t>(buf.data(), n));
+		halfToFloat(Span<std::uint16_t const>(buf.data(), n), Span<float>(rec.data(), n));
+		error = std::max(error, detail::maxAbsError(values.data() + i, rec.data(), n));
+		out.write(buf.data(), n * sizeof(std::uint16_t));
+		i += n;
+	}
+	return error;
+}
+
+/*!
+ * @brief Reads values written by `writeHalf`, replacing the content of `values`.
+ *
+ * @throws std::out_of_range If `in` does not hold all values.
+ */
+inline void readHalf(ReadBuffer& in, std::vector<float>& values)
+{
+	std::uint64_t size;
+	in.read(size);
+	if (in.readLeft() / sizeof(std::uint16_t) < size) {
+		throw std::out_of_range("readHalf: buffer too small for " + std::to_string(size) +
+		                        " values");
+	}
+
+	values.resize(size);
+	std::array<std::uint16_t, detail::FLOAT_CODEC_CHUNK> buf;
+	for (std::size_t i{}; values.size() != i;) {
+		std::size_t const n = std::min(buf.size(), values.size() - i);
+		in.read(buf.data(), n * sizeof(std::uint16_t));
+		halfToFloat(Span<std::uint16_t const>(buf.data(), n),
+		            Span<float>(values.data() + i, n));
+		i += n;
+	}
+}
+
+//
+// XOR (Gorilla)
+//
+
+/*!
+ * @brief Writes `values` XORed with their predecessor, for slowly changing series such
+ * as timestamps (see Gorilla, Pelkonen et al. 2015).
+ *
+ * Each XOR is stored as a single zero bit if the value repeats, by its meaningful bits
+ * if they fit within the leading and trailing zeros of the previous XOR, or else by the
+ * number of leading zeros, the number of meaningful bits and the bits themselves.
+ *
+ * The coding is lossless, unless `mantissa_bits` is less than the number of mantissa
+ * bits of `T`, in which case the mantissas are rounded to that many bits first. This
+ * bounds the relative error by 2^-(mantissa_bits + 1) and leaves more trailing zeros.
+ *
+ * @tparam T `float` or `double`.
+ * @return The largest absolute error introduced.
+ */
+template <class T>
+T writeXor(WriteBuffer& out, Span<T const> values,
+           unsigned mantissa_bits = std::numeric_limits<T>::digits - 1)
+{
+	static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+	              "writeXor requires float or double");
+
+	using Bits = detail::FloatBits<T>;
+
+	constexpr unsigned WIDTH    = 8 * sizeof(T);
+	constexpr unsigned MANTISSA = std::numeric_limits<T>::digits - 1;
+	constexpr unsigned LZ_BITS  = 4 == sizeof(T) ? 4 : 5;
+	constexpr unsigned LEN_BITS = 4 == sizeof(T) ? 5 : 6;
+	constexpr Bits     EXP_MASK = ((Bits(1) << (WIDTH - 1 - MANTISSA)) - 1) << MANTISSA;
+	constexpr unsigned MAX_LEAD = (1u << LZ_BITS) - 1;
+
+	unsigned const drop = MANTISSA - std::min(mantissa_bits, MANTISSA);
+	Bits const     keep = ~((Bits(1) << drop) - 1);
+	Bits const     half = 0 == drop ? Bits(0) : Bits(1) << (drop - 1);
+
+	out.write(static_cast<std::uint64_t>(values.size()));
+	out.write(static_cast<std::uint8_t>(MANTISSA - drop));
+
+	BitWriter writer(out);
+	T         error{};
+	Bits      prev{};
+	unsigned  prev_lead  = WIDTH;
+	unsigned  prev_trail = 0;
+	for (T value : values) {
+		Bits bits = detail::bitCast<Bits>(value);
+		// Round the magnitude to nearest, leaving infinities and NaNs alone
+		if (EXP_MASK != (bits & EXP_MASK)) {
+			bits = (bits + half) & keep;
+		}
+		error = std::max(error, std::abs(detail::bitCast<T>(bits) - value));
+
+		Bits const x = bits ^ prev;
+		prev         = bits;
+
+		if (0 == x) {
+			writer.writeBit(false);
+			continue;
+		}
+		writer.writeBit(true);
+
+		unsigned const lead  = std::min(MAX_LEAD, static_cast<unsigned>(countlZero(x)));
+		unsigned const trail = static_cast<unsigned>(countrZero(x));
+		if (lead >= prev_lead && trail >= prev_trail) {
+			writer.writeBit(false);
+			writer.writeBits(x >> prev_trail, WIDTH - prev_lead - prev_trail);
+		} else {
+			unsigned const len = WIDTH - lead - trail;
+			writer.writeBit(true);
+			writer.writeBits(lead, LZ_BITS);
+			writer.writeBits(len - 1, LEN_BITS);
+			writer.writeBits(x >> trail, len);
+			prev_lead  = lead;
+			prev_trail = trail;
+		}
+	}
+	writer.flush();
+
+	return error;
+}
+
+/*!
+ * @brief Reads values written by `writeXor`, replacing the content of `values`.
+ *
+ * `values` is left unchanged if an exception is thrown.
+ *
+ * @throws std::out_of_range If `in` does not hold all values.
+ */
+template <class T>
+void readXor(ReadBuffer& in, std::vector<T>& values)
+{
+	static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+	              "readXor requires float or double");
+
+	using Bits = detail::FloatBits<T>;
+
+	constexpr unsigned WIDTH    = 8 * sizeof(T);
+	constexpr unsigned LZ_BITS  = 4 == sizeof(T) ? 4 : 5;
+	constexpr unsigned LEN_BITS = 4 == sizeof(T) ? 5 : 6;
+
+	std::uint64_t size;
+	std::uint8_t  mantissa_bits;
+	in.read(size);
+	in.read(mantissa_bits);
+	// Every value takes at least one bit
+	if (8 * in.readLeft() < size) {
+		throw std::out_of_range("readXor: buffer too small for " + std::to_string(size) +
+		                        " values");
+	}
+
+	std::vector<T> result(size);
+	BitReader      reader(in);
+	Bits           prev{};
+	unsigned       lead  = WIDTH;
+	unsigned       trail = 0;
+	for (T& value : result) {
+		if (reader.readBit()) {
+			if (reader.readBit()) {
+				lead               = static_cast<unsigned>(reader.readBits(LZ_BITS));
+				unsigned const len = static_cast<unsigned>(reader.readBits(LEN_BITS)) + 1;
+				// The clamp only matters for corrupt data
+				trail = WIDTH - lead - std::min(len, WIDTH - lead);
+			}
+			prev ^= static_cast<Bits>(reader.readBits(WIDTH - lead - trail)) << trail;
+		}
+		value = detail::bitCast<T>(prev);
+	}
+
+	if (reader.overrun()) {
+		throw std::out_of_range("readXor: buffer too small for " + std::to_string(size) +
+		                        " values");
+	}
+	reader.sync();
+	values.swap(result);
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_FLOAT_CODEC_HPP
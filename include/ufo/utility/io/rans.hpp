@@ -0,0 +1,501 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_RANS_HPP
+#define UFO_UTILITY_RANS_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/io/bit_reader.hpp>
+#include <ufo/utility/io/bit_writer.hpp>
+#include <ufo/utility/io/read_buffer.hpp>
+#include <ufo/utility/io/write_buffer.hpp>
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Default number of bytes coded with the same frequency table.
+ */
+inline constexpr std::size_t RANS_BLOCK_SIZE = std::size_t(1) << 18;
+
+namespace detail
+{
+inline constexpr unsigned      RANS_PROB_BITS  = 12;
+inline constexpr std::uint32_t RANS_PROB_SCALE = std::uint32_t(1) << RANS_PROB_BITS;
+// Lower bound of the state, with 16-bit renormalization the state stays below 2^31,
+// which is what the reciprocal division in the encoder is exact for
+inline constexpr std::uint32_t RANS_L = std::uint32_t(1) << 15;
+// Number of interleaved states, symbol `i` is coded with state `i % RANS_STREAMS`
+inline constexpr std::size_t RANS_STREAMS = 8;
+
+using RansFreqs = std::array<std::uint32_t, 256>;
+
+/*!
+ * Scales the symbol counts so they sum to `RANS_PROB_SCALE`, keeping every symbol that
+ * occurs at a frequency of at least 1.
+ */
+[[nodiscard]] inline RansFreqs ransNormalize(std::array<std::uint64_t, 256> const& counts,
+                                             std::uint64_t total) noexcept
+{
+	RansFreqs freqs{};
+	if (0 == total) {
+		return freqs;
+	}
+
+	std::uint32_t sum{};
+	for (std::size_t s{}; 256 != s; ++s) {
+		if (counts[s]) {
+			freqs[s] = std::max<std::uint32_t>(
+			    1, static_cast<std::uint32_t>(counts[s] * RANS_PROB_SCALE / total));
+			sum += freqs[s];
+		}
+	}
+
+	// Rounding, and bumping rare symbols to 1, leaves a small difference that is taken
+	// from or given to the most frequent symbols, where it costs the least
+	while (RANS_PROB_SCALE != sum) {
+		auto const it = std::max_element(freqs.begin(), freqs.end());
+		if (RANS_PROB_SCALE > sum) {
+			*it += RANS_PROB_SCALE - sum;
+			sum = RANS_PROB_SCALE;
+		} else {
+			std::uint32_t const take = std::min(*it - 1, sum - RANS_PROB_SCALE);
+			*it -= take;
+			sum -= take;
+		}
+	}
+
+	return freqs;
+}
+
+inline void ransWriteFreqs(WriteBuffer& out, RansFreqs const& freqs)
+{
+	BitWriter writer(out);
+	for (std::uint32_t f : freqs) {
+		writer.writeEliasGamma(f + 1);
+	}
+	writer.flush();
+}
+
+[[nodiscard]] inline RansFreqs ransReadFreqs(ReadBuffer& in)
+{
+	RansFreqs     freqs;
+	std::uint64_t sum{};
+	BitReader     reader(in);
+	for (std::uint32_t& f : freqs) {
+		// Clamped so a corrupt table cannot overflow the sum
+		std::uint64_t const v = reader.readEliasGamma() - 1;
+		f = static_cast<std::uint32_t>(std::min<std::uint64_t>(v, RANS_PROB_SCALE + 1));
+		sum += f;
+	}
+	if (reader.overrun() || RANS_PROB_SCALE != sum) {
+		throw std::runtime_error("rANS: corrupt frequency table");
+	}
+	reader.sync();
+	return freqs;
+}
+
+/*!
+ * Encoder side of a symbol, division by the frequency is replaced by a multiplication
+ * with its reciprocal (see Fabian Giesen's ryg_rans).
+ */
+struct RansEncSymbol {
+	std::uint32_t x_max;
+	std::uint32_t rcp_freq;
+	std::uint32_t bias;
+	std::uint32_t cmpl_freq;
+	std::uint32_t rcp_shift;
+};
+
+[[nodiscard]] inline RansEncSymbol ransEncSymbol(std::uint32_t start,
+                                                 std::uint32_t freq) noexcept
+{
+	RansEncSymbol sym;
+	sym.x_max     = ((RANS_L >> RANS_PROB_BITS) << 16) * freq;
+	sym.cmpl_freq = RANS_PROB_SCALE - freq;
+	if (2 > freq) {
+		sym.rcp_freq  = ~std::uint32_t(0);
+		sym.rcp_shift = 0;
+		sym.bias      = start + RANS_PROB_SCALE - 1;
+	} else {
+		std::uint32_t const shift = static_cast<std::uint32_t>(bitWidth(freq - 1));
+		sym.rcp_freq  = static_cast<std::uint32_t>(
+		    ((std::uint64_t(1) << (shift + 31)) + freq - 1) / freq);
+		sym.rcp_shift = shift - 1;
+		sym.bias      = start;
+	}
+	return sym;
+}
+
+struct RansDecodeTable {
+	// Frequency in the low and offset into the symbol's range in the high 16 bits
+	std::array<std::uint32_t, RANS_PROB_SCALE> entry;
+	// Padded so that 32-bit gathers of the last slots stay in bounds
+	std::array<std::uint8_t, RANS_PROB_SCALE + 3> symbol;
+
+	explicit RansDecodeTable(RansFreqs const& freqs) noexcept
+	{
+		std::uint32_t start{};
+		for (std::uint32_t s{}; 256 != s; ++s) {
+			for (std::uint32_t k{}; freqs[s] != k; ++k) {
+				entry[start + k]  = freqs[s] | (k << 16);
+				symbol[start + k] = static_cast<std::uint8_t>(s);
+			}
+			start += freqs[s];
+		}
+		std::fill(symbol.begin() + RANS_PROB_SCALE, symbol.end(), std::uint8_t(0));
+	}
+};
+
+inline void ransEncodeBlock(std::uint8_t const* in, std::uint32_t n, WriteBuffer& out)
+{
+	std::array<std::uint64_t, 256> counts{};
+	for (std::uint32_t i{}; n != i; ++i) {
+		++counts[in[i]];
+	}
+	RansFreqs const freqs = ransNormalize(counts, n);
+	ransWriteFreqs(out, freqs);
+
+	std::array<RansEncSymbol, 256> syms;
+	for (std::uint32_t s{}, start{}; 256 != s; start += freqs[s], ++s) {
+		syms[s] = ransEncSymbol(start, freqs[s]);
+	}
+
+	// Symbols are coded in reverse so the decoder can run forward, the output is filled
+	// from the back. Each symbol emits at most one word.
+	std::vector<std::uint16_t>              words(n);
+	std::size_t                             w = n;
+	std::array<std::uint32_t, RANS_STREAMS> x;
+	x.fill(RANS_L);
+
+	for (std::uint32_t i = n; 0 != i--;) {
+		RansEncSymbol const& sym = syms[in[i]];
+		std::uint32_t&       s   = x[i % RANS_STREAMS];
+		if (s >= sym.x_max) {
+			words[--w] = static_cast<std::uint16_t>(s);
+			s >>= 16;
+		}
+		std::uint32_t const q = static_cast<std::uint32_t>(
+		                            (static_cast<std::uint64_t>(s) * sym.rcp_freq) >> 32) >>
+		                        sym.rcp_shift;
+		s += sym.bias + q * sym.cmpl_freq;
+	}
+
+	out.write(static_cast<std::uint32_t>(n - w));
+	out.write(x.data(), sizeof(x));
+	out.write(words.data() + w, (n - w) * sizeof(std::uint16_t));
+}
+
+[[nodiscard]] inline std::uint32_t ransDecodeStep(RansDecodeTable const& table,
+                                                  std::uint32_t&         x,
+                                                  std::uint8_t const*&   p,
+                                                  std::uint8_t const*    end) noexcept
+{
+	std::uint32_t const slot = x & (RANS_PROB_SCALE - 1);
+	std::uint32_t const e    = table.entry[slot];
+	x                        = (e & 0xFFFF) * (x >> RANS_PROB_BITS) + (e >> 16);
+	if (RANS_L > x && end > p) {
+		std::uint16_t word;
+		std::memcpy(&word, p, sizeof(word));
+		x = (x << 16) | word;
+		p += sizeof(word);
+	}
+	return table.symbol[slot];
+}
+
+#if defined(__AVX2__)
+// For each refill mask, the index of the next word each refilled lane takes
+struct RansRefillTable {
+	std::array<std::array<std::uint8_t, 8>, 256> index{};
+
+	constexpr RansRefillTable() noexcept
+	{
+		for (unsigned m{}; 256 != m; ++m) {
+			for (unsigned lane{}, k{}; 8 != lane; ++lane) {
+				index[m][lane] = static_cast<std::uint8_t>((m >> lane) & 1u ? k++ : 0);
+			}
+		}
+	}
+};
+
+inline constexpr RansRefillTable RANS_REFILL_TABLE{};
+#endif
+
+// A block whose frequency table and coded words have been read and checked
+struct RansBlock {
+	RansFreqs                               freqs;
+	std::array<std::uint32_t, RANS_STREAMS> x;
+	std::uint8_t const*                     words;
+	std::uint8_t const*                     words_end;
+};
+
+[[nodiscard]] inline RansBlock ransReadBlock(ReadBuffer& in)
+{
+	RansBlock block;
+	block.freqs = ransReadFreqs(in);
+
+	std::uint32_t num_words;
+	in.read(num_words);
+	in.read(block.x.data(), sizeof(block.x));
+	if (in.size() - in.readPos() < num_words * sizeof(std::uint16_t)) {
+		throw std::out_of_range("rANS: buffer too small for block");
+	}
+
+	block.words     = reinterpret_cast<std::uint8_t const*>(in.data()) + in.readPos();
+	block.words_end = block.words + num_words * sizeof(std::uint16_t);
+	in.readSkip(num_words * sizeof(std::uint16_t));
+	return block;
+}
+
+inline void ransDecodeBlock(RansBlock const& block, std::uint8_t* out,
+                            std::uint32_t n) noexcept
+{
+	RansDecodeTable const table(block.freqs);
+
+	std::array<std::uint32_t, RANS_STREAMS> x   = block.x;
+	std::uint8_t const*                     p   = block.words;
+	std::uint8_t const*                     end = block.words_end;
+
+	std::uint32_t i{};
+
+#if defined(__AVX2__)
+	// All 8 states are decoded at once, the lanes that need a new word take the next
+	// ones in lane order, which is the order the scalar decoder reads them in
+	__m256i       state = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(x.data()));
+	__m256i const slot_mask =
+	    _mm256_set1_epi32(static_cast<int>(RANS_PROB_SCALE - 1));
+	__m256i const low_mask = _mm256_set1_epi32(0xFFFF);
+	__m256i const lower    = _mm256_set1_epi32(static_cast<int>(RANS_L));
+	__m256i const byte_pick =
+	    _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 4,
+	                     8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	__m256i const dword_pick = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+
+	for (; n - i >= RANS_STREAMS && end - p >= 16; i += RANS_STREAMS) {
+		__m256i const slot  = _mm256_and_si256(state, slot_mask);
+		__m256i const entry = _mm256_i32gather_epi32(
+		    reinterpret_cast<int const*>(table.entry.data()), slot, 4);
+		__m256i const sym = _mm256_i32gather_epi32(
+		    reinterpret_cast<int const*>(table.symbol.data()), slot, 1);
+
+		state = _mm256_add_epi32(
+		    _mm256_mullo_epi32(_mm256_and_si256(entry, low_mask),
+		                       _mm256_srli_epi32(state, RANS_PROB_BITS)),
+		    _mm256_srli_epi32(entry, 16));
+
+		__m256i const refill = _mm256_cmpgt_epi32(lower, state);
+		unsigned const mask =
+		    static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(refill)));
+		__m256i const index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+		    reinterpret_cast<__m128i const*>(RANS_REFILL_TABLE.index[mask].data())));
+		__m256i const word = _mm256_permutevar8x32_epi32(
+		    _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p))),
+		    index);
+		state = _mm256_blendv_epi8(
+		    state, _mm256_or_si256(_mm256_slli_epi32(state, 16), word), refill);
+		p += sizeof(std::uint16_t) * static_cast<unsigned>(popcount(mask));
+
+		// The symbol is the low byte of each lane
+		__m256i const bytes = _mm256_permutevar8x32_epi32(
+		    _mm256_shuffle_epi8(sym, byte_pick), dword_pick);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out + i),
+		                 _mm256_castsi256_si128(bytes));
+	}
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(x.data()), state);
+#endif
+
+	for (; n - i >= RANS_STREAMS; i += RANS_STREAMS) {
+		for (std::size_t s{}; RANS_STREAMS != s; ++s) {
+			out[i + s] = static_cast<std::uint8_t>(ransDecodeStep(table, x[s], p, end));
+		}
+	}
+	for (std::size_t s{}; n != i; ++i, ++s) {
+		out[i] = static_cast<std::uint8_t>(ransDecodeStep(table, x[s], p, end));
+	}
+}
+
+[[nodiscard]] inline std::uint64_t ransReadHeader(ReadBuffer& in,
+                                                  std::uint32_t& block_size)
+{
+	std::uint64_t size;
+	in.read(size);
+	in.read(block_size);
+	if (0 == block_size && 0 != size) {
+		throw std::runtime_error("rANS: corrupt header");
+	}
+	return size;
+}
+}  // namespace detail
+
+/*!
+ * @brief Compresses `in` with an interleaved rANS entropy coder and appends the result
+ * to `out`.
+ *
+ * Suited for byte streams with a skewed distribution, such as octree child masks and
+ * quantized occupancy values. The data is split into blocks of `block_size` bytes, each
+ * with its own frequency table so the coder follows changes in the distribution. Within
+ * a block, consecutive symbols are coded with 8 independent states, which the decoder
+ * processes in parallel (with AVX2 if available, else through instruction level
+ * parallelism). The format does not depend on the instruction set.
+ *
+ * @param block_size Number of bytes per block, in [1, 2^32).
+ */
+inline void ransEncode(Span<std::uint8_t const> in, WriteBuffer& out,
+                       std::size_t block_size = RANS_BLOCK_SIZE)
+{
+	block_size = std::clamp<std::size_t>(block_size, 1, ~std::uint32_t(0));
+
+	out.write(static_cast<std::uint64_t>(in.size()));
+	out.write(static_cast<std::uint32_t>(block_size));
+	for (std::size_t i{}; in.size() != i;) {
+		std::size_t const n = std::min(block_size, in.size() - i);
+		detail::ransEncodeBlock(in.data() + i, static_cast<std::uint32_t>(n), out);
+		i += n;
+	}
+}
+
+/*!
+ * @brief Compresses the next `count` bytes of `in`, see above.
+ *
+ * @throws std::out_of_range If `in` holds less than `count` bytes.
+ */
+inline void ransEncode(ReadBuffer& in, std::size_t count, WriteBuffer& out,
+                       std::size_t block_size = RANS_BLOCK_SIZE)
+{
+	if (in.readLeft() < count) {
+		throw std::out_of_range("rANS: buffer holds less than " + std::to_string(count) +
+		                        " bytes");
+	}
+	auto const* data = reinterpret_cast<std::uint8_t const*>(in.data()) + in.readPos();
+	ransEncode(Span<std::uint8_t const>(data, count), out, block_size);
+	in.readSkip(count);
+}
+
+/*!
+ * @brief Number of bytes the compressed data at the read position of `in` decodes to.
+ */
+[[nodiscard]] inline std::uint64_t ransDecodedSize(ReadBuffer& in)
+{
+	auto const    pos = in.readPos();
+	std::uint64_t size;
+	in.read(size);
+	in.readPos(pos);
+	return size;
+}
+
+/*!
+ * @brief Decompresses data written by `ransEncode` into `out`, which has to be exactly
+ * `ransDecodedSize(in)` long.
+ *
+ * @throws std::out_of_range If the data is truncated or `out` has the wrong size.
+ * @throws std::runtime_error If the data is corrupt.
+ */
+inline void ransDecode(ReadBuffer& in, Span<std::uint8_t> out)
+{
+	std::uint32_t       block_size;
+	std::uint64_t const size = detail::ransReadHeader(in, block_size);
+	if (out.size() != size) {
+		throw std::out_of_range("rANS: output holds " + std::to_string(out.size()) +
+		                        " bytes, data decodes to " + std::to_string(size));
+	}
+
+	for (std::size_t i{}; size != i;) {
+		std::size_t const n = std::min<std::size_t>(block_size, size - i);
+		detail::ransDecodeBlock(detail::ransReadBlock(in), out.data() + i,
+		                        static_cast<std::uint32_t>(n));
+		i += n;
+	}
+}
+
+/*!
+ * @brief Decompresses data written by `ransEncode` and appends it to `out`.
+ *
+ * `out` grows one block at a time, after the block has been read and checked, so a
+ * corrupt size in the header cannot allocate more than the data backs up. On error, `out`
+ * keeps its size.
+ *
+ * @throws std::out_of_range If the data is truncated.
+ * @throws std::runtime_error If the data is corrupt.
+ */
+inline void ransDecode(ReadBuffer& in, WriteBuffer& out)
+{
+	std::uint32_t       block_size;
+	std::uint64_t const size = detail::ransReadHeader(in, block_size);
+	std::size_t const   pos  = out.writePos();
+	std::size_t const   old  = out.size();
+
+	std::size_t i{};
+	try {
+		while (size != i) {
+			std::size_t const n =
+			    static_cast<std::size_t>(std::min<std::uint64_t>(block_size, size - i));
+			detail::RansBlock const block = detail::ransReadBlock(in);
+			out.resize(std::max(out.size(), pos + i + n));
+			detail::ransDecodeBlock(
+			    block, reinterpret_cast<std::uint8_t*>(out.data()) + pos + i,
+			    static_cast<std::uint32_t>(n));
+			i += n;
+		}
+	} catch (...) {
+		out.resize(old);
+		throw;
+	}
+	out.setWritePos(pos + i);
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_RANS_HPP
@@ -0,0 +1,448 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_RLE_HPP
+#define UFO_UTILITY_RLE_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/io/read_buffer.hpp>
+#include <ufo/utility/io/write_buffer.hpp>
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+namespace detail
+{
+/*!
+ * Shortest run that is coded as a run, shorter ones are cheaper to keep in the
+ * surrounding literals.
+ */
+template <class T>
+inline constexpr std::size_t RLE_MIN_RUN = 1 == sizeof(T) ? 4 : 2;
+
+template <class T>
+[[nodiscard]] T rleLoad(unsigned char const* p) noexcept
+{
+	T value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+#if defined(__AVX2__)
+template <class T>
+[[nodiscard]] __m256i rleBroadcast(T value) noexcept
+{
+	if constexpr (1 == sizeof(T)) {
+		return _mm256_set1_epi8(static_cast<char>(value));
+	} else if constexpr (2 == sizeof(T)) {
+		return _mm256_set1_epi16(static_cast<short>(value));
+	} else if constexpr (4 == sizeof(T)) {
+		return _mm256_set1_epi32(static_cast<int>(value));
+	} else {
+		return _mm256_set1_epi64x(static_cast<long long>(value));
+	}
+}
+
+// Byte mask of the elements of `a` and `b` that are equal, all bytes of an element are
+// set or cleared together
+template <class T>
+[[nodiscard]] std::uint32_t rleEqualMask(__m256i a, __m256i b) noexcept
+{
+	__m256i eq;
+	if constexpr (1 == sizeof(T)) {
+		eq = _mm256_cmpeq_epi8(a, b);
+	} else if constexpr (2 == sizeof(T)) {
+		eq = _mm256_cmpeq_epi16(a, b);
+	} else if constexpr (4 == sizeof(T)) {
+		eq = _mm256_cmpeq_epi32(a, b);
+	} else {
+		eq = _mm256_cmpeq_epi64(a, b);
+	}
+	return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+}
+#endif
+
+/*!
+ * Number of elements, starting at `first`, that are equal to the one at `first`.
+ */
+template <class T>
+[[nodiscard]] std::size_t rleRunLength(unsigned char const* data, std::size_t first,
+                                       std::size_t n) noexcept
+{
+	T const     value = rleLoad<T>(data + first * sizeof(T));
+	std::size_t i     = first + 1;
+
+#if defined(__AVX2__)
+	constexpr std::size_t W       = 32 / sizeof(T);
+	__m256i const         pattern = rleBroadcast(value);
+	for (; n >= i + W; i += W) {
+		std::uint32_t const ne = ~rleEqualMask<T>(
+		    _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + i * sizeof(T))),
+		    pattern);
+		if (ne) {
+			return i - first + static_cast<std::size_t>(countrZero(ne)) / sizeof(T);
+		}
+	}
+#endif
+
+	for (; n > i && value == rleLoad<T>(data + i * sizeof(T)); ++i) {
+	}
+	return i - first;
+}
+
+/*!
+ * First position at or after `first` where a run of at least `RLE_MIN_RUN` equal
+ * elements starts, or `n` if there is none.
+ */
+template <class T>
+[[nodiscard]] std::size_t rleFindRun(unsigned char const* data, std::size_t first,
+                                     std::size_t n) noexcept
+{
+	// Number of consecutive equal neighbours that make a run
+	constexpr std::size_t K = RLE_MIN_RUN<T> - 1;
+
+	std::size_t i = first;
+
+#if defined(__AVX2__)
+	// Each element is compared with the next one, a run starts where K comparisons in a
+	// row are equal. Only starts whose comparisons all fall within the vector are
+	// reported, the others are looked at again in the next step.
+	constexpr std::size_t   W     = 32 / sizeof(T);
+	constexpr std::size_t   STEP  = W - (K - 1);
+	constexpr std::uint64_t VALID = (std::uint64_t(1) << (STEP * sizeof(T))) - 1;
+	for (; n >= i + W + 1; i += STEP) {
+		unsigned char const* p = data + i * sizeof(T);
+		std::uint32_t const  eq =
+		    rleEqualMask<T>(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(p)),
+		                    _mm256_loadu_si256(
+		                        reinterpret_cast<__m256i const*>(p + sizeof(T))));
+		std::uint32_t start = eq;
+		for (std::size_t k = 1; K != k; ++k) {
+			start &= eq >> (k * sizeof(T));
+		}
+		start &= static_cast<std::uint32_t>(VALID);
+		if (start) {
+			return i + static_cast<std::size_t>(countrZero(start)) / sizeof(T);
+		}
+	}
+#endif
+
+	for (std::size_t equal{}; n > i + 1; ++i) {
+		equal = rleLoad<T>(data + i * sizeof(T)) == rleLoad<T>(data + (i + 1) * sizeof(T))
+		            ? equal + 1
+		            : 0;
+		if (K == equal) {
+			return i + 1 - K;
+		}
+	}
+	return n;
+}
+
+template <class T>
+void rleFill(unsigned char* dst, T value, std::size_t count) noexcept
+{
+	std::size_t i{};
+#if defined(__AVX2__)
+	constexpr std::size_t W       = 32 / sizeof(T);
+	__m256i const         pattern = rleBroadcast(value);
+	for (; count >= i + W; i += W) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * sizeof(T)), pattern);
+	}
+#endif
+	for (; count > i; ++i) {
+		std::memcpy(dst + i * sizeof(T), &value, sizeof(T));
+	}
+}
+
+/*!
+ * Gathers the small writes of the encoder, large literal runs are passed straight
+ * through to the buffer.
+ */
+class RleSink
+{
+	static constexpr std::size_t STAGE_SIZE = 4096;
+
+ public:
+	explicit RleSink(WriteBuffer& out) noexcept : out_(out) {}
+
+	void put(void const* src, std::size_t count)
+	{
+		if (STAGE_SIZE - len_ < count) {
+			flush();
+			if (STAGE_SIZE < count) {
+				out_.write(src, count);
+				return;
+			}
+		}
+		std::memcpy(stage_.data() + len_, src, count);
+		len_ += count;
+	}
+
+	void putVarint(std::uint64_t value)
+	{
+		std::array<unsigned char, 10> buf;
+		std::size_t                   n{};
+		for (; 0x80 <= value; value >>= 7) {
+			buf[n++] = static_cast<unsigned char>(value | 0x80);
+		}
+		buf[n++] = static_cast<unsigned char>(value);
+		put(buf.data(), n);
+	}
+
+	void flush()
+	{
+		if (len_) {
+			out_.write(stage_.data(), len_);
+			len_ = 0;
+		}
+	}
+
+ private:
+	WriteBuffer&                          out_;
+	std::array<unsigned char, STAGE_SIZE> stage_;
+	std::size_t                           len_{};
+};
+
+[[nodiscard]] inline std::uint64_t rleReadVarint(unsigned char const*& p,
+                                                 unsigned char const*  end)
+{
+	std::uint64_t value{};
+	for (unsigned shift{}; end > p && 64 > shift; shift += 7) {
+		unsigned char const b = *p++;
+		value |= std::uint64_t(b & 0x7F) << shift;
+		if (!(b & 0x80)) {
+			return value;
+		}
+	}
+	throw std::runtime_error("RLE: corrupt data");
+}
+
+template <class T>
+void rleEncode(unsigned char const* data, std::size_t n, WriteBuffer& out)
+{
+	out.write(static_cast<std::uint64_t>(n));
+	out.write(static_cast<std::uint8_t>(sizeof(T)));
+
+	RleSink     sink(out);
+	std::size_t literal{};
+	while (n > literal) {
+		std::size_t const run = rleFindRun<T>(data, literal, n);
+		sink.putVarint(run - literal);
+		sink.put(data + literal * sizeof(T), (run - literal) * sizeof(T));
+		if (n == run) {
+			sink.putVarint(0);
+			break;
+		}
+
+		std::size_t const len = rleRunLength<T>(data, run, n);
+		sink.putVarint(len);
+		sink.put(data + run * sizeof(T), sizeof(T));
+		literal = run + len;
+	}
+	sink.flush();
+}
+
+template <class T>
+[[nodiscard]] std::uint64_t rleReadHeader(ReadBuffer& in)
+{
+	std::uint64_t size;
+	std::uint8_t  element_size;
+	in.read(size);
+	in.read(element_size);
+	if (sizeof(T) != element_size) {
+		throw std::invalid_argument("RLE: data has " + std::to_string(element_size) +
+		                            " byte elements, not " + std::to_string(sizeof(T)));
+	}
+	return size;
+}
+
+template <class T>
+void rleDecode(ReadBuffer& in, unsigned char* out, std::uint64_t n)
+{
+	auto const* begin = reinterpret_cast<unsigned char const*>(in.data()) + in.readPos();
+	auto const* end   = reinterpret_cast<unsigned char const*>(in.data()) + in.size();
+	auto const* p     = begin;
+
+	for (std::uint64_t i{}; n != i;) {
+		std::uint64_t const literal = rleReadVarint(p, end);
+		if (n - i < literal ||
+		    static_cast<std::uint64_t>(end - p) / sizeof(T) < literal) {
+			throw std::runtime_error("RLE: corrupt data");
+		}
+		std::memcpy(out + i * sizeof(T), p, literal * sizeof(T));
+		p += literal * sizeof(T);
+		i += literal;
+
+		std::uint64_t const run = rleReadVarint(p, end);
+		if (0 == run) {
+			continue;
+		}
+		if (n - i < run || static_cast<std::size_t>(end - p) < sizeof(T)) {
+			throw std::runtime_error("RLE: corrupt data");
+		}
+		rleFill(out + i * sizeof(T), rleLoad<T>(p), run);
+		p += sizeof(T);
+		i += run;
+	}
+
+	in.readSkip(static_cast<std::size_t>(p - begin));
+}
+}  // namespace detail
+
+/*!
+ * @brief Run-length encodes `in` and appends the result to `out`.
+ *
+ * The output alternates between literals, stored as their count followed by the
+ * elements, and runs, stored as their length followed by the element once. Runs are
+ * found by comparing 32 bytes at a time (with AVX2 if available), so long runs, such
+ * as the unknown space in a dense grid, are both encoded and decoded at close to memory
+ * speed. Since the output is still a byte stream it can be used as a pre-pass before
+ * a general compressor or `ransEncode`.
+ *
+ * @tparam T Unsigned integer type of the elements, runs are of equal elements. Use e.g.
+ * `std::uint32_t` for `float` fields.
+ */
+template <class T = std::uint8_t>
+void rleEncode(Span<T const> in, WriteBuffer& out)
+{
+	static_assert(std::is_unsigned_v<T> && !std::is_same_v<T, bool>,
+	              "rleEncode requires an unsigned integer type");
+	detail::rleEncode<T>(reinterpret_cast<unsigned char const*>(in.data()), in.size(),
+	                     out);
+}
+
+/*!
+ * @brief Run-length encodes the next `count` elements of `in`, see above.
+ *
+ * @throws std::out_of_range If `in` holds less than `count` elements.
+ */
+template <class T = std::uint8_t>
+void rleEncode(ReadBuffer& in, std::size_t count, WriteBuffer& out)
+{
+	static_assert(std::is_unsigned_v<T> && !std::is_same_v<T, bool>,
+	              "rleEncode requires an unsigned integer type");
+	if (in.readLeft() / sizeof(T) < count) {
+		throw std::out_of_range("RLE: buffer holds less than " + std::to_string(count) +
+		                        " elements");
+	}
+	detail::rleEncode<T>(
+	    reinterpret_cast<unsigned char const*>(in.data()) + in.readPos(), count, out);
+	in.readSkip(count * sizeof(T));
+}
+
+/*!
+ * @brief Number of elements the encoded data at the read position of `in` decodes to.
+ */
+[[nodiscard]] inline std::uint64_t rleDecodedSize(ReadBuffer& in)
+{
+	auto const    pos = in.readPos();
+	std::uint64_t size;
+	in.read(size);
+	in.readPos(pos);
+	return size;
+}
+
+/*!
+ * @brief Decodes data written by `rleEncode` into `out`, which has to be exactly
+ * `rleDecodedSize(in)` long.
+ *
+ * @throws std::invalid_argument If the data was encoded with a different `T`.
+ * @throws std::out_of_range If `out` has the wrong size.
+ * @throws std::runtime_error If the data is truncated or corrupt.
+ */
+template <class T = std::uint8_t>
+void rleDecode(ReadBuffer& in, Span<T> out)
+{
+	std::uint64_t const size = detail::rleReadHeader<T>(in);
+	if (out.size() != size) {
+		throw std::out_of_range("RLE: output holds " + std::to_string(out.size()) +
+		                        " elements, data decodes to " + std::to_string(size));
+	}
+	detail::rleDecode<T>(in, reinterpret_cast<unsigned char*>(out.data()), size);
+}
+
+/*!
+ * @brief Decodes data written by `rleEncode` and appends it to `out`.
+ *
+ * @throws std::invalid_argument If the data was encoded with a different `T`.
+ * @throws std::runtime_error If the data is truncated or corrupt, the size of `out` is
+ * left unchanged.
+ */
+template <class T = std::uint8_t>
+void rleDecode(ReadBuffer& in, WriteBuffer& out)
+{
+	std::uint64_t const size = detail::rleReadHeader<T>(in);
+	std::size_t const   pos  = out.writePos();
+	// A corrupt size could otherwise wrap the byte count and the decoder write past the
+	// end of the buffer
+	if ((std::numeric_limits<std::size_t>::max() - pos) / sizeof(T) < size) {
+		throw std::runtime_error("RLE: corrupt data");
+	}
+	std::size_t const bytes = static_cast<std::size_t>(size) * sizeof(T);
+	std::size_t const old   = out.size();
+	out.resize(std::max(old, pos + bytes));
+	try {
+		detail::rleDecode<T>(in, reinterpret_cast<unsigned char*>(out.data()) + pos, size);
+	} catch (...) {
+		out.resize(old);
+		throw;
+	}
+	out.setWritePos(pos + bytes);
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_RLE_HPP
@@ -42,6 +42,9 @@
 #ifndef UFO_UTILITY_MACROS
 #define UFO_UTILITY_MACROS
 
+// UFO
+#include <ufo/utility/sorting_network.hpp>
+
 #define UFO_REPEAT_2(M, N)   M(N) M(N + 1)
 #define UFO_REPEAT_4(M, N)   UFO_REPEAT_2(M, N) UFO_REPEAT_2(M, N + 2)
 #define UFO_REPEAT_8(M, N)   UFO_REPEAT_4(M, N) UFO_REPEAT_4(M, N + 4)
@@ -55,186 +58,31 @@
 #define UFO_CLAMP(v, lo, hi)     UFO_MAX(lo, UFO_MIN(hi, v))
 #define UFO_MIN_PAIR_FIRST(a, b) ((a).first < (b).first ? (a) : (b))
 #define UFO_MAX_PAIR_FIRST(a, b) ((a).first < (b).first ? (b) : (a))
-#define UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, i, j) \
-	{                                                 \
-		auto const a = UFO_MIN_PAIR_FIRST(c[i], c[j]);  \
-		c[j]         = UFO_MAX_PAIR_FIRST(c[i], c[j]);  \
-		c[i]         = a;                               \
-	}
-
-#define UFO_MIN_2(c)            \
-	{                             \
-		c[0] = UFO_MIN(c[0], c[1]); \
-	}
-
-#define UFO_MIN_3(c)            \
-	{                             \
-		c[0] = UFO_MIN(c[0], c[2]); \
-		UFO_MIN_2(c);               \
-	}
-
-#define UFO_MIN_4(c)            \
-	{                             \
-		c[0] = UFO_MIN(c[0], c[2]); \
-		c[1] = UFO_MIN(c[1], c[3]); \
-		UFO_MIN_2(c);               \
-	}
-
-#define UFO_MIN_8(c)            \
-	{                             \
-		c[0] = UFO_MIN(c[0], c[4]); \
-		c[1] = UFO_MIN(c[1], c[5]); \
-		c[2] = UFO_MIN(c[2], c[6]); \
-		c[3] = UFO_MIN(c[3], c[7]); \
-		UFO_MIN_4(c);               \
-	}
-
-#define UFO_MIN_16(c)            \
-	{                              \
-		c[0] = UFO_MIN(c[0], c[8]);  \
-		c[1] = UFO_MIN(c[1], c[9]);  \
-		c[2] = UFO_MIN(c[2], c[10]); \
-		c[3] = UFO_MIN(c[3], c[11]); \
-		c[4] = UFO_MIN(c[4], c[12]); \
-		c[5] = UFO_MIN(c[5], c[13]); \
-		c[6] = UFO_MIN(c[6], c[14]); \
-		c[7] = UFO_MIN(c[7], c[15]); \
-		UFO_MIN_8(c);                \
-	}
 
-#define UFO_MIN_PAIR_FIRST_2(c)            \
-	{                                        \
-		c[0] = UFO_MIN_PAIR_FIRST(c[0], c[1]); \
-	}
+// The reductions and sorts below forward to the generic versions in
+// `sorting_network.hpp`, which also handle other sizes and key projections.
 
-#define UFO_MIN_PAIR_FIRST_4(c)            \
-	{                                        \
-		c[0] = UFO_MIN_PAIR_FIRST(c[0], c[2]); \
-		c[1] = UFO_MIN_PAIR_FIRST(c[1], c[3]); \
-		UFO_MIN_PAIR_FIRST_2(c);               \
-	}
-
-#define UFO_MIN_PAIR_FIRST_8(c)            \
-	{                                        \
-		c[0] = UFO_MIN_PAIR_FIRST(c[0], c[4]); \
-		c[1] = UFO_MIN_PAIR_FIRST(c[1], c[5]); \
-		c[2] = UFO_MIN_PAIR_FIRST(c[2], c[6]); \
-		c[3] = UFO_MIN_PAIR_FIRST(c[3], c[7]); \
-		UFO_MIN_PAIR_FIRST_4(c);               \
-	}
-
-#define UFO_MIN_PAIR_FIRST_16(c)            \
-	{                                         \
-		c[0] = UFO_MIN_PAIR_FIRST(c[0], c[8]);  \
-		c[1] = UFO_MIN_PAIR_FIRST(c[1], c[9]);  \
-		c[2] = UFO_MIN_PAIR_FIRST(c[2], c[10]); \
-		c[3] = UFO_MIN_PAIR_FIRST(c[3], c[11]); \
-		c[4] = UFO_MIN_PAIR_FIRST(c[4], c[12]); \
-		c[5] = UFO_MIN_PAIR_FIRST(c[5], c[13]); \
-		c[6] = UFO_MIN_PAIR_FIRST(c[6], c[14]); \
-		c[7] = UFO_MIN_PAIR_FIRST(c[7], c[15]); \
-		UFO_MIN_PAIR_FIRST_8(c);                \
-	}
-
-#define UFO_SORT_ASCENDING_PAIR_FIRST_2(c)       \
-	{                                              \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 1); \
-	}
-
-#define UFO_SORT_ASCENDING_PAIR_FIRST_4(c)       \
-	{                                              \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 2); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 3); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 1); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 3); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 2); \
-	}
-
-#define UFO_SORT_ASCENDING_PAIR_FIRST_8(c)       \
-	{                                              \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 2); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 3); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 4, 6); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 5, 7); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 4); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 5); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 6); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 7); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 1); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 3); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 4, 5); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 6, 7); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 4); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 5); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 4); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 6); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 2); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 4); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 5, 6); \
-	}
-
-#define UFO_SORT_ASCENDING_PAIR_FIRST_16(c)        \
-	{                                                \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 13);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 12);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 15);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 14);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 4, 8);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 5, 6);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 7, 11);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 9, 10);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 5);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 7);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 9);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 4);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 6, 13);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 8, 14);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 10, 15); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 11, 12); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 1);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 3);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 4, 5);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 6, 8);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 7, 9);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 10, 11); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 12, 13); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 14, 15); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 0, 2);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 3);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 4, 10);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 5, 11);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 6, 7);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 8, 9);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 12, 14); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 13, 15); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 2);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 12);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 4, 6);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 5, 7);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 8, 10);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 9, 11);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 13, 14); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 1, 4);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 6);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 5, 8);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 7, 10);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 9, 13);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 11, 14); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 2, 4);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 6);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 9, 12);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 11, 13); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 5);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 6, 8);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 7, 9);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 10, 12); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 3, 4);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 5, 6);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 7, 8);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 9, 10);  \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 11, 12); \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 6, 7);   \
-		UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, 8, 9);   \
-	}
+#define UFO_SORT_ASCENDING_PAIR_FIRST_SWAP(c, i, j) \
+	ufo::compareExchange((c)[i], (c)[j], ufo::PairFirst{})
+
+#define UFO_MIN_N(c, N)            (c)[0] = ufo::reduceMin<N>(&(c)[0])
+#define UFO_MIN_2(c)               UFO_MIN_N(c, 2)
+#define UFO_MIN_3(c)               UFO_MIN_N(c, 3)
+#define UFO_MIN_4(c)               UFO_MIN_N(c, 4)
+#define UFO_MIN_8(c)               UFO_MIN_N(c, 8)
+#define UFO_MIN_16(c)              UFO_MIN_N(c, 16)
+
+#define UFO_MIN_PAIR_FIRST_N(c, N) (c)[0] = ufo::reduceMin<N>(&(c)[0], ufo::PairFirst{})
+#define UFO_MIN_PAIR_FIRST_2(c)    UFO_MIN_PAIR_FIRST_N(c, 2)
+#define UFO_MIN_PAIR_FIRST_4(c)    UFO_MIN_PAIR_FIRST_N(c, 4)
+#define UFO_MIN_PAIR_FIRST_8(c)    UFO_MIN_PAIR_FIRST_N(c, 8)
+#define UFO_MIN_PAIR_FIRST_16(c)   UFO_MIN_PAIR_FIRST_N(c, 16)
+
+#define UFO_SORT_ASCENDING_PAIR_FIRST_N(c, N) \
+	ufo::sortNetwork<N>(&(c)[0], ufo::PairFirst{})
+#define UFO_SORT_ASCENDING_PAIR_FIRST_2(c)  UFO_SORT_ASCENDING_PAIR_FIRST_N(c, 2)
+#define UFO_SORT_ASCENDING_PAIR_FIRST_4(c)  UFO_SORT_ASCENDING_PAIR_FIRST_N(c, 4)
+#define UFO_SORT_ASCENDING_PAIR_FIRST_8(c)  UFO_SORT_ASCENDING_PAIR_FIRST_N(c, 8)
+#define UFO_SORT_ASCENDING_PAIR_FIRST_16(c) UFO_SORT_ASCENDING_PAIR_FIRST_N(c, 16)
 
 #endif  // UFO_UTILITY_MACROS
\ No newline at end of file
@@ -0,0 +1,217 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_MONOTONIC_ARENA_HPP
+#define UFO_UTILITY_MONOTONIC_ARENA_HPP
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ufo
+{
+/*!
+ * @brief Bump allocator over large blocks.
+ *
+ * Allocating is a pointer bump and deallocating does nothing; all memory is given back
+ * at once with `reset`, e.g., at the end of every frame/integration. Unlike
+ * `std::pmr::monotonic_buffer_resource`, `reset` keeps the memory: if the previous
+ * round needed several blocks they are replaced by a single block of the combined
+ * size, so after the first round a steady workload no longer touches the upstream
+ * resource at all.
+ *
+ * Not thread-safe, use one arena per thread (see `PerThread`).
+ */
+class MonotonicArena final : public std::pmr::memory_resource
+{
+	struct Block {
+		Block*      next;
+		std::size_t size;
+	};
+
+	static constexpr std::size_t HEADER_SIZE =
+	    (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+ public:
+	static constexpr std::size_t DEFAULT_BLOCK_SIZE = std::size_t(64) << 10;
+
+	explicit MonotonicArena(
+	    std::size_t                 initial_size = DEFAULT_BLOCK_SIZE,
+	    std::pmr::memory_resource* upstream      = std::pmr::get_default_resource())
+	    : upstream_(upstream), next_size_(std::max(initial_size, 2 * HEADER_SIZE))
+	{
+	}
+
+	MonotonicArena(MonotonicArena const&)            = delete;
+	MonotonicArena& operator=(MonotonicArena const&) = delete;
+
+	~MonotonicArena() override { release(); }
+
+	/*!
+	 * @brief Invalidates all allocations, keeping the memory for reuse.
+	 */
+	void reset() noexcept
+	{
+		if (nullptr == head_) {
+			return;
+		}
+
+		if (nullptr != head_->next) {
+			std::size_t const total = capacity() + HEADER_SIZE;
+			release();
+			// If this fails we simply allocate on demand again later
+			try {
+				newBlock(total);
+			} catch (std::bad_alloc const&) {
+				return;
+			}
+		}
+
+		cur_  = reinterpret_cast<std::uintptr_t>(head_) + HEADER_SIZE;
+		used_ = 0;
+	}
+
+	/*!
+	 * @brief Invalidates all allocations and returns the memory to the upstream
+	 * resource.
+	 */
+	void release() noexcept
+	{
+		while (nullptr != head_) {
+			Block* next = head_->next;
+			upstream_->deallocate(head_, head_->size, alignof(std::max_align_t));
+			head_ = next;
+		}
+		cur_  = 0;
+		end_  = 0;
+		used_ = 0;
+	}
+
+	/*!
+	 * @brief Constructs a `T` in the arena.
+	 *
+	 * @note The destructor is never called, so `T` should be trivially destructible or
+	 * the caller has to destroy it before `reset`.
+	 */
+	template <class T, class... Args>
+	[[nodiscard]] T* create(Args&&... args)
+	{
+		return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	/*!
+	 * @brief Number of bytes handed out since the last `reset`/`release`.
+	 */
+	[[nodiscard]] std::size_t used() const noexcept { return used_; }
+
+	/*!
+	 * @brief Number of bytes currently held from the upstream resource, excluding
+	 * bookkeeping.
+	 */
+	[[nodiscard]] std::size_t capacity() const noexcept
+	{
+		std::size_t c{};
+		for (Block* b = head_; nullptr != b; b = b->next) {
+			c += b->size - HEADER_SIZE;
+		}
+		return c;
+	}
+
+	[[nodiscard]] std::pmr::memory_resource* upstream() const noexcept
+	{
+		return upstream_;
+	}
+
+ protected:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		std::uintptr_t const p = (cur_ + alignment - 1) & ~(alignment - 1);
+		if (p + bytes > end_ || 0 == cur_) {
+			return allocateSlow(bytes, alignment);
+		}
+		cur_ = p + bytes;
+		used_ += bytes;
+		return reinterpret_cast<void*>(p);
+	}
+
+	void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+	[[nodiscard]] bool do_is_equal(
+	    std::pmr::memory_resource const& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+ private:
+	void* allocateSlow(std::size_t bytes, std::size_t alignment)
+	{
+		// Blocks grow geometrically so the number of blocks stays logarithmic
+		newBlock(std::max(next_size_, HEADER_SIZE + bytes + alignment));
+		next_size_ *= 2;
+		return do_allocate(bytes, alignment);
+	}
+
+	void newBlock(std::size_t size)
+	{
+		Block* b = static_cast<Block*>(upstream_->allocate(size, alignof(std::max_align_t)));
+		b->next  = head_;
+		b->size  = size;
+		head_    = b;
+		cur_     = reinterpret_cast<std::uintptr_t>(b) + HEADER_SIZE;
+		end_     = reinterpret_cast<std::uintptr_t>(b) + size;
+	}
+
+ private:
+	std::pmr::memory_resource* upstream_;
+	Block*                     head_{};
+	std::uintptr_t             cur_{};
+	std::uintptr_t             end_{};
+	std::size_t                used_{};
+	std::size_t                next_size_;
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_MONOTONIC_ARENA_HPP
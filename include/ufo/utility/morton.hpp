@@ -0,0 +1,691 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_MORTON_HPP
+#define UFO_UTILITY_MORTON_HPP
+
+// UFO
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if defined(__BMI2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if __cplusplus >= 202002L
+#define UFO_MORTON_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif (defined(__clang__) && 9 <= __clang_major__) || \
+    (!defined(__clang__) && defined(__GNUC__) && 9 <= __GNUC__)
+#define UFO_MORTON_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+// `pdep`/`pext` are microcoded (and much slower than the magic bits) on AMD before Zen
+// 3, define `UFO_MORTON_NO_PDEP` to not use them when targeting such processors
+#if defined(__BMI2__) && defined(UFO_MORTON_CONSTANT_EVALUATED) && \
+    !defined(UFO_MORTON_NO_PDEP)
+#define UFO_MORTON_PDEP 1
+#endif
+
+namespace ufo
+{
+#if defined(__SIZEOF_INT128__)
+__extension__ using Morton128 = unsigned __int128;
+#endif
+
+namespace detail
+{
+template <class Code>
+inline constexpr int CODE_BITS = static_cast<int>(sizeof(Code) * CHAR_BIT);
+
+template <class Code, std::size_t Dim>
+inline constexpr int MORTON_COORD_BITS = CODE_BITS<Code> / static_cast<int>(Dim);
+}  // namespace detail
+
+/*!
+ * @brief The coordinate type of a `Dim` dimensional Morton code of type `Code`, i.e.,
+ * the smallest of `std::uint32_t` and `std::uint64_t` that can hold
+ * `bits(Code) / Dim` bits.
+ */
+template <class Code, std::size_t Dim>
+using MortonCoord = std::conditional_t<(32 < detail::MORTON_COORD_BITS<Code, Dim>),
+                                       std::uint64_t, std::uint32_t>;
+
+namespace detail
+{
+/*!
+ * @brief The positions of the coordinate bits after the spread step working on groups
+ * of `group` bits, bit `i` ends up at `(i / group) * group * Dim + i % group`.
+ */
+template <class Code, std::size_t Dim>
+[[nodiscard]] constexpr Code mortonMask(int group) noexcept
+{
+	Code mask{};
+	for (int i{}; MORTON_COORD_BITS<Code, Dim> != i; ++i) {
+		mask |= Code(1) << ((i / group) * group * static_cast<int>(Dim) + i % group);
+	}
+	return mask;
+}
+
+template <class Code, std::size_t Dim>
+[[nodiscard]] constexpr int mortonSteps() noexcept
+{
+	int steps{};
+	for (int g = 1; MORTON_COORD_BITS<Code, Dim> > g; g *= 2) {
+		++steps;
+	}
+	return steps;
+}
+
+template <class Code, std::size_t Dim, std::size_t... Is>
+[[nodiscard]] constexpr std::array<Code, sizeof...(Is)> mortonMasks(
+    std::index_sequence<Is...>) noexcept
+{
+	return {mortonMask<Code, Dim>(1 << Is)...};
+}
+
+// `MORTON_MASKS[k]` are the bit positions after spreading in groups of `2^k` bits, so
+// the first is the final layout and the last the coordinate itself
+template <class Code, std::size_t Dim>
+inline constexpr std::array<Code, mortonSteps<Code, Dim>() + 1> MORTON_MASKS =
+    mortonMasks<Code, Dim>(std::make_index_sequence<mortonSteps<Code, Dim>() + 1>{});
+
+template <class Code, std::size_t Dim, std::size_t Axis>
+inline constexpr Code MORTON_AXIS_MASK = MORTON_MASKS<Code, Dim>[0] << Axis;
+
+template <class Code, std::size_t Dim, int K>
+[[nodiscard]] constexpr Code mortonSpreadStep(Code x) noexcept
+{
+	return (x | (x << ((1 << K) * static_cast<int>(Dim - 1)))) & MORTON_MASKS<Code, Dim>[K];
+}
+
+template <class Code, std::size_t Dim, int K>
+[[nodiscard]] constexpr Code mortonCompactStep(Code x) noexcept
+{
+	return (x | (x >> ((1 << K) * static_cast<int>(Dim - 1)))) &
+	       MORTON_MASKS<Code, Dim>[K + 1];
+}
+
+// The steps are unrolled at compile time so the shifts and masks are immediates
+
+template <class Code, std::size_t Dim, int... Ks>
+[[nodiscard]] constexpr Code mortonSpread(Code x,
+                                          std::integer_sequence<int, Ks...>) noexcept
+{
+	constexpr int steps = mortonSteps<Code, Dim>();
+	x &= MORTON_MASKS<Code, Dim>[steps];
+	((x = mortonSpreadStep<Code, Dim, steps - 1 - Ks>(x)), ...);
+	return x;
+}
+
+template <class Code, std::size_t Dim, int... Ks>
+[[nodiscard]] constexpr Code mortonCompact(Code x,
+                                           std::integer_sequence<int, Ks...>) noexcept
+{
+	x &= MORTON_MASKS<Code, Dim>[0];
+	((x = mortonCompactStep<Code, Dim, Ks>(x)), ...);
+	return x;
+}
+
+template <class Code, std::size_t Dim>
+[[nodiscard]] constexpr Code mortonSpread(Code x) noexcept
+{
+	return mortonSpread<Code, Dim>(
+	    x, std::make_integer_sequence<int, mortonSteps<Code, Dim>()>{});
+}
+
+template <class Code, std::size_t Dim>
+[[nodiscard]] constexpr Code mortonCompact(Code x) noexcept
+{
+	return mortonCompact<Code, Dim>(
+	    x, std::make_integer_sequence<int, mortonSteps<Code, Dim>()>{});
+}
+
+#if defined(UFO_MORTON_PDEP)
+template <class Code>
+[[nodiscard]] inline Code pdep(Code x, Code mask) noexcept
+{
+	if constexpr (4 == sizeof(Code)) {
+		return _pdep_u32(x, mask);
+	} else {
+		return _pdep_u64(x, mask);
+	}
+}
+
+template <class Code>
+[[nodiscard]] inline Code pext(Code x, Code mask) noexcept
+{
+	if constexpr (4 == sizeof(Code)) {
+		return _pext_u32(x, mask);
+	} else {
+		return _pext_u64(x, mask);
+	}
+}
+#endif
+
+template <class Code, std::size_t Dim, std::size_t... Is>
+[[nodiscard]] constexpr Code mortonEncode(
+    std::array<MortonCoord<Code, Dim>, Dim> const& c, std::index_sequence<Is...>) noexcept
+{
+#if defined(UFO_MORTON_PDEP)
+	if constexpr (4 == sizeof(Code) || 8 == sizeof(Code)) {
+		if (!UFO_MORTON_CONSTANT_EVALUATED()) {
+			return (pdep(static_cast<Code>(c[Is]), MORTON_AXIS_MASK<Code, Dim, Is>) | ...);
+		}
+	}
+#endif
+	return ((mortonSpread<Code, Dim>(static_cast<Code>(c[Is])) << Is) | ...);
+}
+
+template <class Code, std::size_t Dim, std::size_t... Is>
+[[nodiscard]] constexpr std::array<MortonCoord<Code, Dim>, Dim> mortonDecode(
+    Code code, std::index_sequence<Is...>) noexcept
+{
+	using Coord = MortonCoord<Code, Dim>;
+#if defined(UFO_MORTON_PDEP)
+	if constexpr (4 == sizeof(Code) || 8 == sizeof(Code)) {
+		if (!UFO_MORTON_CONSTANT_EVALUATED()) {
+			return {static_cast<Coord>(pext(code, MORTON_AXIS_MASK<Code, Dim, Is>))...};
+		}
+	}
+#endif
+	return {static_cast<Coord>(mortonCompact<Code, Dim>(code >> Is))...};
+}
+}  // namespace detail
+
+/*!
+ * @brief Interleaves the bits of `x` and `y` into a 2D Morton (Z-order) code, with `x`
+ * in the least significant bit.
+ *
+ * Uses `pdep` when compiling for BMI2 and the magic bits method otherwise (and in
+ * constant expressions). Bits of the coordinates that do not fit in the code, i.e.,
+ * above `bits(Code) / 2`, are ignored.
+ *
+ * @tparam Code `std::uint32_t`, `std::uint64_t`, or `Morton128` where supported.
+ */
+template <class Code = std::uint64_t>
+[[nodiscard]] constexpr Code mortonEncode(MortonCoord<Code, 2> x,
+                                          MortonCoord<Code, 2> y) noexcept
+{
+	return detail::mortonEncode<Code, 2>({x, y}, std::make_index_sequence<2>{});
+}
+
+/*!
+ * @brief Interleaves the bits of `x`, `y`, and `z` into a 3D Morton (Z-order) code,
+ * with `x` in the least significant bit.
+ *
+ * Bits of the coordinates above `bits(Code) / 3` are ignored, so a 64 bit code holds
+ * 21 bits per coordinate and a 32 bit code 10.
+ *
+ * @tparam Code `std::uint32_t`, `std::uint64_t`, or `Morton128` where supported.
+ */
+template <class Code = std::uint64_t>
+[[nodiscard]] constexpr Code mortonEncode(MortonCoord<Code, 3> x, MortonCoord<Code, 3> y,
+                                          MortonCoord<Code, 3> z) noexcept
+{
+	return detail::mortonEncode<Code, 3>({x, y, z}, std::make_index_sequence<3>{});
+}
+
+/*!
+ * @brief Inverse of `mortonEncode`, returns the `Dim` coordinates of `code`.
+ */
+template <std::size_t Dim, class Code>
+[[nodiscard]] constexpr std::array<MortonCoord<Code, Dim>, Dim> mortonDecode(
+    Code code) noexcept
+{
+	static_assert(2 == Dim || 3 == Dim, "Morton codes are 2D or 3D");
+	return detail::mortonDecode<Code, Dim>(code, std::make_index_sequence<Dim>{});
+}
+
+namespace detail
+{
+// Number of coordinate bits per chunk of the decode table, the chunk is `Dim` times as
+// large, i.e., 8 bits (256 entries) in 2D and 9 bits (512 entries) in 3D
+template <std::size_t Dim>
+inline constexpr int MORTON_LUT_BITS = 9 / static_cast<int>(Dim);
+
+template <std::size_t Dim>
+[[nodiscard]] constexpr std::array<std::uint32_t, 256> mortonEncodeLut() noexcept
+{
+	std::array<std::uint32_t, 256> lut{};
+	for (std::uint32_t b{}; 256 != b; ++b) {
+		for (std::uint32_t i{}; 8 != i; ++i) {
+			lut[b] |= ((b >> i) & 1u) << (i * Dim);
+		}
+	}
+	return lut;
+}
+
+template <std::size_t Dim>
+[[nodiscard]] constexpr auto mortonDecodeLut() noexcept
+{
+	constexpr int bits = MORTON_LUT_BITS<Dim>;
+
+	std::array<std::uint16_t, std::size_t(1) << (bits * Dim)> lut{};
+	for (std::size_t c{}; lut.size() != c; ++c) {
+		for (std::size_t i{}; bits * Dim != i; ++i) {
+			lut[c] |= static_cast<std::uint16_t>(((c >> i) & 1u)
+			                                     << ((i % Dim) * bits + i / Dim));
+		}
+	}
+	return lut;
+}
+
+// Spreads each of the 8 bits of the index `Dim` apart
+template <std::size_t Dim>
+inline constexpr std::array<std::uint32_t, 256> MORTON_ENCODE_LUT =
+    mortonEncodeLut<Dim>();
+
+// Maps `Dim * MORTON_LUT_BITS<Dim>` code bits to `MORTON_LUT_BITS<Dim>` bits of each
+// coordinate, coordinate `d` starting at bit `d * MORTON_LUT_BITS<Dim>`
+template <std::size_t Dim>
+inline constexpr auto MORTON_DECODE_LUT = mortonDecodeLut<Dim>();
+}  // namespace detail
+
+/*!
+ * @brief Same as `mortonEncode`, but using lookup tables instead of `pdep` or the magic
+ * bits.
+ *
+ * Does not depend on the instruction set and needs fewer operations than the magic
+ * bits, but the loads make it slower than both `pdep` and the magic bits on current
+ * x86 processors, so it is mainly intended for targets with slow shifts.
+ */
+template <class Code = std::uint64_t, class... Coords>
+[[nodiscard]] constexpr Code mortonEncodeLut(Coords... coords) noexcept
+{
+	constexpr std::size_t Dim = sizeof...(Coords);
+	static_assert(2 == Dim || 3 == Dim, "Morton codes are 2D or 3D");
+
+	using Coord           = MortonCoord<Code, Dim>;
+	constexpr int bits    = detail::MORTON_COORD_BITS<Code, Dim>;
+	constexpr int bytes   = (bits + 7) / 8;
+	constexpr auto& lut   = detail::MORTON_ENCODE_LUT<Dim>;
+	constexpr Coord valid = bits == detail::CODE_BITS<Coord> ? ~Coord(0)
+	                                                         : (Coord(1) << bits) - 1;
+
+	std::array<Coord, Dim> const c{static_cast<Coord>(coords & valid)...};
+
+	Code code{};
+	for (int k{}; bytes != k; ++k) {
+		for (std::size_t d{}; Dim != d; ++d) {
+			code |= Code(lut[(c[d] >> (8 * k)) & 0xFFu]) << (8 * static_cast<int>(Dim) * k + d);
+		}
+	}
+	return code;
+}
+
+/*!
+ * @brief Same as `mortonDecode`, but using lookup tables.
+ */
+template <std::size_t Dim, class Code>
+[[nodiscard]] constexpr std::array<MortonCoord<Code, Dim>, Dim> mortonDecodeLut(
+    Code code) noexcept
+{
+	static_assert(2 == Dim || 3 == Dim, "Morton codes are 2D or 3D");
+
+	using Coord           = MortonCoord<Code, Dim>;
+	constexpr int   bits  = detail::MORTON_LUT_BITS<Dim>;
+	constexpr int   chunk = bits * static_cast<int>(Dim);
+	constexpr int   n     = (detail::CODE_BITS<Code> + chunk - 1) / chunk;
+	constexpr auto& lut   = detail::MORTON_DECODE_LUT<Dim>;
+	constexpr Coord valid = detail::MORTON_COORD_BITS<Code, Dim> == detail::CODE_BITS<Coord>
+	                            ? ~Coord(0)
+	                            : (Coord(1) << detail::MORTON_COORD_BITS<Code, Dim>) - 1;
+
+	std::array<Coord, Dim> c{};
+	for (int j{}; n != j; ++j) {
+		std::uint16_t const e = lut[static_cast<std::size_t>(code >> (chunk * j)) &
+		                            (lut.size() - 1)];
+		for (std::size_t d{}; Dim != d; ++d) {
+			c[d] |= Coord((e >> (d * bits)) & ((1u << bits) - 1)) << (bits * j);
+		}
+	}
+	for (auto& e : c) {
+		e &= valid;
+	}
+	return c;
+}
+
+/*!
+ * @brief Returns the code of the neighbor one step in the positive `Axis` direction,
+ * without decoding.
+ *
+ * The other coordinates are unchanged and the `Axis` coordinate wraps around at the
+ * end of the code.
+ */
+template <std::size_t Dim, std::size_t Axis, class Code>
+[[nodiscard]] constexpr Code mortonIncrement(Code code) noexcept
+{
+	static_assert(Dim > Axis, "Axis out of range");
+	// Filling the other axes with ones makes the carry propagate through them
+	constexpr Code m = detail::MORTON_AXIS_MASK<Code, Dim, Axis>;
+	return (((code | ~m) + 1) & m) | (code & ~m);
+}
+
+/*!
+ * @brief Returns the code of the neighbor one step in the negative `Axis` direction,
+ * without decoding.
+ */
+template <std::size_t Dim, std::size_t Axis, class Code>
+[[nodiscard]] constexpr Code mortonDecrement(Code code) noexcept
+{
+	static_assert(Dim > Axis, "Axis out of range");
+	// With the other axes zeroed the borrow propagates through them
+	constexpr Code m = detail::MORTON_AXIS_MASK<Code, Dim, Axis>;
+	return (((code & m) - 1) & m) | (code & ~m);
+}
+
+/*!
+ * @brief Per coordinate sum of two codes, i.e., `encode(decode(a) + decode(b))` with
+ * each coordinate wrapping around.
+ *
+ * Useful to visit neighbors at an offset, by encoding the offset once.
+ */
+template <std::size_t Dim, class Code>
+[[nodiscard]] constexpr Code mortonAdd(Code a, Code b) noexcept
+{
+	static_assert(2 == Dim || 3 == Dim, "Morton codes are 2D or 3D");
+	Code code{};
+	for (std::size_t d{}; Dim != d; ++d) {
+		Code const m = detail::MORTON_MASKS<Code, Dim>[0] << d;
+		code |= ((a | ~m) + (b & m)) & m;
+	}
+	return code;
+}
+
+/*!
+ * @brief Per coordinate difference of two codes, i.e.,
+ * `encode(decode(a) - decode(b))` with each coordinate wrapping around.
+ */
+template <std::size_t Dim, class Code>
+[[nodiscard]] constexpr Code mortonSub(Code a, Code b) noexcept
+{
+	static_assert(2 == Dim || 3 == Dim, "Morton codes are 2D or 3D");
+	Code code{};
+	for (std::size_t d{}; Dim != d; ++d) {
+		Code const m = detail::MORTON_MASKS<Code, Dim>[0] << d;
+		code |= ((a & m) - (b & m)) & m;
+	}
+	return code;
+}
+
+namespace detail
+{
+// A scalar `pdep` per coordinate beats the vectorized magic bits, so AVX2 is only used
+// when `pdep` is not
+#if defined(__AVX2__) && !defined(UFO_MORTON_PDEP)
+#define UFO_MORTON_AVX2 1
+#endif
+
+#if defined(UFO_MORTON_AVX2)
+template <class Code>
+[[nodiscard]] inline __m256i mortonSet1(Code x) noexcept
+{
+	if constexpr (4 == sizeof(Code)) {
+		return _mm256_set1_epi32(static_cast<int>(x));
+	} else {
+		return _mm256_set1_epi64x(static_cast<long long>(x));
+	}
+}
+
+template <class Code>
+[[nodiscard]] inline __m256i mortonShiftLeft(__m256i x, int s) noexcept
+{
+	if constexpr (4 == sizeof(Code)) {
+		return _mm256_slli_epi32(x, s);
+	} else {
+		return _mm256_slli_epi64(x, s);
+	}
+}
+
+template <class Code>
+[[nodiscard]] inline __m256i mortonShiftRight(__m256i x, int s) noexcept
+{
+	if constexpr (4 == sizeof(Code)) {
+		return _mm256_srli_epi32(x, s);
+	} else {
+		return _mm256_srli_epi64(x, s);
+	}
+}
+
+template <class Code, std::size_t Dim, int... Ks>
+[[nodiscard]] inline __m256i mortonSpread(__m256i x,
+                                          std::integer_sequence<int, Ks...>) noexcept
+{
+	constexpr auto& masks = MORTON_MASKS<Code, Dim>;
+	constexpr int   steps = sizeof...(Ks);
+	constexpr int   shift = static_cast<int>(Dim - 1);
+
+	x = _mm256_and_si256(x, mortonSet1(masks[steps]));
+	((x = _mm256_and_si256(
+	      _mm256_or_si256(x, mortonShiftLeft<Code>(x, (1 << (steps - 1 - Ks)) * shift)),
+	      mortonSet1(masks[steps - 1 - Ks]))),
+	 ...);
+	return x;
+}
+
+template <class Code, std::size_t Dim, int... Ks>
+[[nodiscard]] inline __m256i mortonCompact(__m256i x,
+                                           std::integer_sequence<int, Ks...>) noexcept
+{
+	constexpr auto& masks = MORTON_MASKS<Code, Dim>;
+	constexpr int   shift = static_cast<int>(Dim - 1);
+
+	x = _mm256_and_si256(x, mortonSet1(masks[0]));
+	((x = _mm256_and_si256(
+	      _mm256_or_si256(x, mortonShiftRight<Code>(x, (1 << Ks) * shift)),
+	      mortonSet1(masks[Ks + 1]))),
+	 ...);
+	return x;
+}
+
+template <class Code, std::size_t Dim>
+[[nodiscard]] inline __m256i mortonSpread(__m256i x) noexcept
+{
+	return mortonSpread<Code, Dim>(
+	    x, std::make_integer_sequence<int, mortonSteps<Code, Dim>()>{});
+}
+
+template <class Code, std::size_t Dim>
+[[nodiscard]] inline __m256i mortonCompact(__m256i x) noexcept
+{
+	return mortonCompact<Code, Dim>(
+	    x, std::make_integer_sequence<int, mortonSteps<Code, Dim>()>{});
+}
+
+// Loads `32 / sizeof(Code)` coordinates, zero extended to the width of the code
+template <class Code>
+[[nodiscard]] inline __m256i mortonLoad(std::uint32_t const* p) noexcept
+{
+	if constexpr (4 == sizeof(Code)) {
+		return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+	} else {
+		return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p)));
+	}
+}
+
+template <class Code>
+inline void mortonStore(std::uint32_t* p, __m256i x) noexcept
+{
+	if constexpr (4 == sizeof(Code)) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+	} else {
+		// Gather the low halves of the 64 bit lanes in the lower 128 bits
+		__m256i const idx = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+		                 _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(x, idx)));
+	}
+}
+
+template <class Code, std::size_t Dim>
+inline constexpr bool MORTON_SIMD =
+    (4 == sizeof(Code) || 8 == sizeof(Code)) &&
+    std::is_same_v<std::uint32_t, MortonCoord<Code, Dim>>;
+#endif
+
+template <class Code, std::size_t Dim>
+void mortonEncode(std::array<Span<MortonCoord<Code, Dim> const>, Dim> const& coords,
+                  Span<Code> codes)
+{
+	std::size_t const n = codes.size();
+	for (auto const& c : coords) {
+		assert(c.size() == n);
+		(void)c;
+	}
+
+	std::size_t i{};
+#if defined(UFO_MORTON_AVX2)
+	if constexpr (MORTON_SIMD<Code, Dim>) {
+		constexpr std::size_t W = 32 / sizeof(Code);
+		for (; i + W <= n; i += W) {
+			__m256i code = _mm256_setzero_si256();
+			for (std::size_t d{}; Dim != d; ++d) {
+				__m256i const x = mortonSpread<Code, Dim>(mortonLoad<Code>(coords[d].data() + i));
+				code = _mm256_or_si256(code, mortonShiftLeft<Code>(x, static_cast<int>(d)));
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(codes.data() + i), code);
+		}
+	}
+#endif
+	for (; n != i; ++i) {
+		std::array<MortonCoord<Code, Dim>, Dim> c;
+		for (std::size_t d{}; Dim != d; ++d) {
+			c[d] = coords[d][i];
+		}
+		codes[i] = mortonEncode<Code, Dim>(c, std::make_index_sequence<Dim>{});
+	}
+}
+
+template <class Code, std::size_t Dim>
+void mortonDecode(Span<Code const> codes,
+                  std::array<Span<MortonCoord<Code, Dim>>, Dim> const& coords)
+{
+	std::size_t const n = codes.size();
+	for (auto const& c : coords) {
+		assert(c.size() == n);
+		(void)c;
+	}
+
+	std::size_t i{};
+#if defined(UFO_MORTON_AVX2)
+	if constexpr (MORTON_SIMD<Code, Dim>) {
+		constexpr std::size_t W = 32 / sizeof(Code);
+		for (; i + W <= n; i += W) {
+			__m256i const code =
+			    _mm256_loadu_si256(reinterpret_cast<__m256i const*>(codes.data() + i));
+			for (std::size_t d{}; Dim != d; ++d) {
+				mortonStore<Code>(coords[d].data() + i,
+				                  mortonCompact<Code, Dim>(
+				                      mortonShiftRight<Code>(code, static_cast<int>(d))));
+			}
+		}
+	}
+#endif
+	for (; n != i; ++i) {
+		auto const c = mortonDecode<Code, Dim>(codes[i], std::make_index_sequence<Dim>{});
+		for (std::size_t d{}; Dim != d; ++d) {
+			coords[d][i] = c[d];
+		}
+	}
+}
+}  // namespace detail
+
+/*!
+ * @brief Encodes the 2D coordinates `(x[i], y[i])` into `codes[i]`.
+ *
+ * Uses the scalar `mortonEncode` (i.e., `pdep`) with BMI2, otherwise AVX2 when
+ * available, encoding 4 (64 bit codes) or 8 (32 bit codes) coordinates at a time with
+ * the magic bits method.
+ *
+ * @note All spans must have the same size.
+ */
+template <class Code>
+void mortonEncode(Span<MortonCoord<Code, 2> const> x, Span<MortonCoord<Code, 2> const> y,
+                  Span<Code> codes)
+{
+	detail::mortonEncode<Code, 2>({x, y}, codes);
+}
+
+/*!
+ * @brief Encodes the 3D coordinates `(x[i], y[i], z[i])` into `codes[i]`.
+ *
+ * @note All spans must have the same size.
+ */
+template <class Code>
+void mortonEncode(Span<MortonCoord<Code, 3> const> x, Span<MortonCoord<Code, 3> const> y,
+                  Span<MortonCoord<Code, 3> const> z, Span<Code> codes)
+{
+	detail::mortonEncode<Code, 3>({x, y, z}, codes);
+}
+
+/*!
+ * @brief Decodes `codes[i]` into the 2D coordinates `(x[i], y[i])`.
+ *
+ * @note All spans must have the same size.
+ */
+template <class Code>
+void mortonDecode(Span<Code const> codes, Span<MortonCoord<Code, 2>> x,
+                  Span<MortonCoord<Code, 2>> y)
+{
+	detail::mortonDecode<Code, 2>(codes, {x, y});
+}
+
+/*!
+ * @brief Decodes `codes[i]` into the 3D coordinates `(x[i], y[i], z[i])`.
+ *
+ * @note All spans must have the same size.
+ */
+template <class Code>
+void mortonDecode(Span<Code const> codes, Span<MortonCoord<Code, 3>> x,
+                  Span<MortonCoord<Code, 3>> y, Span<MortonCoord<Code, 3>> z)
+{
+	detail::mortonDecode<Code, 3>(codes, {x, y, z});
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_MORTON_HPP
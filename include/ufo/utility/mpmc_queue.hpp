@@ -0,0 +1,351 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_MPMC_QUEUE_HPP
+#define UFO_UTILITY_MPMC_QUEUE_HPP
+
+// UFO
+#include <ufo/utility/backoff.hpp>
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/cache_line.hpp>
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ufo
+{
+/*!
+ * @brief Bounded lock-free multi-producer multi-consumer queue.
+ *
+ * Based on Dmitry Vyukov's bounded MPMC queue: every cell carries a sequence number
+ * telling whether it is ready to be written or read in the current lap, so producers
+ * and consumers only contend on their own position counter, each living on a separate
+ * cache line. A push or pop is a single successful compare-and-swap in the common case.
+ *
+ * The bulk operations claim a run of consecutive ready cells with one compare-and-swap,
+ * which amortizes the contended operation over the whole batch.
+ *
+ * @tparam T The element type, has to be nothrow move constructible. Copies (and other
+ * constructions that may throw) are made before a cell is claimed, so a throwing
+ * constructor leaves the queue unchanged.
+ */
+template <class T>
+class MPMCQueue
+{
+	static_assert(std::is_nothrow_move_constructible_v<T>,
+	              "MPMCQueue requires nothrow move constructible T");
+
+	struct Cell {
+		std::atomic<std::size_t> seq;
+		alignas(T) unsigned char data[sizeof(T)];
+
+		[[nodiscard]] T* value() noexcept
+		{
+			return std::launder(reinterpret_cast<T*>(data));
+		}
+	};
+
+ public:
+	using value_type = T;
+	using size_type  = std::size_t;
+
+	/*!
+	 * @param capacity Maximum number of elements, rounded up to the closest power of two.
+	 */
+	explicit MPMCQueue(size_type capacity)
+	    : mask_(bitCeil(std::max(capacity, size_type(2))) - 1)
+	    , cells_(std::make_unique<Cell[]>(mask_ + 1))
+	{
+		for (size_type i{}; mask_ >= i; ++i) {
+			cells_[i].seq.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MPMCQueue(MPMCQueue const&)            = delete;
+	MPMCQueue& operator=(MPMCQueue const&) = delete;
+
+	~MPMCQueue()
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			size_type const last = enqueue_pos_.load(std::memory_order_relaxed);
+			for (size_type pos = dequeue_pos_.load(std::memory_order_relaxed); last != pos;
+			     ++pos) {
+				cells_[pos & mask_].value()->~T();
+			}
+		}
+	}
+
+	/*!
+	 * @brief Constructs an element from `args` at the back of the queue.
+	 *
+	 * A claimed cell has to be published, so if constructing `T` from `args` can throw
+	 * the element is constructed before a cell is claimed and then moved into it.
+	 *
+	 * @return Whether there was room for the element.
+	 */
+	template <class... Args>
+	bool tryEmplace(Args&&... args)
+	{
+		if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>) {
+			T tmp(std::forward<Args>(args)...);
+			return tryEmplace(std::move(tmp));
+		} else {
+			size_type pos  = enqueue_pos_.load(std::memory_order_relaxed);
+			Cell*     cell = nullptr;
+			for (;;) {
+				cell                 = &cells_[pos & mask_];
+				size_type const seq  = cell->seq.load(std::memory_order_acquire);
+				auto const      diff = static_cast<std::ptrdiff_t>(seq - pos);
+				if (0 == diff) {
+					if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+					                                       std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (0 > diff) {
+					return false;  // Full
+				} else {
+					pos = enqueue_pos_.load(std::memory_order_relaxed);
+				}
+			}
+
+			::new (cell->data) T(std::forward<Args>(args)...);
+			cell->seq.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+	}
+
+	bool tryPush(T const& value) { return tryEmplace(value); }
+
+	bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+	bool tryPop(T& value)
+	{
+		size_type pos  = dequeue_pos_.load(std::memory_order_relaxed);
+		Cell*     cell = nullptr;
+		for (;;) {
+			cell                 = &cells_[pos & mask_];
+			size_type const seq  = cell->seq.load(std::memory_order_acquire);
+			auto const      diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+			if (0 == diff) {
+				if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+				                                       std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (0 > diff) {
+				return false;  // Empty
+			} else {
+				pos = dequeue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+
+		release(*cell, pos, value);
+		return true;
+	}
+
+	/*!
+	 * @brief Pushes `value`, spinning with backoff while the queue is full.
+	 */
+	template <class U>
+	void push(U&& value)
+	{
+		if constexpr (!std::is_nothrow_constructible_v<T, U&&>) {
+			// Constructed once, rather than on every attempt
+			T tmp(std::forward<U>(value));
+			push(std::move(tmp));
+		} else {
+			for (Backoff backoff; !tryEmplace(std::forward<U>(value)); backoff.snooze()) {
+			}
+		}
+	}
+
+	/*!
+	 * @brief Pops an element into `value`, spinning with backoff while the queue is empty.
+	 */
+	void pop(T& value)
+	{
+		for (Backoff backoff; !tryPop(value); backoff.snooze()) {
+		}
+	}
+
+	/*!
+	 * @brief Pushes up to `count` elements starting at `first`.
+	 *
+	 * @return The number of elements pushed, less than `count` only if the queue became
+	 * full.
+	 *
+	 * @throws Whatever constructing `T` from `*first` throws, the elements pushed before
+	 * that stay in the queue.
+	 */
+	template <class InputIt>
+	size_type tryPushBulk(InputIt first, size_type count)
+	{
+		size_type pushed{};
+		if constexpr (!std::is_nothrow_constructible_v<T, decltype(*first)>) {
+			// A claimed cell has to be published, so elements whose construction can throw
+			// are pushed one at a time, see `tryEmplace`
+			for (; count != pushed && tryEmplace(*first); ++pushed, ++first) {
+			}
+			return pushed;
+		}
+
+		while (pushed != count) {
+			size_type       pos = enqueue_pos_.load(std::memory_order_relaxed);
+			size_type const n   = claim(enqueue_pos_, pos, count - pushed, 0);
+			if (0 == n) {
+				break;
+			}
+			for (size_type i{}; n != i; ++i, ++first) {
+				Cell& cell = cells_[(pos + i) & mask_];
+				::new (cell.data) T(*first);
+				cell.seq.store(pos + i + 1, std::memory_order_release);
+			}
+			pushed += n;
+		}
+		return pushed;
+	}
+
+	/*!
+	 * @brief Pops up to `count` elements into `d_first`.
+	 *
+	 * @return The number of elements popped, less than `count` only if the queue became
+	 * empty.
+	 */
+	template <class OutputIt>
+	size_type tryPopBulk(OutputIt d_first, size_type count)
+	{
+		size_type popped{};
+		while (popped != count) {
+			size_type       pos = dequeue_pos_.load(std::memory_order_relaxed);
+			size_type const n   = claim(dequeue_pos_, pos, count - popped, 1);
+			if (0 == n) {
+				break;
+			}
+			for (size_type i{}; n != i; ++i, ++d_first) {
+				Cell& cell = cells_[(pos + i) & mask_];
+				*d_first   = std::move(*cell.value());
+				cell.value()->~T();
+				cell.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+			}
+			popped += n;
+		}
+		return popped;
+	}
+
+	[[nodiscard]] size_type capacity() const noexcept { return mask_ + 1; }
+
+	/*!
+	 * @brief Approximate number of elements, only exact when no other thread is
+	 * accessing the queue.
+	 */
+	[[nodiscard]] size_type size() const noexcept
+	{
+		auto const diff =
+		    static_cast<std::ptrdiff_t>(enqueue_pos_.load(std::memory_order_relaxed) -
+		                                dequeue_pos_.load(std::memory_order_relaxed));
+		return 0 > diff ? 0 : static_cast<size_type>(diff);
+	}
+
+	[[nodiscard]] bool empty() const noexcept { return 0 == size(); }
+
+ private:
+	void release(Cell& cell, size_type pos, T& value)
+	{
+		value = std::move(*cell.value());
+		cell.value()->~T();
+		cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+	}
+
+	/*!
+	 * @brief Claims up to `max` consecutive cells starting at `pos` that are ready for
+	 * the operation, i.e., whose sequence number is `pos + offset`.
+	 *
+	 * Cells observed ready stay ready until claimed, since only the thread winning the
+	 * position can change them.
+	 *
+	 * @return The number of cells claimed, `pos` is updated to the first one.
+	 */
+	size_type claim(std::atomic<size_type>& position, size_type& pos, size_type max,
+	                size_type offset)
+	{
+		for (;;) {
+			size_type n{};
+			for (; max != n; ++n) {
+				size_type const seq =
+				    cells_[(pos + n) & mask_].seq.load(std::memory_order_acquire);
+				if (seq != pos + n + offset) {
+					break;
+				}
+			}
+
+			if (0 == n) {
+				size_type const seq  = cells_[pos & mask_].seq.load(std::memory_order_acquire);
+				auto const      diff = static_cast<std::ptrdiff_t>(seq - (pos + offset));
+				if (0 > diff) {
+					return 0;  // Full or empty
+				}
+				pos = position.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			if (position.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+				return n;
+			}
+		}
+	}
+
+ private:
+	size_type               mask_;
+	std::unique_ptr<Cell[]> cells_;
+
+	alignas(CACHE_LINE_SIZE) std::atomic<size_type> enqueue_pos_{};
+	alignas(CACHE_LINE_SIZE) std::atomic<size_type> dequeue_pos_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_MPMC_QUEUE_HPP
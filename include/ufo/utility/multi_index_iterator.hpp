@@ -0,0 +1,434 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_MULTI_INDEX_ITERATOR_HPP
+#define UFO_UTILITY_MULTI_INDEX_ITERATOR_HPP
+
+// UFO
+#include <ufo/utility/hilbert.hpp>
+#include <ufo/utility/morton.hpp>
+#include <ufo/utility/split.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+namespace ufo
+{
+enum class TraversalOrder {
+	// The last dimension varies the fastest, as for a C array `a[i][j][k]`
+	ROW_MAJOR,
+	// The box is divided into tiles which are traversed in row-major order, and each
+	// tile is traversed in row-major order before moving on to the next
+	TILED,
+	// Z-order curve, the last dimension is in the lowest bit of the code. Requires all
+	// extents to be the same power of two
+	MORTON,
+	// Hilbert curve, neighboring indices in the traversal are neighbors in the box.
+	// Requires all extents to be the same power of two
+	HILBERT
+};
+
+/*!
+ * @brief The indices of the N-dimensional box `[first, last)`, traversed in a given
+ * order.
+ *
+ * Random access (each index is computed from its position in the traversal, so any
+ * order can be split at any point) and models the TBB Range concept in the same way as
+ * `IndexIterator`, so it can be used with `parallel_for`.
+ *
+ * Iterating with `forEach` is faster than with the iterators, since it only computes
+ * the index once per row of the box (or tile) and then runs a tight loop along the last
+ * dimension.
+ *
+ * @tparam Dim Number of dimensions.
+ * @tparam T The index type.
+ */
+template <std::size_t Dim, class T = std::size_t>
+class MultiIndexIterator
+{
+	static_assert(0 < Dim, "MultiIndexIterator requires at least one dimension");
+
+ public:
+	using index_type = std::array<T, Dim>;
+	using size_type  = std::size_t;
+
+	class Iterator
+	{
+		friend class MultiIndexIterator;
+
+	 public:
+		// Tags
+		using iterator_category = std::random_access_iterator_tag;
+		using difference_type   = std::ptrdiff_t;
+		using value_type        = index_type;
+		using reference         = value_type;
+		using pointer           = void;
+
+	 public:
+		constexpr Iterator() = default;
+
+		constexpr Iterator& operator++()
+		{
+			++pos_;
+			return *this;
+		}
+
+		constexpr Iterator operator++(int)
+		{
+			auto tmp = *this;
+			++*this;
+			return tmp;
+		}
+
+		constexpr Iterator& operator--()
+		{
+			--pos_;
+			return *this;
+		}
+
+		constexpr Iterator operator--(int)
+		{
+			auto tmp = *this;
+			--*this;
+			return tmp;
+		}
+
+		constexpr Iterator& operator+=(difference_type n)
+		{
+			pos_ += n;
+			return *this;
+		}
+
+		constexpr Iterator operator+(difference_type n) const
+		{
+			auto tmp = *this;
+			tmp += n;
+			return tmp;
+		}
+
+		constexpr Iterator& operator-=(difference_type n)
+		{
+			pos_ -= n;
+			return *this;
+		}
+
+		constexpr Iterator operator-(difference_type n) const
+		{
+			auto tmp = *this;
+			tmp -= n;
+			return tmp;
+		}
+
+		[[nodiscard]] constexpr reference operator[](difference_type n) const
+		{
+			return range_->at(static_cast<size_type>(pos_ + n));
+		}
+
+		[[nodiscard]] constexpr reference operator*() const { return operator[](0); }
+
+		friend constexpr difference_type operator-(Iterator const& lhs, Iterator const& rhs)
+		{
+			return lhs.pos_ - rhs.pos_;
+		}
+
+		friend constexpr bool operator==(Iterator const& lhs, Iterator const& rhs)
+		{
+			return lhs.pos_ == rhs.pos_;
+		}
+
+		friend constexpr bool operator!=(Iterator const& lhs, Iterator const& rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+		friend constexpr bool operator<(Iterator const& lhs, Iterator const& rhs)
+		{
+			return lhs.pos_ < rhs.pos_;
+		}
+
+		friend constexpr bool operator<=(Iterator const& lhs, Iterator const& rhs)
+		{
+			return lhs.pos_ <= rhs.pos_;
+		}
+
+		friend constexpr bool operator>(Iterator const& lhs, Iterator const& rhs)
+		{
+			return lhs.pos_ > rhs.pos_;
+		}
+
+		friend constexpr bool operator>=(Iterator const& lhs, Iterator const& rhs)
+		{
+			return lhs.pos_ >= rhs.pos_;
+		}
+
+	 private:
+		constexpr Iterator(MultiIndexIterator const* range, difference_type pos)
+		    : range_(range), pos_(pos)
+		{
+		}
+
+	 private:
+		MultiIndexIterator const* range_ = nullptr;
+		difference_type           pos_{};
+	};
+
+	constexpr MultiIndexIterator() = default;
+
+	/*!
+	 * @param first The first (smallest) index along each dimension.
+	 * @param last One past the last index along each dimension.
+	 * @param order The order to traverse the box in.
+	 * @param tile The extent of the tiles along each dimension, only used by
+	 * `TraversalOrder::TILED`.
+	 * @param grain The smallest number of indices the range is split into.
+	 */
+	constexpr MultiIndexIterator(index_type const& first, index_type const& last,
+	                             TraversalOrder order = TraversalOrder::ROW_MAJOR,
+	                             index_type tile = defaultTile(), size_type grain = 1)
+	    : first_(first), tile_(tile), order_(order), grain_(grain)
+	{
+		size_type size = 1;
+		for (std::size_t d{}; Dim != d; ++d) {
+			extent_[d] = first[d] < last[d] ? last[d] - first[d] : T(0);
+			size *= static_cast<size_type>(extent_[d]);
+			assert(T(0) < tile_[d]);
+		}
+		end_ = size;
+
+		if ((TraversalOrder::MORTON == order_ || TraversalOrder::HILBERT == order_) &&
+		    0 != size) {
+			while ((T(1) << curve_levels_) < extent_[0]) {
+				++curve_levels_;
+			}
+			assert(std::all_of(std::begin(extent_), std::end(extent_),
+			                   [this](T e) { return (T(1) << curve_levels_) == e; }));
+		}
+	}
+
+	/*!
+	 * @brief Splitting constructor, `r` keeps the first half of the traversal and the
+	 * constructed range gets the second half.
+	 */
+	constexpr MultiIndexIterator(MultiIndexIterator& r, split) : MultiIndexIterator(r)
+	{
+		assert(r.is_divisible());
+		begin_ = r.begin_ + r.size() / 2;
+		r.end_ = begin_;
+	}
+
+	[[nodiscard]] constexpr size_type size() const noexcept { return end_ - begin_; }
+
+	[[nodiscard]] constexpr bool empty() const noexcept { return begin_ == end_; }
+
+	[[nodiscard]] constexpr bool is_divisible() const noexcept { return grain_ < size(); }
+
+	[[nodiscard]] constexpr size_type grainsize() const noexcept { return grain_; }
+
+	[[nodiscard]] constexpr TraversalOrder order() const noexcept { return order_; }
+
+	[[nodiscard]] constexpr index_type const& extent() const noexcept { return extent_; }
+
+	/*!
+	 * @brief Returns the `pos`th index of the traversal.
+	 */
+	[[nodiscard]] constexpr index_type operator[](size_type pos) const
+	{
+		assert(size() > pos);
+		return at(begin_ + pos);
+	}
+
+	[[nodiscard]] Iterator begin() const { return cbegin(); }
+
+	[[nodiscard]] Iterator cbegin() const
+	{
+		return Iterator(this, static_cast<typename Iterator::difference_type>(begin_));
+	}
+
+	[[nodiscard]] Iterator end() const { return cend(); }
+
+	[[nodiscard]] Iterator cend() const
+	{
+		return Iterator(this, static_cast<typename Iterator::difference_type>(end_));
+	}
+
+	/*!
+	 * @brief Calls `f(index)` for each index, in traversal order.
+	 *
+	 * @param f Callable taking an `index_type const&`.
+	 */
+	template <class UnaryFunction>
+	void forEach(UnaryFunction f) const
+	{
+		if (TraversalOrder::MORTON == order_ || TraversalOrder::HILBERT == order_) {
+			for (size_type pos = begin_; end_ != pos; ++pos) {
+				f(at(pos));
+			}
+			return;
+		}
+
+		for (size_type pos = begin_; end_ != pos;) {
+			size_type  run{};
+			index_type index = at(pos, run);
+			run              = std::min(run, end_ - pos);
+			pos += run;
+			for (; 0 != run; --run, ++index[Dim - 1]) {
+				f(std::as_const(index));
+			}
+		}
+	}
+
+ private:
+	[[nodiscard]] static constexpr index_type defaultTile() noexcept
+	{
+		index_type tile{};
+		for (auto& t : tile) {
+			t = T(8);
+		}
+		return tile;
+	}
+
+	[[nodiscard]] constexpr index_type at(size_type pos) const
+	{
+		size_type run{};
+		return at(pos, run);
+	}
+
+	/*!
+	 * @brief Computes the index at position `pos` of the full traversal.
+	 *
+	 * @param run Set to the number of indices, starting at `pos`, that only differ by
+	 * consecutive steps along the last dimension.
+	 */
+	[[nodiscard]] constexpr index_type at(size_type pos, size_type& run) const
+	{
+		index_type index = first_;
+
+		switch (order_) {
+			case TraversalOrder::ROW_MAJOR:
+				for (std::size_t d = Dim; 0 != d; --d) {
+					auto const e = static_cast<size_type>(extent_[d - 1]);
+					index[d - 1] += static_cast<T>(pos % e);
+					pos /= e;
+				}
+				run = static_cast<size_type>(first_[Dim - 1] + extent_[Dim - 1] -
+				                             index[Dim - 1]);
+				break;
+			case TraversalOrder::TILED: {
+				// Elements of the dimensions after `d`, and the size of the current tile
+				// along the dimensions before `d`
+				size_type  rest = 1;
+				size_type  prev = 1;
+				index_type size{};
+				for (std::size_t d{}; Dim != d; ++d) {
+					rest *= static_cast<size_type>(extent_[d]);
+				}
+				for (std::size_t d{}; Dim != d; ++d) {
+					rest /= static_cast<size_type>(extent_[d]);
+					auto const slab = prev * static_cast<size_type>(tile_[d]) * rest;
+					auto const t    = pos / slab;
+					pos -= t * slab;
+					index[d] += static_cast<T>(t) * tile_[d];
+					size[d] = std::min(tile_[d], static_cast<T>(first_[d] + extent_[d] - index[d]));
+					prev *= static_cast<size_type>(size[d]);
+				}
+				// Row-major within the tile
+				for (std::size_t d = Dim; 0 != d; --d) {
+					auto const e = static_cast<size_type>(size[d - 1]);
+					index[d - 1] += static_cast<T>(pos % e);
+					pos /= e;
+				}
+				run = static_cast<size_type>(size[Dim - 1]) -
+				      static_cast<size_type>((index[Dim - 1] - first_[Dim - 1]) % tile_[Dim - 1]);
+				break;
+			}
+			case TraversalOrder::MORTON:
+				if constexpr (2 == Dim || 3 == Dim) {
+					auto const c = mortonDecode<Dim>(static_cast<std::uint64_t>(pos));
+					for (std::size_t d{}; Dim != d; ++d) {
+						index[d] += static_cast<T>(c[Dim - 1 - d]);
+					}
+				} else {
+					for (unsigned l{}; curve_levels_ != l; ++l) {
+						for (std::size_t d = Dim; 0 != d; --d, pos >>= 1) {
+							index[d - 1] += static_cast<T>((pos & size_type(1)) << l);
+						}
+					}
+				}
+				run = 1;
+				break;
+			case TraversalOrder::HILBERT: {
+				auto const c =
+				    detail::hilbertDecode<std::uint64_t, Dim>(static_cast<std::uint64_t>(pos),
+				                                              curve_levels_);
+				for (std::size_t d{}; Dim != d; ++d) {
+					index[d] += static_cast<T>(c[d]);
+				}
+				run = 1;
+				break;
+			}
+			default:
+				// Unreachable, all orders are handled above
+				run = 1;
+				break;
+		}
+
+		return index;
+	}
+
+ private:
+	index_type     first_{};
+	index_type     extent_{};
+	index_type     tile_ = defaultTile();
+	TraversalOrder order_{TraversalOrder::ROW_MAJOR};
+	unsigned       curve_levels_{};
+	size_type      begin_{};
+	size_type      end_{};
+	size_type      grain_ = 1;
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_MULTI_INDEX_ITERATOR_HPP
@@ -0,0 +1,120 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_PARALLEL_FOR_HPP
+#define UFO_UTILITY_PARALLEL_FOR_HPP
+
+// UFO
+#include <ufo/utility/index_iterator.hpp>
+#include <ufo/utility/multi_index_iterator.hpp>
+
+// STL
+#include <cstddef>
+
+#if defined(UFO_TBB)
+// TBB
+#include <tbb/parallel_for.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Calls `f(i)` for every index `i` in `range`.
+ *
+ * With TBB (`UFO_TBB`) the range is recursively split and the pieces are distributed
+ * using work stealing, otherwise it is a plain serial loop. The calls for different
+ * indices may happen concurrently and in any order.
+ *
+ * @param range The indices, `range.grain` is the smallest number of indices a task
+ * is split into.
+ * @param f Callable taking an index.
+ */
+template <class T, class UnaryFunction>
+void parallel_for(IndexIterator<T> const& range, UnaryFunction f)
+{
+	auto const body = [&f](IndexIterator<T> const& r) {
+		T i = r.first;
+		for (std::size_t n = r.size(); 0 != n; --n, i += r.inc) {
+			f(i);
+		}
+	};
+
+#if defined(UFO_TBB)
+	tbb::parallel_for(range, body);
+#else
+	body(range);
+#endif
+}
+
+/*!
+ * @brief Calls `f(i)` for every index `i` in `range`, splitting it into pieces of no
+ * fewer than `grain` indices.
+ *
+ * A larger grain lowers the scheduling overhead for cheap loop bodies, a smaller one
+ * gives better load balancing for expensive ones.
+ */
+template <class T, class UnaryFunction>
+void parallel_for(IndexIterator<T> range, std::size_t grain, UnaryFunction f)
+{
+	range.grain = grain;
+	parallel_for(range, f);
+}
+
+/*!
+ * @brief Calls `f(index)` for every index in the N-dimensional `range`.
+ *
+ * The traversal is split into consecutive pieces, so each task visits a contiguous
+ * part of the traversal order (e.g., whole tiles with `TraversalOrder::TILED`).
+ *
+ * @param f Callable taking a `MultiIndexIterator<Dim, T>::index_type const&`.
+ */
+template <std::size_t Dim, class T, class UnaryFunction>
+void parallel_for(MultiIndexIterator<Dim, T> const& range, UnaryFunction f)
+{
+#if defined(UFO_TBB)
+	tbb::parallel_for(range, [&f](MultiIndexIterator<Dim, T> const& r) { r.forEach(f); });
+#else
+	range.forEach(f);
+#endif
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_PARALLEL_FOR_HPP
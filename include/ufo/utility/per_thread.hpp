@@ -0,0 +1,277 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_PER_THREAD_HPP
+#define UFO_UTILITY_PER_THREAD_HPP
+
+// UFO
+#include <ufo/utility/cache_line.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace ufo
+{
+namespace detail
+{
+/*!
+ * @brief Hands out small, dense thread indices and takes them back when threads exit.
+ */
+class ThreadIndexRegistry
+{
+ public:
+	[[nodiscard]] static ThreadIndexRegistry& instance()
+	{
+		static ThreadIndexRegistry registry;
+		return registry;
+	}
+
+	[[nodiscard]] std::size_t acquire()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (free_.empty()) {
+			return next_++;
+		}
+		// Reuse the smallest free index to keep the indices dense
+		std::pop_heap(free_.begin(), free_.end(), std::greater<>{});
+		std::size_t const index = free_.back();
+		free_.pop_back();
+		return index;
+	}
+
+	void release(std::size_t index)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		free_.push_back(index);
+		std::push_heap(free_.begin(), free_.end(), std::greater<>{});
+	}
+
+ private:
+	std::mutex               mutex_;
+	std::vector<std::size_t> free_;
+	std::size_t              next_{};
+};
+
+struct ThreadIndex {
+	std::size_t index = ThreadIndexRegistry::instance().acquire();
+
+	~ThreadIndex() { ThreadIndexRegistry::instance().release(index); }
+};
+}  // namespace detail
+
+/*!
+ * @brief Index of the calling thread, unique among the running threads.
+ *
+ * Indices are dense: they start at zero and the index of an exited thread is handed to
+ * the next new thread, so they stay below the largest number of threads that have been
+ * alive at the same time.
+ */
+[[nodiscard]] inline std::size_t threadIndex() noexcept
+{
+	static thread_local detail::ThreadIndex const index;
+	return index.index;
+}
+
+/*!
+ * @brief One `T` per thread, each in its own cache lines.
+ *
+ * For accumulating statistics, counters, or partial results in parallel without
+ * atomics or false sharing: each thread updates its own `local()` value, and the
+ * values are combined afterwards with `combine`/`combineEach`.
+ *
+ * Slots are indexed by `threadIndex()`. They are allocated lazily, in segments of
+ * doubling size, so any number of threads is supported and `local()` is lock-free. A
+ * thread starting after another has exited may reuse its slot, and continues from the
+ * value left there, which is what is wanted for accumulation.
+ *
+ * `local()` may be called concurrently, everything else must not run concurrently with
+ * any other member function.
+ */
+template <class T>
+class PerThread
+{
+	static constexpr std::size_t NUM_SEGMENTS = 64;
+
+	struct alignas(CACHE_LINE_SIZE) Slot {
+		T    value{};
+		bool used{};
+	};
+
+ public:
+	using value_type = T;
+
+	PerThread() = default;
+
+	/*!
+	 * @param init The initial value of each slot.
+	 */
+	explicit PerThread(T const& init) : init_(init) {}
+
+	PerThread(PerThread const&)            = delete;
+	PerThread& operator=(PerThread const&) = delete;
+
+	~PerThread()
+	{
+		for (std::size_t s{}; NUM_SEGMENTS != s; ++s) {
+			delete[] segments_[s].load(std::memory_order_relaxed);
+		}
+	}
+
+	/*!
+	 * @brief The value of the calling thread.
+	 */
+	[[nodiscard]] T& local()
+	{
+		Slot& s = slot(threadIndex());
+		s.used  = true;
+		return s.value;
+	}
+
+	/*!
+	 * @brief Calls `f` with the value of each slot that has been used, i.e., where
+	 * `local()` has been called since construction or the last `clear()`.
+	 */
+	template <class UnaryFunction>
+	void combineEach(UnaryFunction f) const
+	{
+		forEach([&f](Slot const& s) { f(s.value); });
+	}
+
+	/*!
+	 * @brief Folds the values of all used slots with `op`, starting from `init`.
+	 */
+	template <class BinaryOp>
+	[[nodiscard]] T combine(BinaryOp op, T init) const
+	{
+		forEach([&op, &init](Slot const& s) { init = op(std::move(init), s.value); });
+		return init;
+	}
+
+	/*!
+	 * @brief Folds the values of all used slots with `op`.
+	 *
+	 * The initial value is not folded in again, each used slot already started from it.
+	 *
+	 * @return The folded value, or the initial value if no slot has been used.
+	 */
+	template <class BinaryOp>
+	[[nodiscard]] T combine(BinaryOp op) const
+	{
+		T    result = init_;
+		bool first  = true;
+		forEach([&op, &result, &first](Slot const& s) {
+			result = first ? s.value : op(std::move(result), s.value);
+			first  = false;
+		});
+		return result;
+	}
+
+	/*!
+	 * @brief Sets all slots back to the initial value and marks them as unused.
+	 */
+	void clear()
+	{
+		forEach([this](Slot& s) {
+			s.value = init_;
+			s.used  = false;
+		});
+	}
+
+ private:
+	[[nodiscard]] static constexpr std::size_t segment(std::size_t index) noexcept
+	{
+		// Segment `s` holds the indices [2^s - 1, 2^(s+1) - 1)
+		std::size_t s{};
+		while ((index + 1) >> (s + 1)) {
+			++s;
+		}
+		return s;
+	}
+
+	[[nodiscard]] Slot& slot(std::size_t index)
+	{
+		std::size_t const s      = segment(index);
+		std::size_t const offset = index + 1 - (std::size_t(1) << s);
+
+		Slot* seg = segments_[s].load(std::memory_order_acquire);
+		if (nullptr == seg) {
+			Slot* fresh = new Slot[std::size_t(1) << s];
+			std::fill_n(fresh, std::size_t(1) << s, Slot{init_, false});
+			if (segments_[s].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel,
+			                                         std::memory_order_acquire)) {
+				seg = fresh;
+			} else {
+				delete[] fresh;
+			}
+		}
+		return seg[offset];
+	}
+
+	// Calls `f` with each used slot
+	template <class UnaryFunction>
+	void forEach(UnaryFunction f) const
+	{
+		for (std::size_t s{}; NUM_SEGMENTS != s; ++s) {
+			Slot* seg = segments_[s].load(std::memory_order_acquire);
+			if (nullptr == seg) {
+				continue;
+			}
+			for (Slot* it = seg, *last = seg + (std::size_t(1) << s); last != it; ++it) {
+				if (it->used) {
+					f(*it);
+				}
+			}
+		}
+	}
+
+ private:
+	T                                            init_{};
+	std::array<std::atomic<Slot*>, NUM_SEGMENTS> segments_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_PER_THREAD_HPP
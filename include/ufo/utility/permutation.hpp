@@ -0,0 +1,168 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_PERMUTATION_HPP
+#define UFO_UTILITY_PERMUTATION_HPP
+
+// UFO
+#include <ufo/utility/index_iterator.hpp>
+#include <ufo/utility/parallel_for.hpp>
+#include <ufo/utility/radix_sort.hpp>
+#include <ufo/utility/span.hpp>
+#include <ufo/utility/tuple_iterator.hpp>
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(UFO_TBB)
+// TBB
+#include <tbb/parallel_sort.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Computes the permutation that stably sorts `keys` in ascending order.
+ *
+ * Arithmetic keys (e.g., Morton codes) are sorted with the parallel LSD radix sort
+ * (see `radixSortByKey`), other keys with a (parallel, with TBB) comparison sort.
+ *
+ * @param keys Contiguous container of keys.
+ * @param perm Set to the permutation, `keys[perm[i]]` is the `i`th smallest key.
+ */
+template <class Keys>
+void sortPermutation(Keys const& keys, std::vector<std::size_t>& perm)
+{
+	using Key = std::decay_t<decltype(*std::data(keys))>;
+
+	std::size_t const n = std::size(keys);
+	perm.resize(n);
+	std::iota(perm.begin(), perm.end(), std::size_t(0));
+
+	if constexpr (std::is_arithmetic_v<Key>) {
+		std::vector<Key> k(std::data(keys), std::data(keys) + n);
+		radixSortByKey(k, perm);
+	} else {
+		auto const* src = std::data(keys);
+		auto const  cmp = [src](std::size_t a, std::size_t b) {
+			return src[a] < src[b] || (!(src[b] < src[a]) && a < b);
+		};
+#if defined(UFO_TBB)
+		tbb::parallel_sort(perm.begin(), perm.end(), cmp);
+#else
+		std::sort(perm.begin(), perm.end(), cmp);
+#endif
+	}
+}
+
+template <class Keys>
+[[nodiscard]] std::vector<std::size_t> sortPermutation(Keys const& keys)
+{
+	std::vector<std::size_t> perm;
+	sortPermutation(keys, perm);
+	return perm;
+}
+
+/*!
+ * @brief Reorders the contiguous container `c` such that element `i` becomes the former
+ * element `perm[i]`.
+ *
+ * Gathers into a temporary in parallel and moves the result back, i.e., two streaming
+ * passes over the data regardless of the permutation.
+ */
+template <class Container>
+void applyPermutation(Container& c, Span<std::size_t const> perm)
+{
+	using T = std::decay_t<decltype(*std::data(c))>;
+
+	assert(std::size(c) == perm.size());
+
+	std::vector<T> tmp(perm.size());
+	auto*          data = std::data(c);
+	parallel_for(IndexIterator<std::size_t>(0, perm.size(), 1, 4096),
+	             [&tmp, data, perm](std::size_t i) { tmp[i] = std::move(data[perm[i]]); });
+	parallel_for(IndexIterator<std::size_t>(0, perm.size(), 1, 4096),
+	             [&tmp, data](std::size_t i) { data[i] = std::move(tmp[i]); });
+}
+
+namespace detail
+{
+template <class... Ts, std::size_t... Is>
+void applyPermutation(TupleIterator<Ts...>& zip, Span<std::size_t const> perm,
+                      std::index_sequence<Is...>)
+{
+	(ufo::applyPermutation(zip.template column<Is>(), perm), ...);
+}
+}  // namespace detail
+
+/*!
+ * @brief Reorders all zipped containers such that element `i` becomes the former
+ * element `perm[i]`.
+ */
+template <class... Ts>
+void applyPermutation(TupleIterator<Ts...>& zip, Span<std::size_t const> perm)
+{
+	detail::applyPermutation(zip, perm, std::index_sequence_for<Ts...>{});
+}
+
+/*!
+ * @brief Stably sorts all zipped containers by the `I`th one.
+ *
+ * Computes the permutation from the key column alone with `sortPermutation` and then
+ * applies it to every column, instead of sorting through the proxy references (which
+ * swaps whole tuples for every exchange).
+ */
+template <std::size_t I, class... Ts>
+void sortByKey(TupleIterator<Ts...>& zip)
+{
+	std::vector<std::size_t> const perm = sortPermutation(zip.template column<I>());
+	applyPermutation(zip, Span<std::size_t const>(perm.data(), perm.size()));
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_PERMUTATION_HPP
@@ -0,0 +1,412 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_POOL_HPP
+#define UFO_UTILITY_POOL_HPP
+
+// UFO
+#include <ufo/utility/spinlock.hpp>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#if defined(UFO_TBB)
+// TBB
+#include <tbb/enumerable_thread_specific.h>
+#endif
+
+namespace ufo
+{
+namespace detail
+{
+/*!
+ * @brief Free list of fixed-size blocks carved out of slabs from an upstream resource.
+ */
+class FreeList
+{
+	struct Node {
+		Node* next;
+	};
+
+	struct Slab {
+		Slab*       next;
+		std::size_t size;
+	};
+
+ public:
+	FreeList(std::size_t block_size, std::size_t block_align, std::size_t blocks_per_slab,
+	         std::pmr::memory_resource* upstream)
+	    : block_align_(std::max(block_align, alignof(Node)))
+	    , block_size_(roundUp(std::max(block_size, sizeof(Node)), block_align_))
+	    , header_size_(roundUp(sizeof(Slab), block_align_))
+	    , blocks_per_slab_(std::max(blocks_per_slab, std::size_t(1)))
+	    , upstream_(upstream)
+	{
+	}
+
+	FreeList(FreeList const&)            = delete;
+	FreeList& operator=(FreeList const&) = delete;
+
+	~FreeList() { release(); }
+
+	[[nodiscard]] void* pop()
+	{
+		if (nullptr == free_) {
+			grow();
+		}
+		Node* n = free_;
+		free_   = n->next;
+		return n;
+	}
+
+	void push(void* p) noexcept
+	{
+		Node* n = static_cast<Node*>(p);
+		n->next = free_;
+		free_   = n;
+	}
+
+	/*!
+	 * @brief Pops `count` blocks as a linked list.
+	 */
+	[[nodiscard]] void* popChain(std::size_t count)
+	{
+		Node* first = nullptr;
+		for (; 0 != count; --count) {
+			Node* n = static_cast<Node*>(pop());
+			n->next = first;
+			first   = n;
+		}
+		return first;
+	}
+
+	/*!
+	 * @brief Pushes a linked list of blocks from `first` to `last`.
+	 */
+	void pushChain(void* first, void* last) noexcept
+	{
+		static_cast<Node*>(last)->next = free_;
+		free_                          = static_cast<Node*>(first);
+	}
+
+	[[nodiscard]] static void* next(void* p) noexcept
+	{
+		return static_cast<Node*>(p)->next;
+	}
+
+	static void setNext(void* p, void* next) noexcept
+	{
+		static_cast<Node*>(p)->next = static_cast<Node*>(next);
+	}
+
+	void release() noexcept
+	{
+		while (nullptr != slabs_) {
+			Slab* next = slabs_->next;
+			upstream_->deallocate(slabs_, slabs_->size, block_align_);
+			slabs_ = next;
+		}
+		free_ = nullptr;
+	}
+
+	[[nodiscard]] bool fits(std::size_t bytes, std::size_t alignment) const noexcept
+	{
+		return block_size_ >= bytes && block_align_ >= alignment;
+	}
+
+	[[nodiscard]] std::size_t blockSize() const noexcept { return block_size_; }
+
+	[[nodiscard]] std::pmr::memory_resource* upstream() const noexcept
+	{
+		return upstream_;
+	}
+
+ private:
+	[[nodiscard]] static constexpr std::size_t roundUp(std::size_t n,
+	                                                   std::size_t a) noexcept
+	{
+		return (n + a - 1) / a * a;
+	}
+
+	void grow()
+	{
+		std::size_t const size = header_size_ + blocks_per_slab_ * block_size_;
+		Slab* s = static_cast<Slab*>(upstream_->allocate(size, block_align_));
+		s->next = slabs_;
+		s->size = size;
+		slabs_  = s;
+
+		char* first = reinterpret_cast<char*>(s) + header_size_;
+		for (std::size_t i = blocks_per_slab_; 0 != i; --i) {
+			push(first + (i - 1) * block_size_);
+		}
+
+		// Amortize the upstream calls over more blocks as the pool grows
+		blocks_per_slab_ = std::min(2 * blocks_per_slab_, std::size_t(1) << 16);
+	}
+
+ private:
+	std::size_t                block_align_;
+	std::size_t                block_size_;
+	std::size_t                header_size_;
+	std::size_t                blocks_per_slab_;
+	std::pmr::memory_resource* upstream_;
+	Node*                      free_{};
+	Slab*                      slabs_{};
+};
+}  // namespace detail
+
+/*!
+ * @brief Pool of fixed-size blocks, recycled through a free list.
+ *
+ * Allocations that fit in a block (size and alignment) are a pop from the free list,
+ * deallocations a push, so allocating and freeing nodes of the same type (e.g., octree
+ * nodes or `std::list`/`std::map` nodes through `ResourceAllocator`) never reaches the
+ * global allocator after warm up. Larger allocations are forwarded to the upstream
+ * resource. The memory is returned upstream on `release` or destruction.
+ *
+ * Not thread-safe, see `ThreadCachedPool` for that.
+ */
+class PoolResource final : public std::pmr::memory_resource
+{
+ public:
+	explicit PoolResource(
+	    std::size_t block_size, std::size_t block_align = alignof(std::max_align_t),
+	    std::size_t                blocks_per_slab = 64,
+	    std::pmr::memory_resource* upstream        = std::pmr::get_default_resource())
+	    : blocks_(block_size, block_align, blocks_per_slab, upstream)
+	{
+	}
+
+	/*!
+	 * @brief Returns all blocks to the upstream resource, invalidating all allocations.
+	 */
+	void release() noexcept { blocks_.release(); }
+
+	[[nodiscard]] std::size_t blockSize() const noexcept { return blocks_.blockSize(); }
+
+	[[nodiscard]] std::pmr::memory_resource* upstream() const noexcept
+	{
+		return blocks_.upstream();
+	}
+
+ protected:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		return blocks_.fits(bytes, alignment) ? blocks_.pop()
+		                                      : upstream()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+	{
+		if (blocks_.fits(bytes, alignment)) {
+			blocks_.push(p);
+		} else {
+			upstream()->deallocate(p, bytes, alignment);
+		}
+	}
+
+	[[nodiscard]] bool do_is_equal(
+	    std::pmr::memory_resource const& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+ private:
+	detail::FreeList blocks_;
+};
+
+/*!
+ * @brief Typed pool constructing and destroying `T`s in pooled blocks.
+ */
+template <class T>
+class ObjectPool
+{
+ public:
+	explicit ObjectPool(
+	    std::size_t                blocks_per_slab = 64,
+	    std::pmr::memory_resource* upstream        = std::pmr::get_default_resource())
+	    : pool_(sizeof(T), alignof(T), blocks_per_slab, upstream)
+	{
+	}
+
+	template <class... Args>
+	[[nodiscard]] T* create(Args&&... args)
+	{
+		void* p = pool_.allocate(sizeof(T), alignof(T));
+		try {
+			return new (p) T(std::forward<Args>(args)...);
+		} catch (...) {
+			pool_.deallocate(p, sizeof(T), alignof(T));
+			throw;
+		}
+	}
+
+	void destroy(T* p) noexcept
+	{
+		p->~T();
+		pool_.deallocate(p, sizeof(T), alignof(T));
+	}
+
+	/*!
+	 * @brief The underlying resource, e.g., for a `ResourceAllocator<T, PoolResource>`.
+	 */
+	[[nodiscard]] PoolResource& resource() noexcept { return pool_; }
+
+ private:
+	PoolResource pool_;
+};
+
+/*!
+ * @brief Thread-safe pool of fixed-size blocks with per-thread caches.
+ *
+ * Each thread allocates from and frees to its own cache without synchronization. Only
+ * when a cache runs empty (or grows beyond twice `batch_size`) is a batch of blocks
+ * moved from (to) the shared free list, under a lock. Blocks may be freed by another
+ * thread than the one that allocated them.
+ *
+ * Allocations larger than a block go to the upstream resource, which then has to be
+ * thread-safe (as the default resource is).
+ *
+ * Without TBB there are no per-thread caches, every call takes the lock.
+ */
+class ThreadCachedPool final : public std::pmr::memory_resource
+{
+#if defined(UFO_TBB)
+	struct Cache {
+		void*       head{};
+		std::size_t size{};
+	};
+#endif
+
+ public:
+	explicit ThreadCachedPool(
+	    std::size_t block_size, std::size_t block_align = alignof(std::max_align_t),
+	    std::size_t                batch_size = 64,
+	    std::pmr::memory_resource* upstream   = std::pmr::get_default_resource())
+	    : blocks_(block_size, block_align, 4 * batch_size, upstream)
+	    , batch_size_(std::max(batch_size, std::size_t(1)))
+	{
+	}
+
+	[[nodiscard]] std::size_t blockSize() const noexcept { return blocks_.blockSize(); }
+
+	[[nodiscard]] std::pmr::memory_resource* upstream() const noexcept
+	{
+		return blocks_.upstream();
+	}
+
+ protected:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		if (!blocks_.fits(bytes, alignment)) {
+			return upstream()->allocate(bytes, alignment);
+		}
+
+#if defined(UFO_TBB)
+		Cache& c = caches_.local();
+		if (nullptr == c.head) {
+			std::lock_guard<Spinlock> lock(lock_);
+			c.head = blocks_.popChain(batch_size_);
+			c.size = batch_size_;
+		}
+		void* p = c.head;
+		c.head  = detail::FreeList::next(p);
+		--c.size;
+		return p;
+#else
+		std::lock_guard<Spinlock> lock(lock_);
+		return blocks_.pop();
+#endif
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+	{
+		if (!blocks_.fits(bytes, alignment)) {
+			upstream()->deallocate(p, bytes, alignment);
+			return;
+		}
+
+#if defined(UFO_TBB)
+		Cache& c = caches_.local();
+		detail::FreeList::setNext(p, c.head);
+		c.head = p;
+		if (2 * batch_size_ < ++c.size) {
+			// Give a batch back so blocks freed by other threads than the allocating one
+			// do not pile up
+			void* last = c.head;
+			for (std::size_t i = 1; batch_size_ != i; ++i) {
+				last = detail::FreeList::next(last);
+			}
+			void* first = c.head;
+			c.head      = detail::FreeList::next(last);
+			c.size -= batch_size_;
+			std::lock_guard<Spinlock> lock(lock_);
+			blocks_.pushChain(first, last);
+		}
+#else
+		std::lock_guard<Spinlock> lock(lock_);
+		blocks_.push(p);
+#endif
+	}
+
+	[[nodiscard]] bool do_is_equal(
+	    std::pmr::memory_resource const& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+ private:
+	detail::FreeList blocks_;
+	std::size_t      batch_size_;
+	Spinlock         lock_;
+#if defined(UFO_TBB)
+	tbb::enumerable_thread_specific<Cache> caches_;
+#endif
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_POOL_HPP
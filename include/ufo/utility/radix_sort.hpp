@@ -0,0 +1,392 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_RADIX_SORT_HPP
+#define UFO_UTILITY_RADIX_SORT_HPP
+
+// UFO
+#include <ufo/utility/index_iterator.hpp>
+#include <ufo/utility/parallel_for.hpp>
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(UFO_TBB)
+// TBB
+#include <tbb/task_arena.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Scratch memory for `radixSort`/`radixSortByKey`.
+ *
+ * Keeping a buffer around between calls (e.g., one per integration thread) avoids
+ * allocating and touching new memory for every sort.
+ *
+ * @tparam Ts The types of the arrays being sorted.
+ */
+template <class... Ts>
+class RadixSortBuffer
+{
+ public:
+	/*!
+	 * @brief Makes sure sorting `n` elements does not allocate.
+	 */
+	void reserve(std::size_t n)
+	{
+		std::apply([n](auto&... v) { (v.resize(std::max(v.size(), n)), ...); }, arrays_);
+	}
+
+	/*!
+	 * @brief Releases the memory.
+	 */
+	void clear() noexcept
+	{
+		std::apply([](auto&... v) { ((v.clear(), v.shrink_to_fit()), ...); }, arrays_);
+		histograms_.clear();
+		histograms_.shrink_to_fit();
+	}
+
+	/*!
+	 * @brief Returns scratch arrays with room for `n` elements each.
+	 */
+	[[nodiscard]] std::tuple<Ts*...> arrays(std::size_t n)
+	{
+		reserve(n);
+		return std::apply([](auto&... v) { return std::tuple<Ts*...>(v.data()...); },
+		                  arrays_);
+	}
+
+	/*!
+	 * @brief Returns scratch memory for `n` histogram counters.
+	 */
+	[[nodiscard]] std::size_t* histograms(std::size_t n)
+	{
+		if (histograms_.size() < n) {
+			histograms_.resize(n);
+		}
+		return histograms_.data();
+	}
+
+ private:
+	std::tuple<std::vector<Ts>...> arrays_;
+	std::vector<std::size_t>       histograms_;
+};
+
+namespace detail
+{
+struct RadixIdentity {
+	template <class T>
+	[[nodiscard]] constexpr T operator()(T const& t) const noexcept
+	{
+		return t;
+	}
+};
+
+/*!
+ * @brief Maps an integral or floating point key to an unsigned integer with the same
+ * ordering.
+ *
+ * For floating point `-0.0` is ordered before `+0.0`, and NaNs are placed at the ends
+ * depending on their sign.
+ */
+template <class Key>
+[[nodiscard]] constexpr auto radixKey(Key key) noexcept
+{
+	if constexpr (std::is_floating_point_v<Key>) {
+		using U = std::conditional_t<4 == sizeof(Key), std::uint32_t, std::uint64_t>;
+		static_assert(sizeof(Key) == sizeof(U), "Unsupported floating point type");
+		U bits;
+		std::memcpy(&bits, &key, sizeof(Key));
+		U const sign = U(1) << (std::numeric_limits<U>::digits - 1);
+		return static_cast<U>(bits ^ ((bits & sign) ? ~U(0) : sign));
+	} else if constexpr (std::is_signed_v<Key>) {
+		using U = std::make_unsigned_t<Key>;
+		return static_cast<U>(static_cast<U>(key) ^
+		                      (U(1) << (std::numeric_limits<U>::digits - 1)));
+	} else {
+		static_assert(std::is_unsigned_v<Key>, "Radix sort requires arithmetic keys");
+		return key;
+	}
+}
+
+[[nodiscard]] inline std::size_t radixNumBlocks(std::size_t n, std::size_t radix) noexcept
+{
+#if defined(UFO_TBB)
+	// Enough blocks for load balancing, but each large enough to amortize clearing and
+	// summing its histogram
+	std::size_t const max_blocks =
+	    4 * static_cast<std::size_t>(tbb::this_task_arena::max_concurrency());
+	return std::clamp(n / std::max(std::size_t(1) << 16, 16 * radix), std::size_t(1),
+	                  max_blocks);
+#else
+	(void)n;
+	(void)radix;
+	return 1;
+#endif
+}
+
+template <class... Ts, std::size_t... Is>
+void radixCopy(std::tuple<Ts*...> const& src, std::size_t i,
+               std::tuple<Ts*...> const& dst, std::size_t j,
+               std::index_sequence<Is...>) noexcept
+{
+	((std::get<Is>(dst)[j] = std::get<Is>(src)[i]), ...);
+}
+
+/*!
+ * @brief Stable parallel LSD radix sort of the `n` elements of the arrays in `src` by
+ * `key(std::get<0>(src)[i])`.
+ *
+ * A first pass computes which bits differ between any two keys, digits where all keys
+ * agree are skipped entirely. Each remaining pass builds a histogram per block in
+ * parallel, turns them into scatter offsets, and then scatters the blocks in parallel
+ * into `dst`, after which the roles of `src` and `dst` are swapped.
+ *
+ * @return Whether the sorted result ended up in `dst`.
+ */
+template <unsigned DigitBits, class KeyFn, class... Ts>
+bool radixSort(std::size_t n, KeyFn key, std::tuple<Ts*...> src, std::tuple<Ts*...> dst,
+               RadixSortBuffer<Ts...>& buffer)
+{
+	static_assert(0 < DigitBits && 16 >= DigitBits, "Digits have to be [1..16] bits");
+
+	using First = std::remove_pointer_t<std::tuple_element_t<0, std::tuple<Ts*...>>>;
+	using U     = decltype(radixKey(key(std::declval<First const&>())));
+
+	constexpr std::size_t RADIX = std::size_t(1) << DigitBits;
+	constexpr U           MASK  = static_cast<U>(RADIX - 1);
+
+	std::size_t const num_blocks = radixNumBlocks(n, RADIX);
+	std::size_t const block_size = (n + num_blocks - 1) / num_blocks;
+
+	auto const radix_key = [&key](First const& e) { return radixKey(key(e)); };
+
+	// Find the bits that are not the same for all keys
+	std::vector<std::pair<U, U>> and_or(num_blocks);
+	parallel_for(IndexIterator<std::size_t>(0, num_blocks), [&](std::size_t b) {
+		First const* s = std::get<0>(src);
+		U            a = static_cast<U>(~U(0));
+		U            o{};
+		for (std::size_t i = b * block_size, last = std::min(n, i + block_size); last != i;
+		     ++i) {
+			U const k = radix_key(s[i]);
+			a &= k;
+			o |= k;
+		}
+		and_or[b] = {a, o};
+	});
+	U a = static_cast<U>(~U(0));
+	U o{};
+	for (auto [ba, bo] : and_or) {
+		a &= ba;
+		o |= bo;
+	}
+	U const diff = static_cast<U>(a ^ o);
+
+	std::size_t* offsets = buffer.histograms(num_blocks * RADIX);
+
+	bool swapped = false;
+	for (unsigned shift{}; std::numeric_limits<U>::digits > shift; shift += DigitBits) {
+		if (0 == static_cast<U>((diff >> shift) & MASK)) {
+			continue;
+		}
+
+		parallel_for(IndexIterator<std::size_t>(0, num_blocks), [&](std::size_t b) {
+			First const* s    = std::get<0>(src);
+			std::size_t* hist = offsets + b * RADIX;
+			std::fill(hist, hist + RADIX, std::size_t(0));
+			for (std::size_t i = b * block_size, last = std::min(n, i + block_size); last != i;
+			     ++i) {
+				++hist[(radix_key(s[i]) >> shift) & MASK];
+			}
+		});
+
+		// Exclusive prefix sum, digit-major so each block scatters stably after the
+		// blocks before it
+		std::size_t sum{};
+		for (std::size_t d{}; RADIX != d; ++d) {
+			for (std::size_t b{}; num_blocks != b; ++b) {
+				std::size_t const c    = offsets[b * RADIX + d];
+				offsets[b * RADIX + d] = sum;
+				sum += c;
+			}
+		}
+
+		parallel_for(IndexIterator<std::size_t>(0, num_blocks), [&](std::size_t b) {
+			First const* s      = std::get<0>(src);
+			std::size_t* offset = offsets + b * RADIX;
+			for (std::size_t i = b * block_size, last = std::min(n, i + block_size); last != i;
+			     ++i) {
+				std::size_t const j = offset[(radix_key(s[i]) >> shift) & MASK]++;
+				radixCopy(src, i, dst, j, std::index_sequence_for<Ts...>{});
+			}
+		});
+
+		std::swap(src, dst);
+		swapped = !swapped;
+	}
+
+	return swapped;
+}
+
+template <class T>
+void radixCopyBack(T* dst, T const* src, std::size_t n)
+{
+	parallel_for(IndexIterator<std::size_t>(0, n, 1, 1 << 14),
+	             [dst, src](std::size_t i) { dst[i] = src[i]; });
+}
+}  // namespace detail
+
+/*!
+ * @brief Stable parallel LSD radix sort, ascending by `key(element)`.
+ *
+ * Suited for large arrays of integral or floating point keys such as Morton codes, or
+ * of records sorted by such a key, e.g., `(code, index)` pairs with `key` returning
+ * the code. Digits where all keys agree are skipped, so sorting codes that only use
+ * the lower bits costs only the passes needed.
+ *
+ * Runs in parallel with TBB.
+ *
+ * @tparam DigitBits Bits per pass, e.g., 8, 11 or 16. Larger digits need fewer passes
+ * but larger histograms; 8 is a good default, 11 is good for 32 bit keys (3 passes)
+ * and 16 for very large arrays.
+ * @param data Contiguous container of trivially copyable elements.
+ * @param buffer Scratch memory, reused between calls.
+ * @param key Projection returning an arithmetic key, identity by default.
+ */
+template <unsigned DigitBits = 8, class Container, class T,
+          class KeyFn = detail::RadixIdentity>
+void radixSort(Container&& data, RadixSortBuffer<T>& buffer, KeyFn key = KeyFn{})
+{
+	static_assert(std::is_same_v<T, std::remove_pointer_t<decltype(std::data(data))>>,
+	              "The buffer has to be of the element type");
+
+	std::size_t const n = std::size(data);
+	T*                d = std::data(data);
+
+	if (64 >= n) {
+		std::stable_sort(d, d + n, [&key](T const& a, T const& b) {
+			return detail::radixKey(key(a)) < detail::radixKey(key(b));
+		});
+		return;
+	}
+
+	auto [tmp] = buffer.arrays(n);
+	if (detail::radixSort<DigitBits>(n, key, std::tuple<T*>(d), std::tuple<T*>(tmp),
+	                                 buffer)) {
+		detail::radixCopyBack(d, tmp, n);
+	}
+}
+
+/*!
+ * @brief Same as above, allocating the scratch memory.
+ */
+template <unsigned DigitBits = 8, class Container, class KeyFn = detail::RadixIdentity>
+void radixSort(Container&& data, KeyFn key = KeyFn{})
+{
+	RadixSortBuffer<std::remove_pointer_t<decltype(std::data(data))>> buffer;
+	radixSort<DigitBits>(std::forward<Container>(data), buffer, key);
+}
+
+/*!
+ * @brief Stable parallel LSD radix sort of `keys`, with `values` reordered along.
+ *
+ * Same as `radixSort`, but for keys and values in separate arrays. The typical use is
+ * sorting Morton codes together with the indices `0, 1, ..., n - 1` to get the
+ * permutation that sorts them (see `sortPermutation`).
+ *
+ * @param keys Contiguous container of integral or floating point keys.
+ * @param values Contiguous container of trivially copyable values, same size as `keys`.
+ * @param buffer Scratch memory, reused between calls.
+ */
+template <unsigned DigitBits = 8, class KeyContainer, class ValueContainer, class Key,
+          class Value>
+void radixSortByKey(KeyContainer&& keys, ValueContainer&& values,
+                    RadixSortBuffer<Key, Value>& buffer)
+{
+	static_assert(std::is_same_v<Key, std::remove_pointer_t<decltype(std::data(keys))>>,
+	              "The buffer has to be of the key type");
+	static_assert(
+	    std::is_same_v<Value, std::remove_pointer_t<decltype(std::data(values))>>,
+	    "The buffer has to be of the value type");
+
+	std::size_t const n = std::size(keys);
+	assert(std::size(values) == n);
+
+	Key*   k = std::data(keys);
+	Value* v = std::data(values);
+
+	auto [k_tmp, v_tmp] = buffer.arrays(n);
+	if (detail::radixSort<DigitBits>(n, detail::RadixIdentity{},
+	                                 std::tuple<Key*, Value*>(k, v),
+	                                 std::tuple<Key*, Value*>(k_tmp, v_tmp), buffer)) {
+		detail::radixCopyBack(k, k_tmp, n);
+		detail::radixCopyBack(v, v_tmp, n);
+	}
+}
+
+/*!
+ * @brief Same as above, allocating the scratch memory.
+ */
+template <unsigned DigitBits = 8, class KeyContainer, class ValueContainer>
+void radixSortByKey(KeyContainer&& keys, ValueContainer&& values)
+{
+	RadixSortBuffer<std::remove_pointer_t<decltype(std::data(keys))>,
+	                std::remove_pointer_t<decltype(std::data(values))>>
+	    buffer;
+	radixSortByKey<DigitBits>(std::forward<KeyContainer>(keys),
+	                          std::forward<ValueContainer>(values), buffer);
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_RADIX_SORT_HPP
@@ -0,0 +1,120 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_RESOURCE_ALLOCATOR_HPP
+#define UFO_UTILITY_RESOURCE_ALLOCATOR_HPP
+
+// STL
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+
+namespace ufo
+{
+/*!
+ * @brief C++ allocator drawing its memory from `Resource`.
+ *
+ * Works like `std::pmr::polymorphic_allocator`, but keeps the static type of the
+ * resource. As the resources in this library are `final`, the allocation calls are
+ * devirtualized and inlined, so, e.g., `std::vector<T, ResourceAllocator<T,
+ * MonotonicArena>>` allocates with a pointer bump.
+ *
+ * @tparam Resource A `std::pmr::memory_resource`.
+ */
+template <class T, class Resource = std::pmr::memory_resource>
+class ResourceAllocator
+{
+	static_assert(std::is_base_of_v<std::pmr::memory_resource, Resource>,
+	              "Resource has to be a std::pmr::memory_resource");
+
+	template <class, class>
+	friend class ResourceAllocator;
+
+ public:
+	using value_type = T;
+
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap            = std::true_type;
+
+	template <class U>
+	struct rebind {
+		using other = ResourceAllocator<U, Resource>;
+	};
+
+	ResourceAllocator(Resource& resource) noexcept : resource_(&resource) {}
+
+	template <class U>
+	ResourceAllocator(ResourceAllocator<U, Resource> const& other) noexcept
+	    : resource_(other.resource_)
+	{
+	}
+
+	[[nodiscard]] T* allocate(std::size_t n)
+	{
+		return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		resource_->deallocate(p, n * sizeof(T), alignof(T));
+	}
+
+	[[nodiscard]] Resource* resource() const noexcept { return resource_; }
+
+	template <class U>
+	[[nodiscard]] bool operator==(ResourceAllocator<U, Resource> const& rhs) const noexcept
+	{
+		return resource_ == rhs.resource_ || resource_->is_equal(*rhs.resource_);
+	}
+
+	template <class U>
+	[[nodiscard]] bool operator!=(ResourceAllocator<U, Resource> const& rhs) const noexcept
+	{
+		return !(*this == rhs);
+	}
+
+ private:
+	Resource* resource_;
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_RESOURCE_ALLOCATOR_HPP
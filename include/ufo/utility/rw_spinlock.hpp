@@ -0,0 +1,141 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_RW_SPINLOCK_HPP
+#define UFO_UTILITY_RW_SPINLOCK_HPP
+
+// UFO
+#include <ufo/utility/backoff.hpp>
+#include <ufo/utility/cache_line.hpp>
+
+// STL
+#include <atomic>
+#include <cstdint>
+
+namespace ufo
+{
+/*!
+ * @brief Reader-writer spinlock with writer preference.
+ *
+ * Any number of readers can hold the lock at the same time, while a writer holds it
+ * exclusively. As soon as a writer is waiting no new readers are let in, so a steady
+ * stream of readers cannot starve writers.
+ *
+ * Satisfies the SharedLockable requirements, so it can be used with
+ * `std::lock_guard`/`std::unique_lock` for writing and `std::shared_lock` for reading.
+ *
+ * The lock is aligned to a cache line to avoid false sharing with neighbouring data.
+ */
+class alignas(CACHE_LINE_SIZE) RWSpinlock
+{
+	static constexpr std::uint32_t WRITER         = 1;
+	static constexpr std::uint32_t WRITER_PENDING = 2;
+	static constexpr std::uint32_t READER         = 4;
+
+ public:
+	RWSpinlock() = default;
+
+	RWSpinlock(RWSpinlock const&)            = delete;
+	RWSpinlock& operator=(RWSpinlock const&) = delete;
+
+	void lock() noexcept
+	{
+		for (Backoff backoff; !try_lock(); backoff.snooze()) {
+			// Announce that we are waiting so no new readers acquire the lock
+			if (!(state_.load(std::memory_order_relaxed) & WRITER_PENDING)) {
+				state_.fetch_or(WRITER_PENDING, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool try_lock() noexcept
+	{
+		std::uint32_t expected = state_.load(std::memory_order_relaxed) & WRITER_PENDING;
+		return state_.compare_exchange_strong(expected, WRITER, std::memory_order_acquire,
+		                                      std::memory_order_relaxed);
+	}
+
+	void unlock() noexcept
+	{
+		// Other writers might have set `WRITER_PENDING` in the meantime, so only clear
+		// our own bit
+		state_.fetch_and(~WRITER, std::memory_order_release);
+	}
+
+	void lock_shared() noexcept
+	{
+		for (Backoff backoff; !try_lock_shared(); backoff.snooze()) {
+		}
+	}
+
+	bool try_lock_shared() noexcept
+	{
+		if (state_.load(std::memory_order_relaxed) & (WRITER | WRITER_PENDING)) {
+			return false;
+		}
+
+		if (state_.fetch_add(READER, std::memory_order_acquire) &
+		    (WRITER | WRITER_PENDING)) {
+			state_.fetch_sub(READER, std::memory_order_relaxed);
+			return false;
+		}
+
+		return true;
+	}
+
+	void unlock_shared() noexcept { state_.fetch_sub(READER, std::memory_order_release); }
+
+	/*!
+	 * @brief Number of readers currently holding the lock.
+	 *
+	 * @note Only a snapshot, intended for debugging and statistics.
+	 */
+	[[nodiscard]] std::uint32_t readers() const noexcept
+	{
+		return state_.load(std::memory_order_relaxed) / READER;
+	}
+
+ private:
+	std::atomic<std::uint32_t> state_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_RW_SPINLOCK_HPP
\ No newline at end of file
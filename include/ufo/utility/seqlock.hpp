@@ -0,0 +1,214 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_SEQLOCK_HPP
+#define UFO_UTILITY_SEQLOCK_HPP
+
+// UFO
+#include <ufo/utility/backoff.hpp>
+#include <ufo/utility/cache_line.hpp>
+
+// STL
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ufo
+{
+/*!
+ * @brief Sequence lock protecting a small trivially copyable value.
+ *
+ * Readers never write to shared memory, so they do not contend with each other or
+ * with the writer; instead a read is retried if a write happened while it was in
+ * progress. This makes it suitable for small, frequently read and rarely written data
+ * such as poses and bounding boxes.
+ *
+ * Writers are serialized through `lock`/`unlock` (so `std::lock_guard` works as with
+ * `Spinlock`), or simply by calling `store`/`update`.
+ *
+ * The value is stored as relaxed atomic words, so concurrent reads are free of data
+ * races.
+ *
+ * @tparam T The type of the protected value, must be trivially copyable.
+ */
+template <class T>
+class alignas(CACHE_LINE_SIZE) SeqLock
+{
+	static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires trivially copyable T");
+	static_assert(std::is_default_constructible_v<T>,
+	              "SeqLock requires default constructible T");
+
+	static constexpr std::size_t NUM_WORDS =
+	    (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+ public:
+	using value_type = T;
+
+	SeqLock() : SeqLock(T{}) {}
+
+	explicit SeqLock(T const& value) noexcept { storeUnsafe(value); }
+
+	SeqLock(SeqLock const&)            = delete;
+	SeqLock& operator=(SeqLock const&) = delete;
+
+	/*!
+	 * @brief Returns a consistent copy of the value, retrying while a write is in
+	 * progress.
+	 */
+	[[nodiscard]] T load() const noexcept
+	{
+		T value;
+		for (Backoff backoff; !tryLoad(value); backoff.snooze()) {
+		}
+		return value;
+	}
+
+	/*!
+	 * @brief Tries to read the value once.
+	 *
+	 * @param value Set to a consistent copy of the value if successful.
+	 * @return Whether the read was consistent, i.e., no write happened concurrently.
+	 */
+	bool tryLoad(T& value) const noexcept
+	{
+		std::uint32_t const seq = seq_.load(std::memory_order_acquire);
+		if (seq & 1u) {
+			return false;
+		}
+
+		std::array<std::uint64_t, NUM_WORDS> buf;
+		for (std::size_t i{}; NUM_WORDS != i; ++i) {
+			buf[i] = data_[i].load(std::memory_order_relaxed);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (seq != seq_.load(std::memory_order_relaxed)) {
+			return false;
+		}
+
+		std::memcpy(&value, buf.data(), sizeof(T));
+		return true;
+	}
+
+	void store(T const& value) noexcept
+	{
+		lock();
+		storeUnsafe(value);
+		unlock();
+	}
+
+	/*!
+	 * @brief Atomically applies `f` to the value, as seen by readers.
+	 *
+	 * @param f Callable taking a `T&`.
+	 */
+	template <class UnaryFunction>
+	void update(UnaryFunction f)
+	{
+		lock();
+		T value = loadUnsafe();
+		f(value);
+		storeUnsafe(value);
+		unlock();
+	}
+
+	/*!
+	 * @brief Stores the value without taking the lock, the caller has to hold it.
+	 */
+	void storeUnsafe(T const& value) noexcept
+	{
+		std::array<std::uint64_t, NUM_WORDS> buf{};
+		std::memcpy(buf.data(), &value, sizeof(T));
+		for (std::size_t i{}; NUM_WORDS != i; ++i) {
+			data_[i].store(buf[i], std::memory_order_relaxed);
+		}
+	}
+
+	/*!
+	 * @brief Loads the value without checking for concurrent writes, the caller has to
+	 * hold the lock.
+	 */
+	[[nodiscard]] T loadUnsafe() const noexcept
+	{
+		std::array<std::uint64_t, NUM_WORDS> buf;
+		for (std::size_t i{}; NUM_WORDS != i; ++i) {
+			buf[i] = data_[i].load(std::memory_order_relaxed);
+		}
+		T value;
+		std::memcpy(&value, buf.data(), sizeof(T));
+		return value;
+	}
+
+	void lock() noexcept
+	{
+		for (Backoff backoff; !try_lock(); backoff.snooze()) {
+		}
+	}
+
+	bool try_lock() noexcept
+	{
+		std::uint32_t seq = seq_.load(std::memory_order_relaxed);
+		// Acquire pairs with the release in `unlock`, so the previous writer's data is
+		// visible to `loadUnsafe`
+		if ((seq & 1u) ||
+		    !seq_.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire,
+		                                  std::memory_order_relaxed)) {
+			return false;
+		}
+		// Make sure the odd sequence number is visible before any of the data writes
+		std::atomic_thread_fence(std::memory_order_release);
+		return true;
+	}
+
+	void unlock() noexcept
+	{
+		seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+ private:
+	std::atomic<std::uint32_t>                        seq_{};
+	std::array<std::atomic<std::uint64_t>, NUM_WORDS> data_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_SEQLOCK_HPP
\ No newline at end of file
@@ -0,0 +1,572 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_SOA_VECTOR_HPP
+#define UFO_UTILITY_SOA_VECTOR_HPP
+
+// UFO
+#include <ufo/utility/cache_line.hpp>
+#include <ufo/utility/index_iterator.hpp>
+#include <ufo/utility/parallel_for.hpp>
+#include <ufo/utility/permutation.hpp>
+#include <ufo/utility/span.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(UFO_TBB)
+// TBB
+#include <tbb/parallel_sort.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Structure-of-arrays vector, storing each field in its own array.
+ *
+ * All columns live in a single allocation and grow together, each column starting on
+ * a cache line boundary. A pass that only needs some of the fields can work directly
+ * on those columns (see `column`) and never pulls the others into the cache, while
+ * the zipped iterators give the same interface as `TupleIterator`.
+ *
+ * @tparam Ts The field types, have to be trivially copyable.
+ */
+template <class... Ts>
+class SoAVector
+{
+	static_assert(0 < sizeof...(Ts), "SoAVector requires at least one column");
+	static_assert((std::is_trivially_copyable_v<Ts> && ...),
+	              "SoAVector requires trivially copyable column types");
+
+	static constexpr std::size_t NUM_COLUMNS = sizeof...(Ts);
+
+	template <std::size_t I>
+	using column_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+ public:
+	// Tags
+	using value_type      = std::tuple<Ts...>;
+	using size_type       = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference       = std::tuple<Ts&...>;
+	using const_reference = std::tuple<Ts const&...>;
+
+	template <bool Const>
+	class Iterator
+	{
+		friend class SoAVector;
+
+	 public:
+		// Tags
+		using iterator_category = std::random_access_iterator_tag;
+		using difference_type   = std::ptrdiff_t;
+		using value_type        = typename SoAVector::value_type;
+		using pointer           = void;
+		using reference = std::conditional_t<Const, typename SoAVector::const_reference,
+		                                     typename SoAVector::reference>;
+
+	 private:
+		using data_ptr = std::conditional_t<Const, SoAVector const*, SoAVector*>;
+
+	 public:
+		constexpr Iterator() = default;
+
+		constexpr Iterator& operator++()
+		{
+			++idx_;
+			return *this;
+		}
+
+		constexpr Iterator& operator--()
+		{
+			--idx_;
+			return *this;
+		}
+
+		constexpr Iterator operator++(int)
+		{
+			Iterator tmp(*this);
+			++idx_;
+			return tmp;
+		}
+
+		constexpr Iterator operator--(int)
+		{
+			Iterator tmp(*this);
+			--idx_;
+			return tmp;
+		}
+
+		constexpr Iterator operator+(difference_type n) const
+		{
+			Iterator tmp(*this);
+			tmp.idx_ += n;
+			return tmp;
+		}
+
+		constexpr Iterator operator-(difference_type n) const
+		{
+			Iterator tmp(*this);
+			tmp.idx_ -= n;
+			return tmp;
+		}
+
+		constexpr Iterator& operator+=(difference_type n)
+		{
+			idx_ += n;
+			return *this;
+		}
+
+		constexpr Iterator& operator-=(difference_type n)
+		{
+			idx_ -= n;
+			return *this;
+		}
+
+		[[nodiscard]] constexpr reference operator[](difference_type pos) const
+		{
+			return (*data_)[static_cast<size_type>(idx_ + pos)];
+		}
+
+		[[nodiscard]] constexpr reference operator*() const { return operator[](0); }
+
+		constexpr difference_type operator-(Iterator const& rhs) const
+		{
+			return idx_ - rhs.idx_;
+		}
+
+		[[nodiscard]] constexpr bool operator==(Iterator other) const
+		{
+			return idx_ == other.idx_ && data_ == other.data_;
+		}
+
+		[[nodiscard]] constexpr bool operator!=(Iterator other) const
+		{
+			return !(*this == other);
+		}
+
+		[[nodiscard]] constexpr bool operator<(Iterator other) const
+		{
+			return idx_ < other.idx_;
+		}
+
+		[[nodiscard]] constexpr bool operator<=(Iterator other) const
+		{
+			return idx_ <= other.idx_;
+		}
+
+		[[nodiscard]] constexpr bool operator>(Iterator other) const
+		{
+			return idx_ > other.idx_;
+		}
+
+		[[nodiscard]] constexpr bool operator>=(Iterator other) const
+		{
+			return idx_ >= other.idx_;
+		}
+
+	 private:
+		constexpr Iterator(data_ptr data, difference_type idx) : data_(data), idx_(idx) {}
+
+	 private:
+		data_ptr        data_ = nullptr;
+		difference_type idx_{};
+	};
+
+	using iterator               = Iterator<false>;
+	using const_iterator         = Iterator<true>;
+	using reverse_iterator       = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	SoAVector() = default;
+
+	explicit SoAVector(size_type count) { resize(count); }
+
+	SoAVector(SoAVector const& other) { *this = other; }
+
+	SoAVector(SoAVector&& other) noexcept
+	    : data_(std::move(other.data_))
+	    , columns_(std::exchange(other.columns_, {}))
+	    , size_(std::exchange(other.size_, 0))
+	    , cap_(std::exchange(other.cap_, 0))
+	{
+	}
+
+	SoAVector& operator=(SoAVector const& rhs)
+	{
+		if (this != &rhs) {
+			clear();
+			reserve(rhs.size_);
+			copyColumns(rhs, std::index_sequence_for<Ts...>{});
+			size_ = rhs.size_;
+		}
+		return *this;
+	}
+
+	SoAVector& operator=(SoAVector&& rhs) noexcept
+	{
+		data_    = std::move(rhs.data_);
+		columns_ = std::exchange(rhs.columns_, {});
+		size_    = std::exchange(rhs.size_, 0);
+		cap_     = std::exchange(rhs.cap_, 0);
+		return *this;
+	}
+
+	//
+	// Iterators
+	//
+
+	[[nodiscard]] iterator begin() noexcept { return iterator(this, 0); }
+
+	[[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+	[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+
+	[[nodiscard]] iterator end() noexcept
+	{
+		return iterator(this, static_cast<difference_type>(size_));
+	}
+
+	[[nodiscard]] const_iterator end() const noexcept
+	{
+		return const_iterator(this, static_cast<difference_type>(size_));
+	}
+
+	[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+	[[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+	[[nodiscard]] const_reverse_iterator rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+	[[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+	[[nodiscard]] const_reverse_iterator rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	[[nodiscard]] const_reverse_iterator crend() const noexcept { return rend(); }
+
+	//
+	// Element access
+	//
+
+	[[nodiscard]] reference operator[](size_type pos)
+	{
+		assert(size_ > pos);
+		return std::apply([pos](Ts*... cs) { return std::tie(cs[pos]...); }, columns_);
+	}
+
+	[[nodiscard]] const_reference operator[](size_type pos) const
+	{
+		assert(size_ > pos);
+		return std::apply(
+		    [pos](Ts const*... cs) { return std::tuple<Ts const&...>(cs[pos]...); },
+		    columns_);
+	}
+
+	/*!
+	 * @brief Returns the `I`th column.
+	 */
+	template <std::size_t I>
+	[[nodiscard]] Span<column_t<I>> column() noexcept
+	{
+		return Span<column_t<I>>(std::get<I>(columns_), size_);
+	}
+
+	template <std::size_t I>
+	[[nodiscard]] Span<column_t<I> const> column() const noexcept
+	{
+		return Span<column_t<I> const>(std::get<I>(columns_), size_);
+	}
+
+	/*!
+	 * @brief Returns a pointer to the first element of the `I`th column, aligned to
+	 * `CACHE_LINE_SIZE`.
+	 */
+	template <std::size_t I>
+	[[nodiscard]] column_t<I>* data() noexcept
+	{
+		return std::get<I>(columns_);
+	}
+
+	template <std::size_t I>
+	[[nodiscard]] column_t<I> const* data() const noexcept
+	{
+		return std::get<I>(columns_);
+	}
+
+	//
+	// Capacity
+	//
+
+	[[nodiscard]] bool empty() const noexcept { return 0 == size_; }
+
+	[[nodiscard]] size_type size() const noexcept { return size_; }
+
+	[[nodiscard]] size_type capacity() const noexcept { return cap_; }
+
+	void reserve(size_type new_cap)
+	{
+		if (cap_ < new_cap) {
+			reallocate(new_cap);
+		}
+	}
+
+	void shrink_to_fit()
+	{
+		if (cap_ != size_) {
+			reallocate(size_);
+		}
+	}
+
+	//
+	// Modifiers
+	//
+
+	void clear() noexcept { size_ = 0; }
+
+	void push_back(Ts const&... values)
+	{
+		if (cap_ == size_) {
+			// `values` may refer to elements of this vector, so copy them before the
+			// columns are reallocated
+			std::tuple<Ts...> const copy(values...);
+			reserve(std::max(size_type(16), 2 * cap_));
+			std::apply([this](Ts const&... vs) { store(size_, vs...); }, copy);
+		} else {
+			store(size_, values...);
+		}
+		++size_;
+	}
+
+	void pop_back()
+	{
+		assert(0 < size_);
+		--size_;
+	}
+
+	/*!
+	 * @brief Resizes to `count` elements, new elements are value-initialized.
+	 */
+	void resize(size_type count)
+	{
+		reserve(count);
+		if (size_ < count) {
+			std::apply(
+			    [this, count](Ts*... cs) { (std::fill(cs + size_, cs + count, Ts{}), ...); },
+			    columns_);
+		}
+		size_ = count;
+	}
+
+	/*!
+	 * @brief Reorders all columns such that element `i` becomes the former element
+	 * `perm[i]`.
+	 *
+	 * The columns are gathered in parallel (with TBB).
+	 */
+	void permute(Span<size_type const> perm)
+	{
+		assert(perm.size() == size_);
+
+		SoAVector tmp;
+		tmp.reserve(size_);
+		permuteColumns(tmp, perm, std::index_sequence_for<Ts...>{});
+		tmp.size_ = size_;
+		swap(tmp);
+	}
+
+	/*!
+	 * @brief Sorts all columns by the `I`th column.
+	 *
+	 * The sort permutation is computed once from the key column alone and then applied
+	 * to every column with `permute`, instead of swapping whole rows. With the default
+	 * comparison this uses `sortPermutation` (parallel radix sort for integral keys),
+	 * otherwise a parallel (with TBB) comparison sort.
+	 *
+	 * @param comp Comparison function object for the keys.
+	 */
+	template <std::size_t I, class Compare = std::less<>>
+	void sort(Compare comp = Compare{})
+	{
+		std::vector<size_type> perm;
+		if constexpr (std::is_same_v<Compare, std::less<>>) {
+			sortPermutation(column<I>(), perm);
+		} else {
+			perm.resize(size_);
+			std::iota(perm.begin(), perm.end(), size_type(0));
+			column_t<I> const* keys = data<I>();
+			auto const         cmp  = [keys, &comp](size_type a, size_type b) {
+				return comp(keys[a], keys[b]);
+			};
+#if defined(UFO_TBB)
+			tbb::parallel_sort(perm.begin(), perm.end(), cmp);
+#else
+			std::sort(perm.begin(), perm.end(), cmp);
+#endif
+		}
+		permute(Span<size_type const>(perm.data(), perm.size()));
+	}
+
+	void swap(SoAVector& other) noexcept
+	{
+		std::swap(data_, other.data_);
+		std::swap(columns_, other.columns_);
+		std::swap(size_, other.size_);
+		std::swap(cap_, other.cap_);
+	}
+
+ private:
+	void store(size_type pos, Ts const&... values) noexcept
+	{
+		std::apply([pos, &values...](Ts*... cs) { ((cs[pos] = values), ...); }, columns_);
+	}
+
+	struct AlignedDeleter {
+		void operator()(std::byte* p) const noexcept
+		{
+			::operator delete(p, std::align_val_t(CACHE_LINE_SIZE));
+		}
+	};
+
+	[[nodiscard]] static constexpr size_type alignUp(size_type n) noexcept
+	{
+		return (n + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+	}
+
+	[[nodiscard]] static constexpr std::array<size_type, NUM_COLUMNS + 1> offsets(
+	    size_type cap) noexcept
+	{
+		std::array<size_type, NUM_COLUMNS + 1> o{};
+		std::array<size_type, NUM_COLUMNS>     sizes{sizeof(Ts)...};
+		for (std::size_t i{}; NUM_COLUMNS != i; ++i) {
+			o[i + 1] = alignUp(o[i] + cap * sizes[i]);
+		}
+		return o;
+	}
+
+	void reallocate(size_type new_cap)
+	{
+		auto const o = offsets(new_cap);
+
+		std::unique_ptr<std::byte[], AlignedDeleter> data;
+		std::tuple<Ts*...>                           columns{};
+		if (0 != new_cap) {
+			data.reset(static_cast<std::byte*>(
+			    ::operator new(o[NUM_COLUMNS], std::align_val_t(CACHE_LINE_SIZE))));
+			columns = makeColumns(data.get(), o, std::index_sequence_for<Ts...>{});
+		}
+
+		size_type const n = std::min(size_, new_cap);
+		moveColumns(columns, n, std::index_sequence_for<Ts...>{});
+
+		data_    = std::move(data);
+		columns_ = columns;
+		cap_     = new_cap;
+		size_    = n;
+	}
+
+	template <std::size_t... Is>
+	[[nodiscard]] static std::tuple<Ts*...> makeColumns(
+	    std::byte* data, std::array<size_type, NUM_COLUMNS + 1> const& o,
+	    std::index_sequence<Is...>) noexcept
+	{
+		return {reinterpret_cast<Ts*>(data + o[Is])...};
+	}
+
+	template <std::size_t... Is>
+	void moveColumns(std::tuple<Ts*...> const& dst, size_type n,
+	                 std::index_sequence<Is...>) noexcept
+	{
+		if (0 != n) {
+			(std::memcpy(std::get<Is>(dst), std::get<Is>(columns_), n * sizeof(Ts)), ...);
+		}
+	}
+
+	template <std::size_t... Is>
+	void copyColumns(SoAVector const& other, std::index_sequence<Is...>) noexcept
+	{
+		if (0 != other.size_) {
+			(std::memcpy(std::get<Is>(columns_), std::get<Is>(other.columns_),
+			             other.size_ * sizeof(Ts)),
+			 ...);
+		}
+	}
+
+	template <std::size_t... Is>
+	void permuteColumns(SoAVector& dst, Span<size_type const> perm,
+	                    std::index_sequence<Is...>) const
+	{
+		auto const gather = [&perm](auto* d, auto const* s) {
+			parallel_for(IndexIterator<size_type>(0, perm.size(), 1, 4096),
+			             [d, s, &perm](size_type i) { d[i] = s[perm[i]]; });
+		};
+		(gather(std::get<Is>(dst.columns_), std::get<Is>(columns_)), ...);
+	}
+
+ private:
+	std::unique_ptr<std::byte[], AlignedDeleter> data_;
+	std::tuple<Ts*...>                           columns_{};
+	size_type                                    size_{};
+	size_type                                    cap_{};
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_SOA_VECTOR_HPP
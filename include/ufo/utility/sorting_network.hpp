@@ -0,0 +1,446 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_SORTING_NETWORK_HPP
+#define UFO_UTILITY_SORTING_NETWORK_HPP
+
+// STL
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace ufo
+{
+/*!
+ * @brief Projection returning its argument.
+ */
+struct Identity {
+	template <class T>
+	[[nodiscard]] constexpr T&& operator()(T&& t) const noexcept
+	{
+		return std::forward<T>(t);
+	}
+};
+
+/*!
+ * @brief Projection returning the `first` member, e.g., the distance of a
+ * `(distance, node)` pair.
+ */
+struct PairFirst {
+	template <class T>
+	[[nodiscard]] constexpr auto const& operator()(T const& t) const noexcept
+	{
+		return t.first;
+	}
+};
+
+/*!
+ * @brief Orders `a` and `b` such that `proj(a) <= proj(b)`.
+ *
+ * Small trivially copyable elements are exchanged with conditional moves instead of a
+ * branch, as the outcome of the comparisons in a sorting network is unpredictable.
+ */
+template <class T, class Proj = Identity>
+constexpr void compareExchange(T& a, T& b, Proj proj = {})
+{
+	if constexpr (std::is_trivially_copyable_v<T> && 2 * sizeof(void*) >= sizeof(T)) {
+		bool const s  = proj(b) < proj(a);
+		T const    lo = s ? b : a;
+		T const    hi = s ? a : b;
+		a             = lo;
+		b             = hi;
+	} else if (proj(b) < proj(a)) {
+		using std::swap;
+		swap(a, b);
+	}
+}
+
+//
+// Packed lanes
+//
+// Compare-exchanging two vectors sorts each lane independently, so running a network
+// over `N` vectors sorts `W` arrays of `N` keys at once (stored transposed, i.e., the
+// `i`th vector holds the `i`th key of every array).
+//
+
+#if defined(__SSE2__) || defined(_M_X64)
+inline void compareExchange(__m128& a, __m128& b, Identity = {}) noexcept
+{
+	__m128 const lo = _mm_min_ps(a, b);
+	b               = _mm_max_ps(a, b);
+	a               = lo;
+}
+
+inline void compareExchange(__m128d& a, __m128d& b, Identity = {}) noexcept
+{
+	__m128d const lo = _mm_min_pd(a, b);
+	b                = _mm_max_pd(a, b);
+	a                = lo;
+}
+#endif
+
+#if defined(__SSE4_1__)
+/*!
+ * @brief Compare-exchange of signed 32 bit integer lanes.
+ */
+inline void compareExchange(__m128i& a, __m128i& b, Identity = {}) noexcept
+{
+	__m128i const lo = _mm_min_epi32(a, b);
+	b                = _mm_max_epi32(a, b);
+	a                = lo;
+}
+#endif
+
+#if defined(__AVX__)
+inline void compareExchange(__m256& a, __m256& b, Identity = {}) noexcept
+{
+	__m256 const lo = _mm256_min_ps(a, b);
+	b               = _mm256_max_ps(a, b);
+	a               = lo;
+}
+
+inline void compareExchange(__m256d& a, __m256d& b, Identity = {}) noexcept
+{
+	__m256d const lo = _mm256_min_pd(a, b);
+	b                = _mm256_max_pd(a, b);
+	a                = lo;
+}
+#endif
+
+#if defined(__AVX2__)
+/*!
+ * @brief Compare-exchange of signed 32 bit integer lanes.
+ */
+inline void compareExchange(__m256i& a, __m256i& b, Identity = {}) noexcept
+{
+	__m256i const lo = _mm256_min_epi32(a, b);
+	b                = _mm256_max_epi32(a, b);
+	a                = lo;
+}
+#endif
+
+namespace detail
+{
+struct NetworkComparator {
+	std::size_t a;
+	std::size_t b;
+};
+
+/*!
+ * @brief Calls `f(a, b)` for every comparator of Batcher's odd-even merge sort network
+ * for `n` elements.
+ *
+ * Works for any `n`, as it is the network for the next power of two with all
+ * comparators involving elements past `n` removed.
+ */
+template <class F>
+constexpr void batcherNetwork(std::size_t n, F f)
+{
+	for (std::size_t p = 1; n > p; p += p) {
+		for (std::size_t k = p; 0 < k; k /= 2) {
+			for (std::size_t j = k % p; n > j + k; j += 2 * k) {
+				for (std::size_t i{}; k > i && n > i + j + k; ++i) {
+					if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+						f(i + j, i + j + k);
+					}
+				}
+			}
+		}
+	}
+}
+
+template <std::size_t N>
+[[nodiscard]] constexpr std::size_t batcherNetworkSize()
+{
+	std::size_t size{};
+	batcherNetwork(N, [&size](std::size_t, std::size_t) { ++size; });
+	return size;
+}
+
+template <std::size_t N>
+[[nodiscard]] constexpr auto batcherNetwork()
+{
+	std::array<NetworkComparator, batcherNetworkSize<N>()> net{};
+	std::size_t                                            i{};
+	batcherNetwork(N, [&net, &i](std::size_t a, std::size_t b) {
+		net[i++] = NetworkComparator{a, b};
+	});
+	return net;
+}
+
+/*!
+ * @brief The smallest known networks for small `N`, Batcher's odd-even merge sort
+ * otherwise.
+ */
+template <std::size_t N>
+[[nodiscard]] constexpr auto sortingNetwork()
+{
+	using C = NetworkComparator;
+	if constexpr (3 == N) {
+		return std::array<C, 3>{{{0, 2}, {0, 1}, {1, 2}}};
+	} else if constexpr (4 == N) {
+		return std::array<C, 5>{{{0, 2}, {1, 3}, {0, 1}, {2, 3}, {1, 2}}};
+	} else if constexpr (5 == N) {
+		return std::array<C, 9>{
+		    {{0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4}, {2, 3}}};
+	} else if constexpr (6 == N) {
+		return std::array<C, 12>{{{0, 5},
+		                          {1, 3},
+		                          {2, 4},
+		                          {1, 2},
+		                          {3, 4},
+		                          {0, 3},
+		                          {2, 5},
+		                          {0, 1},
+		                          {2, 3},
+		                          {4, 5},
+		                          {1, 2},
+		                          {3, 4}}};
+	} else if constexpr (7 == N) {
+		return std::array<C, 16>{{{0, 6},
+		                          {2, 3},
+		                          {4, 5},
+		                          {0, 2},
+		                          {1, 4},
+		                          {3, 6},
+		                          {0, 1},
+		                          {2, 5},
+		                          {3, 4},
+		                          {1, 2},
+		                          {4, 6},
+		                          {2, 3},
+		                          {4, 5},
+		                          {1, 2},
+		                          {3, 4},
+		                          {5, 6}}};
+	} else if constexpr (8 == N) {
+		return std::array<C, 19>{{{0, 2},
+		                          {1, 3},
+		                          {4, 6},
+		                          {5, 7},
+		                          {0, 4},
+		                          {1, 5},
+		                          {2, 6},
+		                          {3, 7},
+		                          {0, 1},
+		                          {2, 3},
+		                          {4, 5},
+		                          {6, 7},
+		                          {2, 4},
+		                          {3, 5},
+		                          {1, 4},
+		                          {3, 6},
+		                          {1, 2},
+		                          {3, 4},
+		                          {5, 6}}};
+	} else if constexpr (16 == N) {
+		// Green's network
+		return std::array<C, 60>{
+		    {{0, 13},  {1, 12},  {2, 15},  {3, 14},  {4, 8},   {5, 6},   {7, 11},  {9, 10},
+		     {0, 5},   {1, 7},   {2, 9},   {3, 4},   {6, 13},  {8, 14},  {10, 15}, {11, 12},
+		     {0, 1},   {2, 3},   {4, 5},   {6, 8},   {7, 9},   {10, 11}, {12, 13}, {14, 15},
+		     {0, 2},   {1, 3},   {4, 10},  {5, 11},  {6, 7},   {8, 9},   {12, 14}, {13, 15},
+		     {1, 2},   {3, 12},  {4, 6},   {5, 7},   {8, 10},  {9, 11},  {13, 14}, {1, 4},
+		     {2, 6},   {5, 8},   {7, 10},  {9, 13},  {11, 14}, {2, 4},   {3, 6},   {9, 12},
+		     {11, 13}, {3, 5},   {6, 8},   {7, 9},   {10, 12}, {3, 4},   {5, 6},   {7, 8},
+		     {9, 10},  {11, 12}, {6, 7},   {8, 9}}};
+	} else {
+		return batcherNetwork<N>();
+	}
+}
+}  // namespace detail
+
+/*!
+ * @brief The comparators of the sorting network used for `N` elements.
+ */
+template <std::size_t N>
+inline constexpr auto SORTING_NETWORK = detail::sortingNetwork<N>();
+
+namespace detail
+{
+template <std::size_t N, class RandomIt, class Proj, std::size_t... Is>
+constexpr void sortNetwork(RandomIt first, Proj& proj, std::index_sequence<Is...>)
+{
+	(void)first;
+	(void)proj;
+	(compareExchange(first[SORTING_NETWORK<N>[Is].a], first[SORTING_NETWORK<N>[Is].b],
+	                 proj),
+	 ...);
+}
+
+// `a < b`, with NaN ordered after every other value
+template <class T>
+[[nodiscard]] constexpr bool reduceLess(T const& a, T const& b)
+{
+	if constexpr (std::is_floating_point_v<T>) {
+		return a < b || (b != b && a == a);
+	} else {
+		return a < b;
+	}
+}
+
+template <std::size_t First, std::size_t Count, class RandomIt, class Proj>
+[[nodiscard]] constexpr std::size_t reduceArgMin(RandomIt first, Proj& proj)
+{
+	if constexpr (1 == Count) {
+		return First;
+	} else {
+		// Pairwise (tree) reduction, so the comparisons of each level are independent
+		std::size_t const l = reduceArgMin<First, Count / 2>(first, proj);
+		std::size_t const r = reduceArgMin<First + Count / 2, Count - Count / 2>(first, proj);
+		return reduceLess(proj(first[r]), proj(first[l])) ? r : l;
+	}
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+template <std::size_t N>
+[[nodiscard]] inline __m128 reduceMinPs(float const* first) noexcept
+{
+	static_assert(0 == N % 4 && 0 < N);
+	// `_mm_min_ps` returns its second operand if either is NaN, so keeping the
+	// accumulator second skips NaNs. Lanes that only saw NaNs stay infinite.
+	__m128 m = _mm_set1_ps(std::numeric_limits<float>::infinity());
+	for (std::size_t i{}; N != i; i += 4) {
+		m = _mm_min_ps(_mm_loadu_ps(first + i), m);
+	}
+	m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+template <std::size_t N, class RandomIt, class Proj>
+inline constexpr bool REDUCE_MIN_PS =
+    std::is_same_v<Identity, Proj> && std::is_pointer_v<RandomIt> &&
+    std::is_same_v<float, std::remove_cv_t<std::remove_pointer_t<RandomIt>>> &&
+    0 == N % 4 && 0 < N;
+#endif
+}  // namespace detail
+
+/*!
+ * @brief Sorts the `N` elements starting at `first` in ascending order of
+ * `proj(element)` with a fixed, fully unrolled sorting network.
+ *
+ * Faster than `std::sort` for small `N` (e.g., sorting the eight children of a node by
+ * distance) as there are no data dependent branches. The sort is not stable.
+ *
+ * Also sorts the lanes of SIMD vectors (`__m128`, `__m256`, ...) independently.
+ */
+template <std::size_t N, class RandomIt, class Proj = Identity>
+constexpr void sortNetwork(RandomIt first, Proj proj = {})
+{
+	detail::sortNetwork<N>(first, proj,
+	                       std::make_index_sequence<SORTING_NETWORK<N>.size()>{});
+}
+
+template <class T, std::size_t N, class Proj = Identity>
+constexpr void sortNetwork(std::array<T, N>& a, Proj proj = {})
+{
+	sortNetwork<N>(a.data(), proj);
+}
+
+template <class T, std::size_t N, class Proj = Identity>
+constexpr void sortNetwork(T (&a)[N], Proj proj = {})
+{
+	sortNetwork<N>(a, proj);
+}
+
+/*!
+ * @brief Returns the index of the first element with the smallest `proj(element)` of
+ * the `N` elements starting at `first`.
+ *
+ * Floating point NaNs are ordered after all other values, so they are only returned
+ * if there is nothing else. Plain `float` arrays with a multiple of four elements are
+ * reduced on packed lanes.
+ */
+template <std::size_t N, class RandomIt, class Proj = Identity>
+[[nodiscard]] constexpr std::size_t reduceArgMin(RandomIt first, Proj proj = {})
+{
+	static_assert(0 < N, "Cannot reduce zero elements");
+#if defined(__SSE2__) || defined(_M_X64)
+	if constexpr (detail::REDUCE_MIN_PS<N, RandomIt, Proj>) {
+		__m128 const m = detail::reduceMinPs<N>(first);
+		for (std::size_t i{}; N != i; i += 4) {
+			if (int const mask = _mm_movemask_ps(_mm_cmpeq_ps(m, _mm_loadu_ps(first + i)))) {
+				return i + ((mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3);
+			}
+		}
+		// Only NaNs
+		return 0;
+	} else
+#endif
+	{
+		return detail::reduceArgMin<0, N>(first, proj);
+	}
+}
+
+/*!
+ * @brief Returns the first element with the smallest `proj(element)` of the `N`
+ * elements starting at `first`.
+ *
+ * NaNs are handled as in `reduceArgMin`. Plain `float` arrays with a multiple of four
+ * elements are reduced on packed lanes.
+ */
+template <std::size_t N, class RandomIt, class Proj = Identity>
+[[nodiscard]] constexpr auto reduceMin(RandomIt first, Proj proj = {})
+{
+	static_assert(0 < N, "Cannot reduce zero elements");
+#if defined(__SSE2__) || defined(_M_X64)
+	if constexpr (detail::REDUCE_MIN_PS<N, RandomIt, Proj>) {
+		float const m = _mm_cvtss_f32(detail::reduceMinPs<N>(first));
+		// Either the minimum is infinite or there are only NaNs, rare enough to redo
+		return std::numeric_limits<float>::infinity() != m ? m
+		                                                   : first[reduceArgMin<N>(first)];
+	} else
+#endif
+	{
+		return typename std::iterator_traits<RandomIt>::value_type(
+		    first[detail::reduceArgMin<0, N>(first, proj)]);
+	}
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_SORTING_NETWORK_HPP
@@ -0,0 +1,155 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_SPAN_HPP
+#define UFO_UTILITY_SPAN_HPP
+
+// STL
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+namespace ufo
+{
+#if __cplusplus >= 202002L
+template <class T>
+using Span = std::span<T>;
+#else
+/*!
+ * @brief Non-owning view of a contiguous sequence of objects.
+ *
+ * @note Subset of C++20 `std::span` (with dynamic extent), which it is an alias of
+ * since C++20: https://en.cppreference.com/w/cpp/container/span
+ */
+template <class T>
+class Span
+{
+ public:
+	using element_type     = T;
+	using value_type       = std::remove_cv_t<T>;
+	using size_type        = std::size_t;
+	using difference_type  = std::ptrdiff_t;
+	using pointer          = T*;
+	using const_pointer    = T const*;
+	using reference        = T&;
+	using const_reference  = T const&;
+	using iterator         = T*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+
+	constexpr Span() noexcept = default;
+
+	constexpr Span(pointer first, size_type count) noexcept : data_(first), size_(count) {}
+
+	constexpr Span(pointer first, pointer last) noexcept
+	    : data_(first), size_(static_cast<size_type>(last - first))
+	{
+	}
+
+	template <class Container>
+	constexpr Span(Container& c) noexcept : data_(std::data(c)), size_(std::size(c))
+	{
+	}
+
+	[[nodiscard]] constexpr iterator begin() const noexcept { return data_; }
+
+	[[nodiscard]] constexpr iterator end() const noexcept { return data_ + size_; }
+
+	[[nodiscard]] constexpr reverse_iterator rbegin() const noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	[[nodiscard]] constexpr reverse_iterator rend() const noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	[[nodiscard]] constexpr reference front() const { return data_[0]; }
+
+	[[nodiscard]] constexpr reference back() const { return data_[size_ - 1]; }
+
+	[[nodiscard]] constexpr reference operator[](size_type idx) const
+	{
+		assert(size_ > idx);
+		return data_[idx];
+	}
+
+	[[nodiscard]] constexpr pointer data() const noexcept { return data_; }
+
+	[[nodiscard]] constexpr size_type size() const noexcept { return size_; }
+
+	[[nodiscard]] constexpr size_type size_bytes() const noexcept
+	{
+		return size_ * sizeof(T);
+	}
+
+	[[nodiscard]] constexpr bool empty() const noexcept { return 0 == size_; }
+
+	[[nodiscard]] constexpr Span first(size_type count) const
+	{
+		assert(size_ >= count);
+		return Span(data_, count);
+	}
+
+	[[nodiscard]] constexpr Span last(size_type count) const
+	{
+		assert(size_ >= count);
+		return Span(data_ + (size_ - count), count);
+	}
+
+	[[nodiscard]] constexpr Span subspan(size_type offset, size_type count) const
+	{
+		assert(size_ >= offset + count);
+		return Span(data_ + offset, count);
+	}
+
+ private:
+	pointer   data_ = nullptr;
+	size_type size_{};
+};
+#endif
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_SPAN_HPP
@@ -42,6 +42,9 @@
 #ifndef UFO_UTILITY_SPINLOCK_HPP
 #define UFO_UTILITY_SPINLOCK_HPP
 
+// UFO
+#include <ufo/utility/backoff.hpp>
+
 // STL
 #include <atomic>
 
@@ -58,9 +61,10 @@ class Spinlock
 			// avoiding any unnecessary spinning.
 			// Note that even though wait gurantees it returns only after the value has
 			// changed, the lock is acquired after the next condition check.
-			flag_.wait(true, std::memory_order_relaxed)
+			flag_.wait(true, std::memory_order_relaxed);
+#else
+			cpuRelax();
 #endif
-			    ;
 	}
 	bool try_lock() noexcept { return !flag_.test_and_set(std::memory_order_acquire); }
 
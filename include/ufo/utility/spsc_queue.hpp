@@ -0,0 +1,294 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_SPSC_QUEUE_HPP
+#define UFO_UTILITY_SPSC_QUEUE_HPP
+
+// UFO
+#include <ufo/utility/backoff.hpp>
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/cache_line.hpp>
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ufo
+{
+/*!
+ * @brief Bounded wait-free single-producer single-consumer ring buffer.
+ *
+ * The producer only writes the tail and the consumer only writes the head, each on its
+ * own cache line. Both sides also keep a cached copy of the other side's index, so the
+ * shared cache line is only read when the ring looks full (or empty) from the cached
+ * value. The bulk operations publish a whole batch with a single store.
+ *
+ * Exactly one thread may push and exactly one (possibly other) thread may pop.
+ *
+ * @tparam T The element type.
+ */
+template <class T>
+class SPSCQueue
+{
+	struct Slot {
+		alignas(T) unsigned char data[sizeof(T)];
+
+		[[nodiscard]] T* value() noexcept
+		{
+			return std::launder(reinterpret_cast<T*>(data));
+		}
+	};
+
+ public:
+	using value_type = T;
+	using size_type  = std::size_t;
+
+	/*!
+	 * @param capacity Maximum number of elements, rounded up to the closest power of two.
+	 */
+	explicit SPSCQueue(size_type capacity)
+	    : mask_(bitCeil(std::max(capacity, size_type(2))) - 1)
+	    , slots_(std::make_unique<Slot[]>(mask_ + 1))
+	{
+	}
+
+	SPSCQueue(SPSCQueue const&)            = delete;
+	SPSCQueue& operator=(SPSCQueue const&) = delete;
+
+	~SPSCQueue()
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			size_type const last = producer_.tail.load(std::memory_order_relaxed);
+			for (size_type pos = consumer_.head.load(std::memory_order_relaxed); last != pos;
+			     ++pos) {
+				slots_[pos & mask_].value()->~T();
+			}
+		}
+	}
+
+	//
+	// Producer
+	//
+
+	template <class... Args>
+	bool tryEmplace(Args&&... args)
+	{
+		size_type const tail = producer_.tail.load(std::memory_order_relaxed);
+		if (mask_ < tail - producer_.head_cache) {
+			producer_.head_cache = consumer_.head.load(std::memory_order_acquire);
+			if (mask_ < tail - producer_.head_cache) {
+				return false;  // Full
+			}
+		}
+
+		::new (slots_[tail & mask_].data) T(std::forward<Args>(args)...);
+		producer_.tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool tryPush(T const& value) { return tryEmplace(value); }
+
+	bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+	/*!
+	 * @brief Pushes `value`, spinning with backoff while the queue is full.
+	 */
+	template <class U>
+	void push(U&& value)
+	{
+		for (Backoff backoff; !tryEmplace(std::forward<U>(value)); backoff.snooze()) {
+		}
+	}
+
+	/*!
+	 * @brief Pushes up to `count` elements starting at `first`.
+	 *
+	 * @return The number of elements pushed, less than `count` only if the queue is full.
+	 *
+	 * @throws Whatever constructing `T` from `*first` throws, in which case none of the
+	 * elements are pushed.
+	 */
+	template <class InputIt>
+	size_type tryPushBulk(InputIt first, size_type count)
+	{
+		size_type const tail = producer_.tail.load(std::memory_order_relaxed);
+		size_type       free = capacity() - (tail - producer_.head_cache);
+		if (free < count) {
+			producer_.head_cache = consumer_.head.load(std::memory_order_acquire);
+			free                 = capacity() - (tail - producer_.head_cache);
+		}
+
+		size_type const n = std::min(free, count);
+		size_type       i{};
+		try {
+			for (; n != i; ++i, ++first) {
+				::new (slots_[(tail + i) & mask_].data) T(*first);
+			}
+		} catch (...) {
+			// Nothing has been published, so the elements constructed so far are dropped
+			while (0 != i--) {
+				slots_[(tail + i) & mask_].value()->~T();
+			}
+			throw;
+		}
+		producer_.tail.store(tail + n, std::memory_order_release);
+		return n;
+	}
+
+	//
+	// Consumer
+	//
+
+	/*!
+	 * @brief Returns a pointer to the first element, or `nullptr` if the queue is empty.
+	 *
+	 * Together with `popFront` this makes it possible to consume an element in place.
+	 */
+	[[nodiscard]] T* front() noexcept
+	{
+		size_type const head = consumer_.head.load(std::memory_order_relaxed);
+		if (head == consumer_.tail_cache) {
+			consumer_.tail_cache = producer_.tail.load(std::memory_order_acquire);
+			if (head == consumer_.tail_cache) {
+				return nullptr;  // Empty
+			}
+		}
+		return slots_[head & mask_].value();
+	}
+
+	/*!
+	 * @brief Removes the first element, the queue must not be empty (see `front`).
+	 */
+	void popFront() noexcept
+	{
+		size_type const head = consumer_.head.load(std::memory_order_relaxed);
+		slots_[head & mask_].value()->~T();
+		consumer_.head.store(head + 1, std::memory_order_release);
+	}
+
+	bool tryPop(T& value)
+	{
+		T* p = front();
+		if (nullptr == p) {
+			return false;
+		}
+		value = std::move(*p);
+		popFront();
+		return true;
+	}
+
+	/*!
+	 * @brief Pops an element into `value`, spinning with backoff while the queue is empty.
+	 */
+	void pop(T& value)
+	{
+		for (Backoff backoff; !tryPop(value); backoff.snooze()) {
+		}
+	}
+
+	/*!
+	 * @brief Pops up to `count` elements into `d_first`.
+	 *
+	 * @return The number of elements popped, less than `count` only if the queue is
+	 * empty.
+	 */
+	template <class OutputIt>
+	size_type tryPopBulk(OutputIt d_first, size_type count)
+	{
+		size_type const head      = consumer_.head.load(std::memory_order_relaxed);
+		size_type       available = consumer_.tail_cache - head;
+		if (available < count) {
+			consumer_.tail_cache = producer_.tail.load(std::memory_order_acquire);
+			available            = consumer_.tail_cache - head;
+		}
+
+		size_type const n = std::min(available, count);
+		for (size_type i{}; n != i; ++i, ++d_first) {
+			T* p     = slots_[(head + i) & mask_].value();
+			*d_first = std::move(*p);
+			p->~T();
+		}
+		consumer_.head.store(head + n, std::memory_order_release);
+		return n;
+	}
+
+	//
+	// Either side
+	//
+
+	[[nodiscard]] size_type capacity() const noexcept { return mask_ + 1; }
+
+	/*!
+	 * @brief Approximate number of elements, only exact when called by the producer or
+	 * the consumer while the other side is idle.
+	 */
+	[[nodiscard]] size_type size() const noexcept
+	{
+		auto const diff =
+		    static_cast<std::ptrdiff_t>(producer_.tail.load(std::memory_order_acquire) -
+		                                consumer_.head.load(std::memory_order_acquire));
+		return 0 > diff ? 0 : static_cast<size_type>(diff);
+	}
+
+	[[nodiscard]] bool empty() const noexcept { return 0 == size(); }
+
+ private:
+	size_type               mask_;
+	std::unique_ptr<Slot[]> slots_;
+
+	struct alignas(CACHE_LINE_SIZE) {
+		std::atomic<size_type> tail{};
+		size_type              head_cache{};
+	} producer_;
+
+	struct alignas(CACHE_LINE_SIZE) {
+		std::atomic<size_type> head{};
+		size_type              tail_cache{};
+	} consumer_;
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_SPSC_QUEUE_HPP
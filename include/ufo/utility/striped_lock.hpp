@@ -0,0 +1,246 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_STRIPED_LOCK_HPP
+#define UFO_UTILITY_STRIPED_LOCK_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/cache_line.hpp>
+#include <ufo/utility/spinlock.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ufo
+{
+/*!
+ * @brief Fixed size table of locks, where an object is protected by the lock its key
+ * hashes to.
+ *
+ * Gives fine-grained locking over an arbitrary number of objects at a fixed memory
+ * cost, instead of embedding a lock in every object. Two objects might share a stripe,
+ * which only costs some unnecessary contention. Each stripe is padded to a cache line
+ * so neighbouring stripes do not false-share.
+ *
+ * The key can be anything hashable with `std::hash`; pointers are hashed by address.
+ *
+ * To lock several objects at the same time use `lockAll`/`lockRange`, which acquire
+ * the stripes in increasing order (and each stripe only once), so they cannot deadlock
+ * with each other.
+ *
+ * @tparam Lock The lock type of each stripe, e.g., `Spinlock` or `AdaptiveLock<>`.
+ */
+template <class Lock = Spinlock>
+class StripedLock
+{
+ public:
+	using lock_type = Lock;
+	using size_type = std::size_t;
+
+	/*!
+	 * @brief RAII guard releasing a set of stripes acquired through `lockAll`/`lockRange`.
+	 */
+	template <class Indices>
+	class Guard
+	{
+		friend class StripedLock;
+
+	 public:
+		Guard(Guard const&)            = delete;
+		Guard& operator=(Guard const&) = delete;
+
+		Guard(Guard&& other) noexcept
+		    : table_(std::exchange(other.table_, nullptr))
+		    , indices_(std::move(other.indices_))
+		    , size_(other.size_)
+		{
+		}
+
+		~Guard()
+		{
+			if (nullptr == table_) {
+				return;
+			}
+			for (size_type i = size_; 0 != i; --i) {
+				table_->stripes_[indices_[i - 1]]->unlock();
+			}
+		}
+
+		/*!
+		 * @brief Number of distinct stripes held.
+		 */
+		[[nodiscard]] size_type size() const noexcept { return size_; }
+
+	 private:
+		Guard(StripedLock& table, Indices indices, size_type size)
+		    : table_(&table), indices_(std::move(indices)), size_(size)
+		{
+			std::sort(std::begin(indices_), std::begin(indices_) + size_);
+			size_ = static_cast<size_type>(
+			    std::unique(std::begin(indices_), std::begin(indices_) + size_) -
+			    std::begin(indices_));
+			for (size_type i{}; size_ != i; ++i) {
+				table_->stripes_[indices_[i]]->lock();
+			}
+		}
+
+	 private:
+		StripedLock* table_;
+		Indices      indices_;
+		size_type    size_;
+	};
+
+	/*!
+	 * @param num_stripes Number of locks, rounded up to the closest power of two.
+	 */
+	explicit StripedLock(size_type num_stripes = 1024)
+	    : shift_(64 - static_cast<unsigned>(
+	                      bitWidth(std::max(num_stripes, size_type(2)) - 1)))
+	    , stripes_(std::make_unique<CacheAligned<Lock>[]>(size_type(1) << (64 - shift_)))
+	{
+	}
+
+	StripedLock(StripedLock const&)            = delete;
+	StripedLock& operator=(StripedLock const&) = delete;
+
+	/*!
+	 * @brief Number of stripes (locks) in the table.
+	 */
+	[[nodiscard]] size_type size() const noexcept { return size_type(1) << (64 - shift_); }
+
+	/*!
+	 * @brief Returns the index of the stripe protecting `key`.
+	 */
+	template <class Key>
+	[[nodiscard]] size_type index(Key const& key) const noexcept
+	{
+		// Fibonacci hashing, taking the high bits makes it robust against keys (such as
+		// addresses and Morton codes) that only differ in some of the bits
+		return static_cast<size_type>((hash(key) * UINT64_C(0x9E3779B97F4A7C15)) >> shift_);
+	}
+
+	/*!
+	 * @brief Returns the lock protecting `key`.
+	 */
+	template <class Key>
+	[[nodiscard]] Lock& stripe(Key const& key) noexcept
+	{
+		return *stripes_[index(key)];
+	}
+
+	template <class Key>
+	void lock(Key const& key)
+	{
+		stripe(key).lock();
+	}
+
+	template <class Key>
+	bool try_lock(Key const& key)
+	{
+		return stripe(key).try_lock();
+	}
+
+	template <class Key>
+	void unlock(Key const& key)
+	{
+		stripe(key).unlock();
+	}
+
+	/*!
+	 * @brief Locks the stripes of all `keys`, in sorted order to avoid deadlocks.
+	 *
+	 * @return Guard releasing the stripes when destroyed.
+	 */
+	template <class... Keys>
+	[[nodiscard]] Guard<std::array<size_type, sizeof...(Keys)>> lockAll(
+	    Keys const&... keys)
+	{
+		return Guard<std::array<size_type, sizeof...(Keys)>>(*this, {index(keys)...},
+		                                                      sizeof...(Keys));
+	}
+
+	/*!
+	 * @brief Locks the stripes of all keys in `[first, last)`, in sorted order to avoid
+	 * deadlocks.
+	 *
+	 * @return Guard releasing the stripes when destroyed.
+	 */
+	template <class InputIt>
+	[[nodiscard]] Guard<std::vector<size_type>> lockRange(InputIt first, InputIt last)
+	{
+		std::vector<size_type> indices;
+		std::transform(first, last, std::back_inserter(indices),
+		               [this](auto const& key) { return index(key); });
+		size_type const size = indices.size();
+		return Guard<std::vector<size_type>>(*this, std::move(indices), size);
+	}
+
+ private:
+	template <class Key>
+	[[nodiscard]] static std::uint64_t hash(Key const& key) noexcept
+	{
+		if constexpr (std::is_pointer_v<Key>) {
+			return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key));
+		} else if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>) {
+			return static_cast<std::uint64_t>(key);
+		} else {
+			return static_cast<std::uint64_t>(std::hash<Key>{}(key));
+		}
+	}
+
+ private:
+	unsigned                              shift_;
+	std::unique_ptr<CacheAligned<Lock>[]> stripes_;
+};
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_STRIPED_LOCK_HPP
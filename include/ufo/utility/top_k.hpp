@@ -0,0 +1,242 @@
+/*!
+ * UFOMap: An Efficient Probabilistic 3D Mapping Framework That Embraces the Unknown
+ *
+ * @author Daniel Duberg (dduberg@kth.se)
+ * @see https://github.com/UnknownFreeOccupied/ufomap
+ * @version 1.0
+ * @date 2022-05-13
+ *
+ * @copyright Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ *
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Daniel Duberg, KTH Royal Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UFO_UTILITY_TOP_K_HPP
+#define UFO_UTILITY_TOP_K_HPP
+
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/index_iterator.hpp>
+#include <ufo/utility/parallel_for.hpp>
+#include <ufo/utility/sorting_network.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace ufo
+{
+namespace detail
+{
+/*!
+ * @brief Sorts the bitonic sequence `a` in ascending order.
+ */
+template <std::size_t N, class T, class Proj>
+constexpr void bitonicClean(std::array<T, N>& a, Proj& proj)
+{
+	for (std::size_t j = N / 2; 0 < j; j /= 2) {
+		for (std::size_t i{}; N != i; ++i) {
+			if (0 == (i & j)) {
+				compareExchange(a[i], a[i + j], proj);
+			}
+		}
+	}
+}
+}  // namespace detail
+
+/*!
+ * @brief Copies the `k` elements with the smallest `proj(element)` in `[first, last)`
+ * to `d_first`, in ascending order.
+ *
+ * Streams over the input while keeping a buffer of at most `2k` candidates, whenever
+ * the buffer is full it is partitioned down to the `k` best and the key of the `k`th
+ * best becomes the threshold that later elements have to beat. Expected linear time
+ * and `O(k)` memory, also for `k` close to the input size where a heap would be slow.
+ *
+ * Ties are broken arbitrarily.
+ *
+ * @return Iterator past the last element written, i.e., `d_first + min(k, n)`.
+ */
+template <class InputIt, class OutputIt, class Proj = Identity>
+OutputIt topK(InputIt first, InputIt last, std::size_t k, OutputIt d_first,
+              Proj proj = {})
+{
+	using T = typename std::iterator_traits<InputIt>::value_type;
+
+	if (0 == k) {
+		return d_first;
+	}
+
+	auto const cmp = [&proj](T const& a, T const& b) { return proj(a) < proj(b); };
+
+	std::vector<T> buf;
+	buf.reserve(2 * k);
+
+	for (; first != last && 2 * k != buf.size(); ++first) {
+		buf.push_back(*first);
+	}
+
+	while (first != last) {
+		std::nth_element(buf.begin(), buf.begin() + (k - 1), buf.end(), cmp);
+		buf.resize(k);
+		auto const threshold = proj(buf.back());
+		for (; first != last && 2 * k != buf.size(); ++first) {
+			if (proj(*first) < threshold) {
+				buf.push_back(*first);
+			}
+		}
+	}
+
+	if (k < buf.size()) {
+		std::nth_element(buf.begin(), buf.begin() + (k - 1), buf.end(), cmp);
+		buf.resize(k);
+	}
+	std::sort(buf.begin(), buf.end(), cmp);
+	return std::copy(buf.begin(), buf.end(), d_first);
+}
+
+/*!
+ * @brief Copies the `K` elements with the smallest `proj(element)` in `[first, last)`
+ * to `d_first`, in ascending order.
+ *
+ * For small compile-time `K`, e.g., the nearest neighbours of a query. The current
+ * best candidates are kept sorted in registers; the input is consumed in chunks of
+ * (`K` rounded up to a power of two) elements that beat the current worst candidate,
+ * each chunk is sorted with a sorting network and merged into the candidates with a
+ * branchless bitonic merge. Larger `K` falls back to the streaming version above.
+ *
+ * Ties are broken arbitrarily.
+ *
+ * @return Iterator past the last element written, i.e., `d_first + min(K, n)`.
+ */
+template <std::size_t K, class InputIt, class OutputIt, class Proj = Identity>
+OutputIt topK(InputIt first, InputIt last, OutputIt d_first, Proj proj = {})
+{
+	using T = typename std::iterator_traits<InputIt>::value_type;
+
+	constexpr std::size_t N = bitCeil(K);
+
+	if constexpr (0 == K) {
+		return d_first;
+	} else if constexpr (64 < K || !std::is_default_constructible_v<T>) {
+		return topK(first, last, K, d_first, proj);
+	} else {
+		std::array<T, N> best;
+		std::size_t      n{};
+		for (; N != n && first != last; ++first, ++n) {
+			best[n] = *first;
+		}
+
+		if (N != n) {
+			// Fewer than `N` elements, insertion sort them
+			for (std::size_t i = 1; n > i; ++i) {
+				T           e = best[i];
+				std::size_t j = i;
+				for (; 0 < j && proj(e) < proj(best[j - 1]); --j) {
+					best[j] = best[j - 1];
+				}
+				best[j] = e;
+			}
+			return std::copy_n(best.begin(), std::min(n, K), d_first);
+		}
+
+		sortNetwork<N>(best.data(), proj);
+
+		std::array<T, N> chunk;
+		while (first != last) {
+			std::size_t m{};
+			for (; N != m && first != last; ++first) {
+				if (proj(*first) < proj(best[N - 1])) {
+					chunk[m++] = *first;
+				}
+			}
+
+			if (N != m) {
+				// Not enough candidates for a full chunk, insert them one by one
+				for (std::size_t i{}; m != i; ++i) {
+					if (!(proj(chunk[i]) < proj(best[N - 1]))) {
+						continue;
+					}
+					std::size_t j = N - 1;
+					for (; 0 < j && proj(chunk[i]) < proj(best[j - 1]); --j) {
+						best[j] = best[j - 1];
+					}
+					best[j] = chunk[i];
+				}
+				break;
+			}
+
+			// The pairwise minimum of an ascending and a descending sequence is a bitonic
+			// sequence holding the `N` smallest of both
+			sortNetwork<N>(chunk.data(), proj);
+			for (std::size_t i{}; N != i; ++i) {
+				compareExchange(best[i], chunk[N - 1 - i], proj);
+			}
+			detail::bitonicClean(best, proj);
+		}
+
+		return std::copy_n(best.begin(), K, d_first);
+	}
+}
+
+/*!
+ * @brief Batched `topK` for many queries, e.g., brute force nearest neighbours.
+ *
+ * Row `r` of the `rows` x `cols` row-major matrix `data` holds the candidates of query
+ * `r`, its `min(k, cols)` best are written, in ascending order, to row `r` of the
+ * `rows` x `k` row-major matrix `out`. The rows are processed in parallel.
+ */
+template <class T, class U, class Proj = Identity>
+void topKRows(T const* data, std::size_t rows, std::size_t cols, std::size_t k, U* out,
+              Proj proj = {})
+{
+	parallel_for(IndexIterator<std::size_t>(0, rows), [=](std::size_t r) {
+		topK(data + r * cols, data + (r + 1) * cols, k, out + r * k, proj);
+	});
+}
+
+/*!
+ * @brief Same as above, with compile-time `K`.
+ */
+template <std::size_t K, class T, class U, class Proj = Identity>
+void topKRows(T const* data, std::size_t rows, std::size_t cols, U* out, Proj proj = {})
+{
+	parallel_for(IndexIterator<std::size_t>(0, rows), [=](std::size_t r) {
+		topK<K>(data + r * cols, data + (r + 1) * cols, out + r * K, proj);
+	});
+}
+}  // namespace ufo
+
+#endif  // UFO_UTILITY_TOP_K_HPP
@@ -43,8 +43,10 @@
 #define UFO_UTILITY_TUPLE_ITERATOR_HPP
 
 // STL
+#include <cassert>
 #include <iterator>
 #include <tuple>
+#include <utility>
 
 namespace ufo
 {
@@ -230,12 +232,31 @@ class TupleIterator
 
 	[[nodiscard]] auto operator[](std::size_t pos)
 	{
-		return std::apply([i = pos](Ts&... ts) { return std::tie(ts[i]...); }, *ts_);
+		return std::apply([i = pos](Ts&... ts) { return std::tie(ts[i]...); }, ts_);
 	}
 
 	[[nodiscard]] auto operator[](std::size_t pos) const
 	{
-		return std::apply([i = pos](Ts const&... ts) { return std::tie(ts[i]...); }, *ts_);
+		return std::apply([i = pos](Ts const&... ts) { return std::tie(ts[i]...); }, ts_);
+	}
+
+	[[nodiscard]] size_type size() const { return std::get<0>(ts_).size(); }
+
+	[[nodiscard]] bool empty() const { return 0 == size(); }
+
+	/*!
+	 * @brief Returns the `I`th of the zipped containers.
+	 */
+	template <std::size_t I>
+	[[nodiscard]] auto& column() noexcept
+	{
+		return std::get<I>(ts_);
+	}
+
+	template <std::size_t I>
+	[[nodiscard]] auto const& column() const noexcept
+	{
+		return std::as_const(std::get<I>(ts_));
 	}
 
  private:
@@ -42,5 +42,6 @@ void Buffer::resize(size_type new_size)
 {
 	WriteBuffer::resize(new_size);
 	ReadBuffer::data_ = WriteBuffer::data();
+	ReadBuffer::size_ = WriteBuffer::size_;
 }
 }  // namespace ufo
\ No newline at end of file
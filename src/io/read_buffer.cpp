@@ -71,6 +71,6 @@ void ReadBuffer::readSkip(size_type count) noexcept { pos_ += count; }
 
 ReadBuffer::size_type ReadBuffer::readLeft() const noexcept
 {
-	return size_ < pos_ ? 0 : pos_ - size_;
+	return size_ < pos_ ? 0 : size_ - pos_;
 }
 }  // namespace ufo
\ No newline at end of file
@@ -94,6 +94,6 @@ void WriteBuffer::setWritePos(size_type pos) noexcept { pos_ = pos; }
 
 WriteBuffer::size_type WriteBuffer::writeLeft() const noexcept
 {
-	return size_ < pos_ ? 0 : pos_ - size_;
+	return size_ < pos_ ? 0 : size_ - pos_;
 }
 }  // namespace ufo
\ No newline at end of file
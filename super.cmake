@@ -1,6 +1,7 @@
-option(UFOUTILITY_BUILD_DOCS     "Generate documentation" OFF)
-option(UFOUTILITY_BUILD_TESTS    "Unit testing"           OFF)
-option(UFOUTILITY_BUILD_COVERAGE "Test Coverage"          OFF)
+option(UFOUTILITY_BUILD_DOCS       "Generate documentation" OFF)
+option(UFOUTILITY_BUILD_TESTS      "Unit testing"           OFF)
+option(UFOUTILITY_BUILD_COVERAGE   "Test Coverage"          OFF)
+option(UFOUTILITY_BUILD_BENCHMARKS "Benchmarks"             OFF)
 
 add_library(Utility SHARED 
 	src/io/read_buffer.cpp
@@ -65,4 +66,13 @@ install(
 install(DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/include
 	COMPONENT Utility
 	DESTINATION ${CMAKE_INSTALL_PREFIX}
-)
\ No newline at end of file
+)
+
+if(UFOUTILITY_BUILD_TESTS)
+	enable_testing()
+	add_subdirectory(tests)
+endif()
+
+if(UFOUTILITY_BUILD_BENCHMARKS)
+	add_subdirectory(benchmarks)
+endif()
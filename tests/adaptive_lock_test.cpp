@@ -0,0 +1,115 @@
+// UFO
+#include <ufo/utility/adaptive_lock.hpp>
+#include <ufo/utility/backoff.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+template <class Lock>
+std::uint64_t contendedCount(Lock& lock, int threads, int iterations)
+{
+	std::uint64_t            count{};
+	std::vector<std::thread> workers;
+	for (int t{}; threads != t; ++t) {
+		workers.emplace_back([&] {
+			for (int i{}; iterations != i; ++i) {
+				std::lock_guard guard(lock);
+				++count;
+			}
+		});
+	}
+	for (auto& w : workers) {
+		w.join();
+	}
+	return count;
+}
+}  // namespace
+
+TEST_CASE("AdaptiveLock")
+{
+	using namespace ufo;
+
+	SECTION("Try lock")
+	{
+		AdaptiveLock<> lock;
+		REQUIRE(lock.try_lock());
+		REQUIRE(!lock.try_lock());
+		lock.unlock();
+		REQUIRE(lock.try_lock());
+		lock.unlock();
+	}
+
+	SECTION("Mutual exclusion")
+	{
+		AdaptiveLock<> lock;
+		REQUIRE(4 * 20000 == contendedCount(lock, 4, 20000));
+	}
+
+	SECTION("Parked waiter is woken up")
+	{
+		AdaptiveLock<> lock;
+		lock.lock();
+		bool        done{};
+		std::thread waiter([&] {
+			std::lock_guard guard(lock);
+			done = true;
+		});
+		// Long enough for the waiter to give up spinning and park
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		lock.unlock();
+		waiter.join();
+		REQUIRE(done);
+	}
+
+	SECTION("Stats")
+	{
+		AdaptiveLock<true> lock;
+		REQUIRE(0 == lock.stats().acquisitions);
+
+		lock.lock();
+		lock.unlock();
+		REQUIRE(lock.try_lock());
+		REQUIRE(!lock.try_lock());
+		lock.unlock();
+		LockStats s = lock.stats();
+		REQUIRE(2 == s.acquisitions);
+		REQUIRE(0 == s.contended);
+		REQUIRE(0 == s.wait_time.count());
+
+		REQUIRE(4 * 5000 == contendedCount(lock, 4, 5000));
+		s = lock.stats();
+		REQUIRE(2 + 4 * 5000 == s.acquisitions);
+		REQUIRE(s.acquisitions >= s.contended);
+
+		lock.resetStats();
+		REQUIRE(0 == lock.stats().acquisitions);
+		REQUIRE(0 == lock.stats().contended);
+	}
+
+	SECTION("Backoff")
+	{
+		Backoff  backoff;
+		unsigned steps{};
+		for (; !backoff.completed(); backoff.snooze()) {
+			++steps;
+		}
+		REQUIRE(Backoff::YIELD_LIMIT + 1 == steps);
+
+		backoff.reset();
+		REQUIRE(!backoff.completed());
+		for (unsigned i{}; 2 * Backoff::YIELD_LIMIT != i; ++i) {
+			backoff.spin();
+		}
+		// Spinning alone never tells the caller to block
+		REQUIRE(!backoff.completed());
+	}
+}
@@ -0,0 +1,131 @@
+// UFO
+#include <ufo/utility/batch.hpp>
+#include <ufo/utility/index_iterator.hpp>
+#include <ufo/utility/span.hpp>
+#include <ufo/utility/tuple_iterator.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE("Batch")
+{
+	using namespace ufo;
+
+	SECTION("Span")
+	{
+		std::vector<int> v{1, 2, 3, 4, 5};
+		Span<int>        s(v);
+		REQUIRE(5 == s.size());
+		REQUIRE(v.data() == s.data());
+		REQUIRE(5 == s.back());
+
+		s[0] = 10;
+		REQUIRE(10 == v[0]);
+
+		REQUIRE(2 == s.subspan(1, 3).front());
+		REQUIRE(3 == s.first(3).back());
+		REQUIRE(4 == s.last(2).front());
+		REQUIRE(5 * sizeof(int) == s.size_bytes());
+		REQUIRE(Span<int>().empty());
+
+		int sum{};
+		for (int x : Span<int const>(v.data(), v.data() + 2)) {
+			sum += x;
+		}
+		REQUIRE(12 == sum);
+	}
+
+	SECTION("Index batches")
+	{
+		std::vector<std::size_t> batched;
+		std::vector<std::size_t> tail;
+		forEachBatch<4>(
+		    IndexIterator<std::size_t>(3, 30, 2),
+		    [&](auto const& b) {
+			    STATIC_REQUIRE(4 == std::decay_t<decltype(b)>::size());
+			    for (auto i : b.lanes()) {
+				    batched.push_back(i);
+			    }
+		    },
+		    [&](std::size_t i) { tail.push_back(i); });
+
+		// 14 indices: three full batches and two left over
+		REQUIRE(12 == batched.size());
+		REQUIRE((std::vector<std::size_t>{27, 29} == tail));
+		for (std::size_t i{}; batched.size() != i; ++i) {
+			REQUIRE(3 + 2 * i == batched[i]);
+		}
+
+		IndexBatch<int, 3> const b{10, -2};
+		REQUIRE(6 == b[2]);
+		REQUIRE((std::array<int, 3>{10, 8, 6} == b.lanes()));
+
+		int calls{};
+		forEachBatch<8>(
+		    IndexIterator<int>(0, 8), [&](auto const&) { ++calls; },
+		    [&](int) { REQUIRE(false); });
+		REQUIRE(1 == calls);
+	}
+
+	SECTION("Zipped batches")
+	{
+		std::vector<float>  x(19);
+		std::vector<float>  y(19);
+		std::vector<double> out(19);
+		for (std::size_t i{}; x.size() != i; ++i) {
+			x[i] = static_cast<float>(i);
+			y[i] = 2.0f * static_cast<float>(i);
+		}
+
+		TupleIterator<std::vector<float>, std::vector<float>, std::vector<double>> zip(
+		    x, y, out);
+		REQUIRE(19 == zip.size());
+
+		std::size_t full{};
+		std::size_t rest{};
+		forEachBatch<8>(
+		    zip,
+		    [&full](Span<float> a, Span<float> b, Span<double> c) {
+			    REQUIRE(8 == a.size());
+			    for (std::size_t i{}; a.size() != i; ++i) {
+				    c[i] = a[i] + b[i];
+			    }
+			    ++full;
+		    },
+		    [&rest](Span<float> a, Span<float>, Span<double> c) {
+			    rest = a.size();
+			    for (auto& v : c) {
+				    v = -1.0;
+			    }
+		    });
+
+		REQUIRE(2 == full);
+		REQUIRE(3 == rest);
+		for (std::size_t i{}; 16 != i; ++i) {
+			REQUIRE(3.0 * static_cast<double>(i) == out[i]);
+		}
+		REQUIRE(-1.0 == out[18]);
+
+		// A single function handles the remainder as well
+		std::size_t seen{};
+		forEachBatch<5>(zip, [&seen](auto a, auto, auto) { seen += a.size(); });
+		REQUIRE(19 == seen);
+
+		// Const containers give spans of const elements
+		std::vector<int> const     c(6, 1);
+		TupleIterator<decltype(c)> czip(c);
+		forEachBatch<4>(czip, [](auto s) {
+			STATIC_REQUIRE(std::is_same_v<Span<int const>, decltype(s)>);
+		});
+
+		std::vector<int>               empty;
+		TupleIterator<decltype(empty)> ezip(empty);
+		forEachBatch<4>(ezip, [](auto) { REQUIRE(false); });
+	}
+}
@@ -0,0 +1,87 @@
+// UFO
+#include <ufo/utility/io/bit_reader.hpp>
+#include <ufo/utility/io/bit_writer.hpp>
+#include <ufo/utility/io/buffer.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST_CASE("BitWriter/BitReader")
+{
+	using namespace ufo;
+
+	SECTION("Layout")
+	{
+		Buffer    buffer;
+		BitWriter writer(buffer);
+		writer.writeBits(0x5, 3);
+		writer.writeBits(0x1F, 5);
+		writer.writeBits(0x1, 2);
+		writer.flush();
+
+		REQUIRE(2 == buffer.size());
+		REQUIRE(std::byte(0xFD) == buffer.ReadBuffer::data()[0]);
+		REQUIRE(std::byte(0x01) == buffer.ReadBuffer::data()[1]);
+		REQUIRE(2 == buffer.readLeft());
+	}
+
+	SECTION("Round trip")
+	{
+		std::mt19937_64            gen(42);
+		std::vector<std::uint64_t> values;
+		std::vector<unsigned>      widths;
+		for (int i{}; 10000 != i; ++i) {
+			unsigned const n = static_cast<unsigned>(gen() % 65);
+			widths.push_back(n);
+			values.push_back(64 == n ? gen() : gen() & ((std::uint64_t(1) << n) - 1));
+		}
+
+		Buffer    buffer;
+		BitWriter writer(buffer);
+		for (std::size_t i{}; values.size() != i; ++i) {
+			writer.writeBits(values[i], widths[i]);
+			writer.writeUnary(i % 100);
+			writer.writeEliasGamma(values[i] | 1);
+		}
+		writer.flush();
+		buffer.write(std::uint32_t(0xDEADBEEF));
+
+		BitReader reader(buffer);
+		for (std::size_t i{}; values.size() != i; ++i) {
+			if (16 >= widths[i]) {
+				REQUIRE(values[i] == reader.peekBits(widths[i]));
+			}
+			REQUIRE(values[i] == reader.readBits(widths[i]));
+			REQUIRE(i % 100 == reader.readUnary());
+			REQUIRE((values[i] | 1) == reader.readEliasGamma());
+		}
+		REQUIRE(8 * (buffer.size() - 4) >= reader.bitsRead());
+		REQUIRE(!reader.overrun());
+
+		// Continue byte-wise after the bit stream
+		reader.sync();
+		std::uint32_t tail;
+		buffer.read(tail);
+		REQUIRE(0xDEADBEEF == tail);
+		REQUIRE(0 == buffer.readLeft());
+	}
+
+	SECTION("Overrun")
+	{
+		Buffer    buffer;
+		BitWriter writer(buffer);
+		writer.writeBits(0x3, 2);
+		writer.flush();
+
+		BitReader reader(buffer);
+		REQUIRE(0x3 == reader.readBits(8));
+		REQUIRE(!reader.overrun());
+		REQUIRE(0 == reader.readBits(1));
+		REQUIRE(reader.overrun());
+	}
+}
@@ -0,0 +1,180 @@
+// UFO
+#include <ufo/utility/bit_packed_array.hpp>
+#include <ufo/utility/io/buffer.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+template <unsigned Bits>
+void checkWidth(std::mt19937& gen)
+{
+	std::uint32_t const mask =
+	    32 == Bits ? ~std::uint32_t(0) : (std::uint32_t(1) << Bits) - 1;
+
+	std::vector<std::uint32_t> values(1000);
+	for (auto& v : values) {
+		v = gen() & mask;
+	}
+
+	ufo::BitPackedArray<Bits> a(values.size());
+	for (std::size_t i{}; values.size() != i; ++i) {
+		a.set(i, values[i]);
+	}
+	for (std::size_t i{}; values.size() != i; ++i) {
+		REQUIRE(values[i] == a.get(i));
+	}
+
+	// Unaligned ranges exercise both the scalar and the vectorized paths
+	ufo::BitPackedArray<Bits> b(values.size());
+	b.pack(0, ufo::Span<std::uint32_t const>(values.data(), 3));
+	b.pack(3, ufo::Span<std::uint32_t const>(values.data() + 3, values.size() - 3));
+	REQUIRE(a == b);
+
+	std::vector<std::uint32_t> out(values.size() - 7);
+	b.unpack(7, ufo::Span<std::uint32_t>(out.data(), out.size()));
+	for (std::size_t i{}; out.size() != i; ++i) {
+		REQUIRE(values[i + 7] == out[i]);
+	}
+
+	ufo::BitPackedArray<> r(Bits, values.size());
+	r.pack(0, ufo::Span<std::uint32_t const>(values.data(), values.size()));
+	REQUIRE(Bits == r.bits());
+	for (std::size_t i{}; values.size() != i; ++i) {
+		REQUIRE(values[i] == r[i]);
+	}
+}
+
+template <unsigned... Bits>
+void checkWidths(std::mt19937& gen, std::integer_sequence<unsigned, Bits...>)
+{
+	(checkWidth<Bits + 1>(gen), ...);
+}
+}  // namespace
+
+TEST_CASE("BitPackedArray")
+{
+	using namespace ufo;
+
+	std::mt19937 gen(42);
+
+	SECTION("Widths")
+	{
+		checkWidths(gen, std::make_integer_sequence<unsigned, 32>{});
+	}
+
+	SECTION("Only the low bits are stored")
+	{
+		BitPackedArray<5> a(3);
+		a[1] = 0xFFu;
+		REQUIRE(0 == a[0]);
+		REQUIRE(0x1F == a[1]);
+		REQUIRE(0 == a[2]);
+	}
+
+	SECTION("Resize")
+	{
+		BitPackedArray<7> a(10, 99);
+		REQUIRE(10 == a.size());
+		a.resize(3);
+		a.resize(6, 5);
+		REQUIRE(99 == a[2]);
+		REQUIRE(5 == a[3]);
+		REQUIRE(5 == a[5]);
+
+		a.push_back(42);
+		REQUIRE(7 == a.size());
+		REQUIRE(42 == a.at(6));
+		REQUIRE_THROWS_AS(a.at(7), std::out_of_range);
+
+		a.clear();
+		REQUIRE(a.empty());
+		REQUIRE(0 == a.numWords());
+	}
+
+	SECTION("Runtime width")
+	{
+		REQUIRE_THROWS_AS(BitPackedArray<>(0), std::invalid_argument);
+		REQUIRE_THROWS_AS(BitPackedArray<>(33), std::invalid_argument);
+
+		BitPackedArray<> a;
+		REQUIRE(32 == a.bits());
+		REQUIRE(a.empty());
+	}
+
+	SECTION("Write/read")
+	{
+		BitPackedArray<11> a(1234);
+		for (std::size_t i{}; a.size() != i; ++i) {
+			a[i] = static_cast<std::uint32_t>(gen());
+		}
+
+		Buffer buffer;
+		a.write(buffer);
+
+		BitPackedArray<11> b;
+		b.read(buffer);
+		REQUIRE(a == b);
+		REQUIRE(0 == buffer.readLeft());
+
+		buffer.readPos(0);
+		BitPackedArray<> c;
+		c.read(buffer);
+		REQUIRE(11 == c.bits());
+		REQUIRE(a.numWords() == c.numWords());
+		for (std::size_t i{}; a.size() != i; ++i) {
+			REQUIRE(a[i] == c[i]);
+		}
+
+		buffer.readPos(0);
+		BitPackedArray<12> d;
+		REQUIRE_THROWS_AS(d.read(buffer), std::invalid_argument);
+	}
+
+	SECTION("Corrupt input leaves the array unchanged")
+	{
+		BitPackedArray<> a(9, 100, 3);
+		auto const       before = a;
+
+		// A size whose bit count wraps around to zero words
+		Buffer overflow;
+		overflow.write(std::uint32_t(32));
+		overflow.write(std::uint64_t(1) << 59);
+		REQUIRE_THROWS_AS(a.read(overflow), std::out_of_range);
+		REQUIRE(before == a);
+
+		Buffer truncated;
+		truncated.write(std::uint32_t(3));
+		truncated.write(std::uint64_t(100));
+		truncated.write(std::uint64_t(0));
+		REQUIRE_THROWS_AS(a.read(truncated), std::out_of_range);
+		REQUIRE(before == a);
+
+		Buffer width;
+		width.write(std::uint32_t(40));
+		width.write(std::uint64_t(0));
+		REQUIRE_THROWS_AS(a.read(width), std::invalid_argument);
+		REQUIRE(before == a);
+	}
+
+	SECTION("Unused stored bits are cleared")
+	{
+		Buffer buffer;
+		buffer.write(std::uint32_t(4));
+		buffer.write(std::uint64_t(3));
+		buffer.write(~std::uint64_t(0));
+
+		BitPackedArray<4> a;
+		a.read(buffer);
+		REQUIRE(0xFFF == a.data()[0]);
+		REQUIRE(a == BitPackedArray<4>(3, 0xF));
+	}
+}
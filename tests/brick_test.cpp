@@ -0,0 +1,297 @@
+// UFO
+#include <ufo/utility/bit_set.hpp>
+#include <ufo/utility/brick.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <bitset>
+#include <cstddef>
+#include <initializer_list>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+template <std::size_t N, class Gen>
+void checkBitSet(Gen& gen)
+{
+	std::bernoulli_distribution coin(0.5);
+
+	auto random = [&] {
+		std::bitset<N> s;
+		for (std::size_t i{}; N != i; ++i) {
+			s[i] = coin(gen);
+		}
+		return s;
+	};
+	auto convert = [](std::bitset<N> const& s) {
+		ufo::BitSet<N> b;
+		for (std::size_t i{}; N != i; ++i) {
+			b.set(i, s[i]);
+		}
+		return b;
+	};
+	auto equal = [](ufo::BitSet<N> const& b, std::bitset<N> const& s) {
+		for (std::size_t i{}; N != i; ++i) {
+			if (b[i] != s[i]) {
+				return false;
+			}
+		}
+		return s.count() == b.count();
+	};
+
+	STATIC_REQUIRE(N == ufo::BitSet<N>::size());
+
+	for (int round{}; 20 != round; ++round) {
+		auto const sa = random();
+		auto const sb = random();
+		auto const a  = convert(sa);
+		auto const b  = convert(sb);
+
+		REQUIRE(equal(a, sa));
+		REQUIRE(equal(a & b, sa & sb));
+		REQUIRE(equal(a | b, sa | sb));
+		REQUIRE(equal(a ^ b, sa ^ sb));
+		REQUIRE(equal(~a, ~sa));
+		REQUIRE(equal(ufo::BitSet<N>(a).andNot(b), sa & ~sb));
+		REQUIRE((a == b) == (sa == sb));
+		REQUIRE(a == convert(sa));
+		REQUIRE(a != ~a);
+
+		for (std::size_t s : {std::size_t(0), std::size_t(1), std::size_t(63),
+		                      std::size_t(64), std::size_t(65), N - 1, N, N + 10}) {
+			REQUIRE(equal(a << s, sa << s));
+			REQUIRE(equal(a >> s, sa >> s));
+		}
+
+		std::ostringstream os;
+		os << a;
+		REQUIRE(sa.to_string() == os.str());
+	}
+
+	ufo::BitSet<N> b;
+	REQUIRE(b.none());
+	REQUIRE(!b.any());
+	REQUIRE(!b.some());
+
+	b.set(N - 1);
+	REQUIRE(b.any());
+	REQUIRE(b.some());
+	REQUIRE(b.test(N - 1));
+	REQUIRE_THROWS_AS((void)b.test(N), std::out_of_range);
+
+	// The bits above `N` in the last word stay clear
+	b.set();
+	REQUIRE(b.all());
+	REQUIRE(N == b.count());
+	REQUIRE(b == ~ufo::BitSet<N>());
+	b.flip(3);
+	REQUIRE(!b.all());
+	b[3] = true;
+	REQUIRE(b.all());
+	REQUIRE((b << 1).count() == N - 1);
+	b.flip();
+	REQUIRE(b.none());
+
+	REQUIRE(ufo::BitSet<N>(0xF0u) == (ufo::BitSet<N>(0x0Fu) << 4));
+}
+
+using Voxels = std::bitset<512>;
+
+bool voxel(Voxels const& v, int x, int y, int z)
+{
+	return 0 <= x && 8 > x && 0 <= y && 8 > y && 0 <= z && 8 > z &&
+	       v[static_cast<std::size_t>(x + 8 * y + 64 * z)];
+}
+
+bool neighbor(int dx, int dy, int dz, ufo::BrickConnectivity c)
+{
+	int const n = (0 != dx) + (0 != dy) + (0 != dz);
+	switch (c) {
+		case ufo::BrickConnectivity::FACE: return 1 == n;
+		case ufo::BrickConnectivity::EDGE: return 1 <= n && 2 >= n;
+		case ufo::BrickConnectivity::VERTEX: return 1 <= n;
+	}
+	return false;
+}
+
+// Reference morphology, one voxel at a time
+Voxels morphology(Voxels const& v, ufo::BrickConnectivity c, bool any, bool self)
+{
+	Voxels r;
+	for (int z{}; 8 != z; ++z) {
+		for (int y{}; 8 != y; ++y) {
+			for (int x{}; 8 != x; ++x) {
+				bool res = !any;
+				for (int dz = -1; 2 != dz; ++dz) {
+					for (int dy = -1; 2 != dy; ++dy) {
+						for (int dx = -1; 2 != dx; ++dx) {
+							if (neighbor(dx, dy, dz, c)) {
+								bool const n = voxel(v, x + dx, y + dy, z + dz);
+								res          = any ? res || n : res && n;
+							}
+						}
+					}
+				}
+				if (self) {
+					res = any ? res || voxel(v, x, y, z) : res && voxel(v, x, y, z);
+				}
+				r[ufo::brickIndex(x, y, z)] = res;
+			}
+		}
+	}
+	return r;
+}
+
+// Reference shift along `axis`, taking the voxels from outside the brick from `next`
+Voxels shift(Voxels const& v, Voxels const& next, int axis, int n)
+{
+	Voxels r;
+	for (int z{}; 8 != z; ++z) {
+		for (int y{}; 8 != y; ++y) {
+			for (int x{}; 8 != x; ++x) {
+				int p[3] = {x, y, z};
+				p[axis] -= n;
+				bool const inside = 0 <= p[axis] && 8 > p[axis];
+				p[axis]           = (p[axis] + 16) % 8;
+				r[ufo::brickIndex(x, y, z)] =
+				    inside ? voxel(v, p[0], p[1], p[2])
+				           : -8 <= n && 8 >= n && voxel(next, p[0], p[1], p[2]);
+			}
+		}
+	}
+	return r;
+}
+
+ufo::Brick toBrick(Voxels const& v)
+{
+	ufo::Brick b;
+	for (std::size_t i{}; 512 != i; ++i) {
+		b.set(i, v[i]);
+	}
+	return b;
+}
+
+Voxels toVoxels(ufo::Brick const& b)
+{
+	Voxels v;
+	for (std::size_t i{}; 512 != i; ++i) {
+		v[i] = b[i];
+	}
+	return v;
+}
+
+template <std::size_t Axis>
+void checkShift(Voxels const& v, Voxels const& next)
+{
+	ufo::Brick const b = toBrick(v);
+	ufo::Brick const o = toBrick(next);
+	for (int n = -9; 10 != n; ++n) {
+		REQUIRE(shift(v, Voxels(), Axis, n) == toVoxels(ufo::brickShift<Axis>(b, n)));
+	}
+	// Shifting a whole brick gives the neighbor
+	for (int n = -8; 9 != n; ++n) {
+		REQUIRE(shift(v, next, Axis, n) == toVoxels(ufo::brickShift<Axis>(b, n, o)));
+	}
+}
+}  // namespace
+
+TEST_CASE("BitSet")
+{
+	using namespace ufo;
+
+	std::mt19937 gen(42);
+
+	SECTION("Single word")
+	{
+		BitSet<8> b(0x0Fu);
+		REQUIRE(4 == b.count());
+		REQUIRE(BitSet<8>(0xF0u) == (b << 4));
+		REQUIRE((~b).test(7));
+	}
+
+	SECTION("Multiple words")
+	{
+		checkBitSet<65>(gen);
+		checkBitSet<100>(gen);
+		checkBitSet<128>(gen);
+		checkBitSet<200>(gen);
+		checkBitSet<512>(gen);
+		checkBitSet<1000>(gen);
+	}
+}
+
+TEST_CASE("Brick")
+{
+	using namespace ufo;
+
+	std::mt19937 gen(42);
+
+	auto const connectivities = {BrickConnectivity::FACE, BrickConnectivity::EDGE,
+	                             BrickConnectivity::VERTEX};
+
+	SECTION("Index")
+	{
+		STATIC_REQUIRE(0 == brickIndex(0, 0, 0));
+		STATIC_REQUIRE(1 == brickIndex(1, 0, 0));
+		STATIC_REQUIRE(8 == brickIndex(0, 1, 0));
+		STATIC_REQUIRE(64 == brickIndex(0, 0, 1));
+		STATIC_REQUIRE(511 == brickIndex(7, 7, 7));
+	}
+
+	SECTION("Shift")
+	{
+		std::bernoulli_distribution coin(0.5);
+		for (int round{}; 10 != round; ++round) {
+			Voxels v;
+			Voxels next;
+			for (std::size_t i{}; 512 != i; ++i) {
+				v[i]    = coin(gen);
+				next[i] = coin(gen);
+			}
+			checkShift<0>(v, next);
+			checkShift<1>(v, next);
+			checkShift<2>(v, next);
+		}
+	}
+
+	SECTION("Morphology")
+	{
+		for (double density : {0.02, 0.3, 0.8, 0.97}) {
+			std::bernoulli_distribution coin(density);
+			for (int round{}; 5 != round; ++round) {
+				Voxels v;
+				for (std::size_t i{}; 512 != i; ++i) {
+					v[i] = coin(gen);
+				}
+				Brick const b = toBrick(v);
+
+				for (auto c : connectivities) {
+					REQUIRE(morphology(v, c, true, false) == toVoxels(brickNeighborAny(b, c)));
+					REQUIRE(morphology(v, c, true, true) == toVoxels(brickDilate(b, c)));
+					REQUIRE(morphology(v, c, false, true) == toVoxels(brickErode(b, c)));
+				}
+			}
+		}
+	}
+
+	SECTION("Single voxel and full brick")
+	{
+		Brick one;
+		one.set(brickIndex(3, 4, 5));
+		REQUIRE(6 == brickNeighborAny(one, BrickConnectivity::FACE).count());
+		REQUIRE(18 == brickNeighborAny(one, BrickConnectivity::EDGE).count());
+		REQUIRE(26 == brickNeighborAny(one, BrickConnectivity::VERTEX).count());
+		REQUIRE(27 == brickDilate(one, BrickConnectivity::VERTEX).count());
+		REQUIRE(brickErode(one).none());
+
+		// Only the boundary of the brick is eroded
+		Brick full;
+		full.set();
+		REQUIRE(6 * 6 * 6 == brickErode(full, BrickConnectivity::VERTEX).count());
+		REQUIRE(full == brickDilate(full));
+	}
+}
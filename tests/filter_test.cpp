@@ -0,0 +1,225 @@
+// UFO
+#include <ufo/utility/bloom_filter.hpp>
+#include <ufo/utility/cuckoo_filter.hpp>
+#include <ufo/utility/io/buffer.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+std::vector<std::uint64_t> randomKeys(std::size_t count, std::uint64_t seed)
+{
+	std::mt19937_64            gen(seed);
+	std::vector<std::uint64_t> keys(count);
+	for (auto& k : keys) {
+		k = gen();
+	}
+	return keys;
+}
+
+template <class Filter>
+double measuredFpr(Filter const& filter, std::vector<std::uint64_t> const& absent)
+{
+	std::size_t hits{};
+	for (auto k : absent) {
+		hits += filter.contains(k);
+	}
+	return static_cast<double>(hits) / static_cast<double>(absent.size());
+}
+}  // namespace
+
+TEST_CASE("BloomFilter")
+{
+	using namespace ufo;
+
+	auto const keys   = randomKeys(10000, 1);
+	auto const absent = randomKeys(100000, 2);
+
+	SECTION("No false negatives")
+	{
+		BloomFilter<std::uint64_t> filter(keys.size(), 0.01);
+		filter.insert(Span<std::uint64_t const>(keys));
+		for (auto k : keys) {
+			REQUIRE(filter.contains(k));
+		}
+
+		auto const result = std::make_unique<bool[]>(keys.size());
+		filter.contains(Span<std::uint64_t const>(keys),
+		                Span<bool>(result.get(), keys.size()));
+		for (std::size_t i{}; keys.size() != i; ++i) {
+			REQUIRE(result[i]);
+		}
+	}
+
+	SECTION("False positive rate")
+	{
+		for (double fpr : {0.1, 0.01, 0.001}) {
+			BloomFilter<std::uint64_t> filter(keys.size(), fpr);
+			for (auto k : keys) {
+				filter.insert(k);
+			}
+			REQUIRE(fpr >= filter.falsePositiveRate(keys.size()));
+			REQUIRE(1.5 * fpr >= measuredFpr(filter, absent));
+		}
+		REQUIRE_THROWS_AS(BloomFilter<std::uint64_t>(10, 0.0), std::invalid_argument);
+		REQUIRE_THROWS_AS(BloomFilter<std::uint64_t>(10, 1.0), std::invalid_argument);
+	}
+
+	SECTION("Default constructed")
+	{
+		BloomFilter<std::uint64_t> filter;
+		REQUIRE(1 == filter.numBlocks());
+		REQUIRE(!filter.contains(42));
+		filter.insert(42);
+		filter.insert(Span<std::uint64_t const>(keys.data(), 10));
+		REQUIRE(filter.contains(42));
+		REQUIRE(filter.contains(keys[9]));
+	}
+
+	SECTION("Merge and clear")
+	{
+		BloomFilter<std::uint64_t> a(keys.size());
+		BloomFilter<std::uint64_t> b(keys.size());
+		for (std::size_t i{}; keys.size() != i; ++i) {
+			(i % 2 ? a : b).insert(keys[i]);
+		}
+		a.merge(b);
+		for (auto k : keys) {
+			REQUIRE(a.contains(k));
+		}
+		REQUIRE_THROWS_AS(a.merge(BloomFilter<std::uint64_t>(10 * keys.size())),
+		                  std::invalid_argument);
+
+		a.clear();
+		REQUIRE(a == BloomFilter<std::uint64_t>(keys.size()));
+	}
+
+	SECTION("Write/read")
+	{
+		BloomFilter<std::uint64_t> a(keys.size());
+		a.insert(Span<std::uint64_t const>(keys));
+
+		Buffer buffer;
+		a.write(buffer);
+		BloomFilter<std::uint64_t> b;
+		b.read(buffer);
+		REQUIRE(a == b);
+		REQUIRE(0 == buffer.readLeft());
+
+		Buffer truncated;
+		truncated.write(std::uint64_t(2));
+		truncated.write(std::uint64_t(0));
+		REQUIRE_THROWS_AS(b.read(truncated), std::out_of_range);
+		REQUIRE(a == b);
+
+		Buffer empty;
+		empty.write(std::uint64_t(0));
+		REQUIRE_THROWS_AS(b.read(empty), std::runtime_error);
+		REQUIRE(a == b);
+	}
+}
+
+TEST_CASE("CuckooFilter")
+{
+	using namespace ufo;
+
+	auto const keys   = randomKeys(10000, 3);
+	auto const absent = randomKeys(100000, 4);
+
+	SECTION("Insert, contains, erase")
+	{
+		CuckooFilter<std::uint64_t> filter(keys.size());
+		REQUIRE(keys.size() == filter.insert(Span<std::uint64_t const>(keys)));
+		REQUIRE(keys.size() == filter.size());
+		for (auto k : keys) {
+			REQUIRE(filter.contains(k));
+		}
+		REQUIRE(2.0 * filter.falsePositiveRate() >= measuredFpr(filter, absent));
+
+		for (std::size_t i{}; keys.size() != i; i += 2) {
+			REQUIRE(filter.erase(keys[i]));
+		}
+		REQUIRE(keys.size() / 2 == filter.size());
+		for (std::size_t i = 1; keys.size() > i; i += 2) {
+			REQUIRE(filter.contains(keys[i]));
+		}
+
+		filter.clear();
+		REQUIRE(filter.empty());
+		REQUIRE(!filter.contains(keys[1]));
+	}
+
+	SECTION("8 bit fingerprints")
+	{
+		CuckooFilter<std::uint64_t, Hash<std::uint64_t>, std::uint8_t> filter(keys.size());
+		for (auto k : keys) {
+			REQUIRE(filter.insert(k));
+		}
+		auto const result = std::make_unique<bool[]>(keys.size());
+		filter.contains(Span<std::uint64_t const>(keys),
+		                Span<bool>(result.get(), keys.size()));
+		for (std::size_t i{}; keys.size() != i; ++i) {
+			REQUIRE(result[i]);
+		}
+		REQUIRE(0.05 > measuredFpr(filter, absent));
+	}
+
+	SECTION("Full")
+	{
+		CuckooFilter<std::uint64_t> filter(100);
+		std::size_t const           n = filter.insert(Span<std::uint64_t const>(keys));
+		REQUIRE(n < keys.size());
+		REQUIRE(0.9 < static_cast<double>(n) / static_cast<double>(filter.capacity()));
+		REQUIRE(!filter.insert(keys[n]));
+		for (std::size_t i{}; n != i; ++i) {
+			REQUIRE(filter.contains(keys[i]));
+		}
+	}
+
+	SECTION("Default constructed")
+	{
+		CuckooFilter<std::uint64_t> filter;
+		REQUIRE(!filter.insert(42));
+		REQUIRE(0 == filter.insert(Span<std::uint64_t const>(keys)));
+		REQUIRE(!filter.contains(42));
+		REQUIRE(!filter.erase(42));
+	}
+
+	SECTION("Write/read")
+	{
+		CuckooFilter<std::uint64_t> a(keys.size());
+		a.insert(Span<std::uint64_t const>(keys));
+
+		Buffer buffer;
+		a.write(buffer);
+		CuckooFilter<std::uint64_t> b;
+		b.read(buffer);
+		REQUIRE(a == b);
+		REQUIRE(0 == buffer.readLeft());
+
+		buffer.readPos(0);
+		CuckooFilter<std::uint64_t, Hash<std::uint64_t>, std::uint8_t> c;
+		REQUIRE_THROWS_AS(c.read(buffer), std::invalid_argument);
+
+		Buffer malformed;
+		malformed.write(std::uint8_t(16));
+		malformed.write(std::uint64_t(3));
+		malformed.write(std::uint64_t(0));
+		malformed.write(std::uint64_t(0));
+		malformed.write(std::uint16_t(0));
+		malformed.write(std::uint8_t(0));
+		for (int i{}; 3 != i; ++i) {
+			malformed.write(std::uint64_t(0));
+		}
+		REQUIRE_THROWS_AS(b.read(malformed), std::runtime_error);
+		REQUIRE(a == b);
+	}
+}
@@ -0,0 +1,206 @@
+// UFO
+#include <ufo/utility/bit.hpp>
+#include <ufo/utility/concurrent_flat_hash_map.hpp>
+#include <ufo/utility/flat_hash_map.hpp>
+#include <ufo/utility/hash.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+// Seeded, with no default constructor, and counting its calls
+struct SeededHash {
+	std::uint64_t seed;
+	std::size_t*  calls;
+
+	SeededHash(std::uint64_t seed, std::size_t& calls) : seed(seed), calls(&calls) {}
+
+	std::size_t operator()(int key) const
+	{
+		++*calls;
+		return static_cast<std::size_t>(ufo::hashValues(seed, key));
+	}
+};
+}  // namespace
+
+TEST_CASE("FlatHashMap")
+{
+	using namespace ufo;
+
+	SECTION("Bit ceil")
+	{
+		STATIC_REQUIRE(1u == bitCeil(0u));
+		STATIC_REQUIRE(1u == bitCeil(1u));
+		STATIC_REQUIRE(2u == bitCeil(2u));
+		STATIC_REQUIRE(4u == bitCeil(3u));
+		STATIC_REQUIRE(1024u == bitCeil(1000u));
+		STATIC_REQUIRE(std::uint64_t(1) << 40 == bitCeil((std::uint64_t(1) << 40) - 5));
+	}
+
+	SECTION("Insert, find and erase")
+	{
+		FlatHashMap<int, int> map;
+		REQUIRE(map.empty());
+		for (int i{}; 1000 != i; ++i) {
+			REQUIRE(map.insert({i, 2 * i}).second);
+		}
+		REQUIRE(!map.insert({5, 0}).second);
+		REQUIRE(1000 == map.size());
+		REQUIRE(map.load_factor() <= FlatHashMap<int, int>::max_load_factor());
+
+		for (int i{}; 1000 != i; ++i) {
+			REQUIRE(map.contains(i));
+			REQUIRE(2 * i == map.at(i));
+		}
+		REQUIRE(!map.contains(1000));
+		REQUIRE(map.end() == map.find(-1));
+		REQUIRE_THROWS_AS(map.at(-1), std::out_of_range);
+
+		for (int i{}; 1000 != i; i += 2) {
+			REQUIRE(1 == map.erase(i));
+		}
+		REQUIRE(0 == map.erase(0));
+		REQUIRE(500 == map.size());
+		for (int i{}; 1000 != i; ++i) {
+			REQUIRE((i % 2) == static_cast<int>(map.count(i)));
+		}
+
+		int n{};
+		for (auto const& [key, value] : map) {
+			REQUIRE(1 == key % 2);
+			REQUIRE(2 * key == value);
+			++n;
+		}
+		REQUIRE(500 == n);
+
+		map.clear();
+		REQUIRE(map.empty());
+		REQUIRE(map.end() == map.begin());
+	}
+
+	SECTION("Against std::unordered_map")
+	{
+		FlatHashMap<std::uint64_t, std::string> map;
+		std::unordered_map<std::uint64_t, std::string> ref;
+		std::mt19937_64 gen(7);
+		for (int i{}; 20000 != i; ++i) {
+			std::uint64_t const key = gen() % 2000;
+			switch (gen() % 3) {
+				case 0:
+					map[key] = std::to_string(i);
+					ref[key] = std::to_string(i);
+					break;
+				case 1: REQUIRE(ref.erase(key) == map.erase(key)); break;
+				default: REQUIRE(ref.count(key) == map.count(key)); break;
+			}
+			REQUIRE(ref.size() == map.size());
+		}
+		for (auto const& [key, value] : ref) {
+			REQUIRE(value == map.at(key));
+		}
+
+		auto copy = map;
+		REQUIRE(ref.size() == copy.size());
+		copy.rehash(0);
+		for (auto const& [key, value] : ref) {
+			REQUIRE(value == copy.at(key));
+		}
+	}
+
+	SECTION("Move-only values")
+	{
+		FlatHashMap<int, std::unique_ptr<int>> map;
+		for (int i{}; 100 != i; ++i) {
+			map.try_emplace(i, std::make_unique<int>(i));
+		}
+		auto moved = std::move(map);
+		REQUIRE(100 == moved.size());
+		REQUIRE(42 == *moved.at(42));
+		moved.insert_or_assign(42, std::make_unique<int>(-1));
+		REQUIRE(-1 == *moved.at(42));
+	}
+
+	SECTION("Set")
+	{
+		FlatHashSet<std::string> set{"a", "b", "c"};
+		REQUIRE(3 == set.size());
+		REQUIRE(!set.insert("a").second);
+		REQUIRE(set.insert("d").second);
+		REQUIRE(set.contains("d"));
+		REQUIRE(1 == set.erase("a"));
+		REQUIRE(!set.contains("a"));
+	}
+}
+
+TEST_CASE("ConcurrentFlatHashMap")
+{
+	using namespace ufo;
+
+	ConcurrentFlatHashMap<int, int> map(16);
+	REQUIRE(16 == map.numShards());
+
+	std::vector<std::thread> threads;
+	for (int t{}; 4 != t; ++t) {
+		threads.emplace_back([&map, t] {
+			for (int i{}; 1000 != i; ++i) {
+				map.insert(t * 1000 + i, i);
+				map.emplaceOrVisit(-1 - i % 10, [](int& v) { ++v; }, 0);
+			}
+		});
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	REQUIRE(4010 == map.size());
+	REQUIRE(7 == map.find(2007));
+	REQUIRE(!map.find(5000));
+	REQUIRE(!map.insert(2007, 0));
+	REQUIRE(!map.insertOrAssign(2007, 8));
+	REQUIRE(8 == map.find(2007));
+	REQUIRE(map.visit(2007, [](int& v) { v = 9; }));
+	REQUIRE(9 == map.find(2007));
+
+	int total{};
+	map.forEach([&total](int key, int value) {
+		if (0 > key) {
+			total += value;
+		}
+	});
+	REQUIRE(4000 == total);
+
+	REQUIRE(map.erase(2007));
+	REQUIRE(!map.contains(2007));
+	map.clear();
+	REQUIRE(map.empty());
+}
+
+TEST_CASE("ConcurrentFlatHashMap with a seeded hash")
+{
+	using namespace ufo;
+
+	std::size_t calls{};
+	ConcurrentFlatHashMap<int, int, SeededHash> map(8, SeededHash(7, calls));
+	for (int i{}; 5000 != i; ++i) {
+		REQUIRE(map.insert(i, 2 * i));
+	}
+	// The shards hash with the given hasher too, growing included
+	REQUIRE(2 * 5000 < calls);
+	for (int i{}; 5000 != i; ++i) {
+		REQUIRE(2 * i == map.find(i));
+	}
+	REQUIRE(!map.contains(5000));
+	REQUIRE(5000 == map.size());
+}
@@ -0,0 +1,159 @@
+// UFO
+#include <ufo/utility/io/buffer.hpp>
+#include <ufo/utility/io/float_codec.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Float codecs")
+{
+	using namespace ufo;
+
+	std::mt19937                          gen(42);
+	std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+	std::vector<float> values(1000);
+	for (auto& v : values) {
+		v = dist(gen);
+	}
+
+	SECTION("Fixed point")
+	{
+		for (float max_error : {1e-3f, 0.1f, 10.0f}) {
+			Buffer      buffer;
+			float const error = writeFixedPoint(buffer, Span<float const>(values), max_error);
+			REQUIRE(error <= max_error * (1.0f + 1e-5f));
+
+			std::vector<float> out{1.0f};
+			readFixedPoint(buffer, out);
+			REQUIRE(values.size() == out.size());
+			REQUIRE(0 == buffer.readLeft());
+			for (std::size_t i{}; values.size() != i; ++i) {
+				REQUIRE(std::abs(values[i] - out[i]) <= error);
+			}
+		}
+	}
+
+	SECTION("Fixed point edge cases")
+	{
+		std::vector<float> empty;
+		std::vector<float> same(10, 3.5f);
+
+		Buffer buffer;
+		writeFixedPoint(buffer, Span<float const>(empty), 0.1f);
+		REQUIRE(0.0f == writeFixedPoint(buffer, Span<float const>(same), 0.1f));
+
+		std::vector<float> out{1.0f};
+		readFixedPoint(buffer, out);
+		REQUIRE(out.empty());
+		readFixedPoint(buffer, out);
+		REQUIRE(same == out);
+
+		REQUIRE_THROWS_AS(writeFixedPoint(buffer, Span<float const>(values), 0.0f),
+		                  std::invalid_argument);
+		REQUIRE_THROWS_AS(writeFixedPoint(buffer, Span<float const>(values), 1e-9f),
+		                  std::invalid_argument);
+	}
+
+	SECTION("Fixed point corrupt input")
+	{
+		Buffer buffer;
+		buffer.write(0.0);
+		buffer.write(1.0);
+		buffer.write(std::uint32_t(32));
+		buffer.write(std::uint64_t(1) << 59);
+
+		std::vector<float> out{1.0f, 2.0f};
+		REQUIRE_THROWS_AS(readFixedPoint(buffer, out), std::out_of_range);
+		REQUIRE(std::vector<float>{1.0f, 2.0f} == out);
+	}
+
+	SECTION("Half")
+	{
+		REQUIRE(0x3C00 == floatToHalf(1.0f));
+		REQUIRE(0x7BFF == floatToHalf(65504.0f));
+		REQUIRE(0x7C00 == floatToHalf(1e6f));
+		REQUIRE(0x0001 == floatToHalf(std::ldexp(1.0f, -24)));
+		float const nan = std::numeric_limits<float>::quiet_NaN();
+		REQUIRE(std::isnan(halfToFloat(floatToHalf(nan))));
+		// Ties round to even
+		REQUIRE(0x3C00 == floatToHalf(1.0f + std::ldexp(1.0f, -11)));
+		REQUIRE(0x3C02 == floatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)));
+
+		for (std::uint32_t h{}; 0x10000 != h; ++h) {
+			float const f = halfToFloat(static_cast<std::uint16_t>(h));
+			if (!std::isnan(f)) {
+				REQUIRE(h == floatToHalf(f));
+			}
+		}
+
+		Buffer      buffer;
+		float const error = writeHalf(buffer, Span<float const>(values));
+		REQUIRE(error <= 100.0f * std::ldexp(1.0f, -11));
+
+		std::vector<float> out;
+		readHalf(buffer, out);
+		REQUIRE(values.size() == out.size());
+		for (std::size_t i{}; values.size() != i; ++i) {
+			REQUIRE(std::abs(values[i] - out[i]) <= error);
+		}
+
+		Buffer truncated;
+		truncated.write(std::uint64_t(10));
+		truncated.write(std::uint16_t(0));
+		REQUIRE_THROWS_AS(readHalf(truncated, out), std::out_of_range);
+		REQUIRE(values.size() == out.size());
+	}
+
+	SECTION("XOR")
+	{
+		std::vector<double> series(1000);
+		double              t = 1.0e9;
+		for (std::size_t i{}; series.size() != i; ++i) {
+			series[i] = 0 == i % 7 ? series[i - (0 != i)] : (t += 0.25);
+		}
+		series[10] = std::numeric_limits<double>::infinity();
+		series[11] = -0.0;
+
+		Buffer buffer;
+		REQUIRE(0.0 == writeXor(buffer, Span<double const>(series)));
+
+		std::vector<double> out;
+		readXor(buffer, out);
+		REQUIRE(series.size() == out.size());
+		for (std::size_t i{}; series.size() != i; ++i) {
+			REQUIRE(0 == std::memcmp(&series[i], &out[i], sizeof(double)));
+		}
+
+		Buffer      lossy;
+		float const error = writeXor(lossy, Span<float const>(values), 10);
+		REQUIRE(error <= 100.0f * std::ldexp(1.0f, -11));
+
+		std::vector<float> rec;
+		readXor(lossy, rec);
+		for (std::size_t i{}; values.size() != i; ++i) {
+			REQUIRE(std::abs(values[i] - rec[i]) <= error);
+		}
+	}
+
+	SECTION("XOR corrupt input")
+	{
+		Buffer buffer;
+		buffer.write(std::uint64_t(16));
+		buffer.write(std::uint8_t(23));
+		buffer.write(std::uint16_t(0xFFFF));
+
+		std::vector<float> out{1.0f};
+		REQUIRE_THROWS_AS(readXor(buffer, out), std::out_of_range);
+		REQUIRE(std::vector<float>{1.0f} == out);
+	}
+}
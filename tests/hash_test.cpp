@@ -0,0 +1,183 @@
+// UFO
+#include <ufo/utility/bit_set.hpp>
+#include <ufo/utility/hash.hpp>
+#include <ufo/utility/io/buffer.hpp>
+#include <ufo/utility/io/buffer_hash.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Hash")
+{
+	using namespace ufo;
+
+	std::mt19937_64 gen(42);
+
+	std::vector<unsigned char> bytes(1000);
+	for (auto& b : bytes) {
+		b = static_cast<unsigned char>(gen());
+	}
+
+	SECTION("Stable values")
+	{
+		// Hashes are stored as checksums, so they must not change between versions or
+		// platforms. The empty input matches the reference wyhash.
+		REQUIRE(0x93228A4DE0EEC5A2u == hashBytes("", 0));
+		REQUIRE(0x989B4A209C1011C9u == hashBytes("abc", 3));
+		REQUIRE(0x4518DF1B278CE8D2u == hashBytes("abc", 3, 1));
+		REQUIRE(0x08E445DF107BB587u ==
+		        hashBytes("The quick brown fox jumps over the lazy dog"));
+		REQUIRE(0xC48F5651AA48DB61u == hashBytes(bytes.data(), bytes.size()));
+	}
+
+	SECTION("Lengths, seeds and alignment")
+	{
+		std::unordered_set<std::uint64_t> seen;
+		for (std::size_t len{}; 200 != len; ++len) {
+			std::uint64_t const h = hashBytes(bytes.data(), len);
+			REQUIRE(seen.insert(h).second);
+			REQUIRE(seen.insert(hashBytes(bytes.data(), len, 1)).second);
+
+			// Only the bytes matter, not where they are
+			std::vector<unsigned char> copy(bytes.begin(), bytes.begin() + len + 7);
+			for (std::size_t offset{}; 8 != offset; ++offset) {
+				std::copy(bytes.begin(), bytes.begin() + len, copy.begin() + offset);
+				REQUIRE(h == hashBytes(copy.data() + offset, len));
+			}
+		}
+
+		// Every flipped bit changes the hash
+		for (std::size_t len : {1, 8, 16, 17, 48, 49, 100}) {
+			std::uint64_t const h = hashBytes(bytes.data(), len);
+			for (std::size_t bit{}; 8 * len != bit; ++bit) {
+				bytes[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+				REQUIRE(h != hashBytes(bytes.data(), len));
+				bytes[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+			}
+		}
+	}
+
+	SECTION("Distribution")
+	{
+		// Sequential keys spread evenly over the buckets, for the low and the high bits
+		std::vector<std::size_t> low(256);
+		std::vector<std::size_t> high(256);
+		for (std::uint64_t i{}; 256 * 1000 != i; ++i) {
+			std::uint64_t const h = hashBytes(&i, sizeof(i));
+			++low[h & 0xFF];
+			++high[h >> 56];
+		}
+		for (std::size_t b{}; 256 != b; ++b) {
+			REQUIRE(850 < low[b]);
+			REQUIRE(1150 > low[b]);
+			REQUIRE(850 < high[b]);
+			REQUIRE(1150 > high[b]);
+		}
+	}
+
+	SECTION("Hasher")
+	{
+		for (std::size_t len{}; 300 != len; ++len) {
+			std::uint64_t const expected = hashBytes(bytes.data(), len, 7);
+
+			Hasher whole(7);
+			whole.update(bytes.data(), len);
+			REQUIRE(expected == whole.digest());
+			REQUIRE(len == whole.size());
+
+			// Split at every position
+			for (std::size_t split{}; len >= split; ++split) {
+				Hasher h(7);
+				h.update(bytes.data(), split).update(bytes.data() + split, len - split);
+				REQUIRE(expected == h.digest());
+			}
+
+			Hasher single(7);
+			for (std::size_t i{}; len != i; ++i) {
+				single.update(bytes.data() + i, 1);
+				// The digest does not disturb later updates
+				(void)single.digest();
+			}
+			REQUIRE(expected == single.digest());
+		}
+
+		// Random pieces of a long input
+		for (int round{}; 100 != round; ++round) {
+			Hasher      h;
+			std::size_t pos{};
+			while (bytes.size() != pos) {
+				std::size_t const n = std::min<std::size_t>(bytes.size() - pos, gen() % 130);
+				h.update(bytes.data() + pos, n);
+				pos += n;
+			}
+			REQUIRE(hashBytes(bytes.data(), bytes.size()) == h.digest());
+		}
+
+		Hasher h(3);
+		h.update("some data");
+		h.reset();
+		h.update(std::string_view("abc"));
+		REQUIRE(hashBytes("abc") == h.digest());
+	}
+
+	SECTION("Values")
+	{
+		std::string const s = "voxel";
+		REQUIRE(hashBytes(s) == Hash<std::string>{}(s));
+		REQUIRE(Hash<std::string>{}(s) == Hash<std::string_view>{}(s));
+		REQUIRE(Hash<std::u16string>{}(u"ab") == hashBytes(u"ab", 2 * sizeof(char16_t)));
+
+		using Tuple = std::tuple<int, std::string, double>;
+		REQUIRE(hashValues(1, std::string("a"), 2.5) == Hash<Tuple>{}(Tuple(1, "a", 2.5)));
+		REQUIRE(Hash<std::pair<int, int>>{}({1, 2}) == hashValues(1, 2));
+		REQUIRE(Hash<std::pair<int, int>>{}({1, 2}) != Hash<std::pair<int, int>>{}({2, 1}));
+		REQUIRE(hashValues(1, 2) != hashValues(1, 2, 0));
+
+		// Nested tuples
+		using Nested = std::tuple<std::pair<int, std::string>, unsigned>;
+		REQUIRE(Hash<Nested>{}(Nested({3, "b"}, 4u)) ==
+		        hashValues(std::pair<int, std::string>(3, "b"), 4u));
+
+		BitSet<200> a;
+		BitSet<200> b;
+		a.set(150);
+		b.set(150);
+		REQUIRE(std::hash<BitSet<200>>{}(a) == std::hash<BitSet<200>>{}(b));
+		b.set(3);
+		REQUIRE(std::hash<BitSet<200>>{}(a) != std::hash<BitSet<200>>{}(b));
+	}
+
+	SECTION("Buffers")
+	{
+		Buffer buffer;
+		buffer.write(bytes.data(), bytes.size());
+		buffer.readSkip(10);
+
+		REQUIRE(hashBytes(bytes.data() + 10, bytes.size() - 10, 5) == hashBytes(buffer, 5));
+		REQUIRE(10 == buffer.readPos());
+
+		Hasher h;
+		hashRead(h, buffer, 100);
+		hashRead(h, buffer, 200);
+		REQUIRE(310 == buffer.readPos());
+		REQUIRE(hashBytes(bytes.data() + 10, 300) == h.digest());
+
+		REQUIRE_THROWS_AS(hashRead(h, buffer, bytes.size()), std::out_of_range);
+		REQUIRE(310 == buffer.readPos());
+		REQUIRE(300 == h.size());
+	}
+}
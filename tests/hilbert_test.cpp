@@ -0,0 +1,171 @@
+// UFO
+#include <ufo/utility/hilbert.hpp>
+#include <ufo/utility/radix_sort.hpp>
+#include <ufo/utility/span.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Walks the first `2^(levels * Dim)` indices, which have to visit every cell of the
+// box at the origin exactly once, stepping to a face neighbor each time
+template <std::size_t Dim, class Code>
+void checkCurve(unsigned levels)
+{
+	std::size_t const side  = std::size_t(1) << levels;
+	std::size_t const cells = std::size_t(1) << (levels * Dim);
+
+	std::vector<bool>            seen(cells);
+	std::array<std::size_t, Dim> prev{};
+	for (std::size_t h{}; cells != h; ++h) {
+		auto const c = ufo::hilbertDecode<Dim>(static_cast<Code>(h));
+
+		std::size_t cell{};
+		std::size_t dist{};
+		for (std::size_t d = Dim; 0 != d--;) {
+			REQUIRE(side > c[d]);
+			cell = cell * side + c[d];
+			dist += c[d] > prev[d] ? c[d] - prev[d] : prev[d] - c[d];
+			prev[d] = c[d];
+		}
+		REQUIRE(!seen[cell]);
+		seen[cell] = true;
+		REQUIRE((0 == h ? 0 : 1) == dist);
+
+		if constexpr (2 == Dim) {
+			REQUIRE(h == ufo::hilbertEncode<Code>(c[0], c[1]));
+		} else {
+			REQUIRE(h == ufo::hilbertEncode<Code>(c[0], c[1], c[2]));
+		}
+	}
+}
+
+template <class Code, std::size_t Dim, class Gen>
+void checkRoundTrip(Gen& gen)
+{
+	using Coord = ufo::MortonCoord<Code, Dim>;
+	Coord const mask =
+	    static_cast<Coord>(~Coord(0) >> (8 * sizeof(Coord) -
+	                                     ufo::detail::MORTON_COORD_BITS<Code, Dim>));
+
+	for (int i{}; 1000 != i; ++i) {
+		std::array<Coord, Dim> c;
+		for (auto& e : c) {
+			e = static_cast<Coord>(gen()) & mask;
+		}
+		c[0] = 0 == i ? Coord(0) : 1 == i ? mask : c[0];
+
+		Code code;
+		if constexpr (2 == Dim) {
+			code = ufo::hilbertEncode<Code>(c[0], c[1]);
+		} else {
+			code = ufo::hilbertEncode<Code>(c[0], c[1], c[2]);
+		}
+		REQUIRE(c == ufo::hilbertDecode<Dim>(code));
+	}
+}
+}  // namespace
+
+TEST_CASE("Hilbert")
+{
+	using namespace ufo;
+
+	std::mt19937_64 gen(42);
+
+	SECTION("Curve")
+	{
+		STATIC_REQUIRE(0 == hilbertEncode<std::uint32_t>(0u, 0u));
+		STATIC_REQUIRE(0 == hilbertEncode<std::uint64_t>(0u, 0u, 0u));
+		STATIC_REQUIRE(6u == hilbertDecode<3>(hilbertEncode<std::uint64_t>(5u, 6u, 7u))[1]);
+
+		for (unsigned levels = 1; 6 != levels; ++levels) {
+			checkCurve<2, std::uint32_t>(levels);
+			checkCurve<2, std::uint64_t>(levels);
+		}
+		for (unsigned levels = 1; 5 != levels; ++levels) {
+			checkCurve<3, std::uint32_t>(levels);
+			checkCurve<3, std::uint64_t>(levels);
+		}
+	}
+
+	SECTION("Round trip")
+	{
+		checkRoundTrip<std::uint32_t, 2>(gen);
+		checkRoundTrip<std::uint32_t, 3>(gen);
+		checkRoundTrip<std::uint64_t, 2>(gen);
+		checkRoundTrip<std::uint64_t, 3>(gen);
+#if defined(__SIZEOF_INT128__)
+		checkRoundTrip<Morton128, 2>(gen);
+		checkRoundTrip<Morton128, 3>(gen);
+#endif
+
+		// The whole index range is used
+		REQUIRE(0 == hilbertEncode<std::uint32_t>(0u, 0u));
+		auto const c = hilbertDecode<2>(~std::uint32_t(0));
+		REQUIRE(~std::uint32_t(0) == hilbertEncode<std::uint32_t>(c[0], c[1]));
+	}
+
+	SECTION("Spans")
+	{
+		std::size_t const          n = 100;
+		std::vector<std::uint32_t> x(n);
+		std::vector<std::uint32_t> y(n);
+		std::vector<std::uint32_t> z(n);
+		for (std::size_t i{}; n != i; ++i) {
+			x[i] = static_cast<std::uint32_t>(gen() & 0x1FFFFF);
+			y[i] = static_cast<std::uint32_t>(gen() & 0x1FFFFF);
+			z[i] = static_cast<std::uint32_t>(gen() & 0x1FFFFF);
+		}
+
+		std::vector<std::uint64_t> codes(n);
+		hilbertEncode<std::uint64_t>(x, y, z, codes);
+		for (std::size_t i{}; n != i; ++i) {
+			REQUIRE(hilbertEncode(x[i], y[i], z[i]) == codes[i]);
+		}
+
+		std::vector<std::uint32_t> dx(n);
+		std::vector<std::uint32_t> dy(n);
+		std::vector<std::uint32_t> dz(n);
+		hilbertDecode<std::uint64_t>(codes, dx, dy, dz);
+		REQUIRE(x == dx);
+		REQUIRE(y == dy);
+		REQUIRE(z == dz);
+
+		hilbertEncode<std::uint64_t>(x, y, codes);
+		hilbertDecode<std::uint64_t>(codes, dx, dy);
+		REQUIRE(x == dx);
+		REQUIRE(y == dy);
+	}
+
+	SECTION("Sorting")
+	{
+		std::vector<std::array<int, 2>> points;
+		for (int x{}; 16 != x; ++x) {
+			for (int y{}; 16 != y; ++y) {
+				points.push_back({x, y});
+			}
+		}
+		std::shuffle(points.begin(), points.end(), gen);
+
+		auto by_less = points;
+		std::sort(by_less.begin(), by_less.end(), HilbertLess<2>{});
+		radixSort(points, HilbertKey<2>{});
+		REQUIRE(by_less == points);
+
+		// Consecutive points are neighbors
+		for (std::size_t i = 1; points.size() != i; ++i) {
+			REQUIRE(1 == std::abs(points[i][0] - points[i - 1][0]) +
+			                 std::abs(points[i][1] - points[i - 1][1]));
+		}
+	}
+}
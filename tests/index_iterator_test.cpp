@@ -0,0 +1,98 @@
+// UFO
+#include <ufo/utility/index_iterator.hpp>
+#include <ufo/utility/parallel_for.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+template <class T>
+std::vector<T> indices(ufo::IndexIterator<T> const& range)
+{
+	return std::vector<T>(range.begin(), range.end());
+}
+
+// Recursively splits `range` like a scheduler would, appending the pieces to `out`
+template <class T>
+void splitAll(ufo::IndexIterator<T> range, std::vector<ufo::IndexIterator<T>>& out)
+{
+	if (!range.is_divisible()) {
+		out.push_back(range);
+		return;
+	}
+	ufo::IndexIterator<T> second(range, ufo::split{});
+	splitAll(range, out);
+	splitAll(second, out);
+}
+}  // namespace
+
+TEST_CASE("IndexIterator")
+{
+	using namespace ufo;
+
+	SECTION("Size and iteration")
+	{
+		REQUIRE(10 == IndexIterator<std::size_t>(0, 10).size());
+		REQUIRE(4 == IndexIterator<std::size_t>(0, 10, 3).size());
+		REQUIRE(IndexIterator<std::size_t>(5, 5).empty());
+		REQUIRE(IndexIterator<std::size_t>(6, 5).empty());
+		REQUIRE((std::vector<std::size_t>{0, 3, 6, 9} ==
+		         indices(IndexIterator<std::size_t>(0, 10, 3))));
+
+		REQUIRE((std::vector<int>{10, 7, 4, 1} == indices(IndexIterator<int>(10, 0, -3))));
+		REQUIRE((std::vector<int>{-2, -1, 0, 1} == indices(IndexIterator<int>(-2, 2))));
+		REQUIRE(IndexIterator<int>(0, 10, -1).empty());
+
+		IndexIterator<int> r(0, 10, 3);
+		auto               it = r.begin();
+		REQUIRE(4 == r.end() - it);
+		REQUIRE(6 == it[2]);
+		REQUIRE(9 == *(it + 3));
+		REQUIRE(it < r.end());
+	}
+
+	SECTION("Split")
+	{
+		for (int inc : {1, 3, -2}) {
+			IndexIterator<int> const range(inc > 0 ? 0 : 100, inc > 0 ? 100 : 0, inc, 7);
+			REQUIRE(range.is_divisible());
+			REQUIRE(7 == range.grainsize());
+
+			std::vector<IndexIterator<int>> pieces;
+			splitAll(range, pieces);
+			REQUIRE(1 < pieces.size());
+
+			std::vector<int> joined;
+			for (auto const& p : pieces) {
+				REQUIRE(!p.empty());
+				REQUIRE(7 >= p.size());
+				auto const v = indices(p);
+				joined.insert(joined.end(), v.begin(), v.end());
+			}
+			REQUIRE(indices(range) == joined);
+		}
+
+		IndexIterator<int> small(0, 7, 1, 7);
+		REQUIRE(!small.is_divisible());
+	}
+
+	SECTION("Parallel for")
+	{
+		std::vector<int> hits(1000);
+		parallel_for(IndexIterator<std::size_t>(0, hits.size()),
+		             [&hits](std::size_t i) { ++hits[i]; });
+		parallel_for(IndexIterator<std::size_t>(1, hits.size(), 2), 16,
+		             [&hits](std::size_t i) { ++hits[i]; });
+
+		for (std::size_t i{}; hits.size() != i; ++i) {
+			REQUIRE(1 + static_cast<int>(i % 2) == hits[i]);
+		}
+
+		parallel_for(IndexIterator<int>(5, 5), [](int) { REQUIRE(false); });
+	}
+}
@@ -0,0 +1,66 @@
+// UFO
+#include <ufo/utility/morton.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("Morton")
+{
+	using namespace ufo;
+
+	SECTION("Encode")
+	{
+		STATIC_REQUIRE(1 == mortonEncode<std::uint64_t>(1u, 0u, 0u));
+		STATIC_REQUIRE(2 == mortonEncode<std::uint64_t>(0u, 1u, 0u));
+		STATIC_REQUIRE(4 == mortonEncode<std::uint64_t>(0u, 0u, 1u));
+		STATIC_REQUIRE(0x1249249249249249u == mortonEncode<std::uint64_t>(~0u, 0u, 0u));
+		STATIC_REQUIRE(0x55555555u == mortonEncode<std::uint32_t>(~0u, 0u));
+		REQUIRE(mortonEncode(1234u, 5678u, 91011u) == mortonEncodeLut(1234u, 5678u, 91011u));
+	}
+
+	SECTION("Decode")
+	{
+		auto const code = mortonEncode(1234u, 5678u, 91011u);
+		auto const c    = mortonDecode<3>(code);
+		REQUIRE(1234u == c[0]);
+		REQUIRE(5678u == c[1]);
+		REQUIRE(91011u == c[2]);
+		REQUIRE(c == mortonDecodeLut<3>(code));
+	}
+
+	SECTION("Neighbors")
+	{
+		auto const code = mortonEncode(7u, 8u, 9u);
+		REQUIRE(mortonEncode(8u, 8u, 9u) == mortonIncrement<3, 0>(code));
+		REQUIRE(mortonEncode(7u, 7u, 9u) == mortonDecrement<3, 1>(code));
+		REQUIRE(mortonEncode(7u, 8u, 10u) == mortonIncrement<3, 2>(code));
+		REQUIRE(mortonEncode(9u, 11u, 13u) == mortonAdd<3>(code, mortonEncode(2u, 3u, 4u)));
+		REQUIRE(mortonEncode(5u, 5u, 5u) == mortonSub<3>(code, mortonEncode(2u, 3u, 4u)));
+	}
+
+	SECTION("Batch")
+	{
+		std::vector<std::uint32_t> x(37), y(37), z(37);
+		for (std::uint32_t i{}; 37 != i; ++i) {
+			x[i] = i;
+			y[i] = 3 * i;
+			z[i] = 7 * i;
+		}
+
+		std::vector<std::uint64_t> codes(37);
+		mortonEncode<std::uint64_t>(x, y, z, codes);
+		for (std::size_t i{}; 37 != i; ++i) {
+			REQUIRE(mortonEncode(x[i], y[i], z[i]) == codes[i]);
+		}
+
+		std::vector<std::uint32_t> x2(37), y2(37), z2(37);
+		mortonDecode<std::uint64_t>(codes, x2, y2, z2);
+		REQUIRE(x == x2);
+		REQUIRE(y == y2);
+		REQUIRE(z == z2);
+	}
+}
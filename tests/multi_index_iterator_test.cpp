@@ -0,0 +1,193 @@
+// UFO
+#include <ufo/utility/multi_index_iterator.hpp>
+#include <ufo/utility/parallel_for.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+template <std::size_t Dim, class T>
+std::vector<std::array<T, Dim>> viaIterators(ufo::MultiIndexIterator<Dim, T> const& r)
+{
+	return std::vector<std::array<T, Dim>>(r.begin(), r.end());
+}
+
+template <std::size_t Dim, class T>
+std::vector<std::array<T, Dim>> viaForEach(ufo::MultiIndexIterator<Dim, T> const& r)
+{
+	std::vector<std::array<T, Dim>> v;
+	r.forEach([&v](auto const& index) { v.push_back(index); });
+	return v;
+}
+
+template <std::size_t Dim, class T>
+std::vector<std::array<T, Dim>> viaSplit(ufo::MultiIndexIterator<Dim, T> r)
+{
+	if (!r.is_divisible()) {
+		return viaForEach(r);
+	}
+	ufo::MultiIndexIterator<Dim, T> second(r, ufo::split{});
+	auto                            a = viaSplit(r);
+	auto const                      b = viaSplit(second);
+	a.insert(a.end(), b.begin(), b.end());
+	return a;
+}
+
+// Every index of the box exactly once
+template <std::size_t Dim, class T>
+bool coversBox(std::vector<std::array<T, Dim>> v, std::array<T, Dim> const& first,
+               std::array<T, Dim> const& last)
+{
+	std::sort(v.begin(), v.end());
+	std::vector<std::array<T, Dim>> expected;
+	for (auto const& index :
+	     viaIterators(ufo::MultiIndexIterator<Dim, T>(first, last))) {
+		expected.push_back(index);
+	}
+	return expected == v;
+}
+
+// The three ways of iterating agree with each other and with `operator[]`
+template <std::size_t Dim, class T>
+void checkConsistent(ufo::MultiIndexIterator<Dim, T> const& r)
+{
+	auto const v = viaIterators(r);
+	REQUIRE(r.size() == v.size());
+	REQUIRE(v == viaForEach(r));
+	REQUIRE(v == viaSplit(r));
+	for (std::size_t i{}; v.size() != i; ++i) {
+		REQUIRE(v[i] == r[i]);
+	}
+}
+}  // namespace
+
+TEST_CASE("MultiIndexIterator")
+{
+	using namespace ufo;
+
+	using Index2 = std::array<int, 2>;
+	using Index3 = std::array<int, 3>;
+
+	SECTION("Row-major")
+	{
+		MultiIndexIterator<3, int> r({1, -2, 3}, {4, 2, 8});
+		REQUIRE(3 * 4 * 5 == r.size());
+
+		std::vector<Index3> expected;
+		for (int i = 1; 4 != i; ++i) {
+			for (int j = -2; 2 != j; ++j) {
+				for (int k = 3; 8 != k; ++k) {
+					expected.push_back({i, j, k});
+				}
+			}
+		}
+		REQUIRE(expected == viaIterators(r));
+		checkConsistent(r);
+
+		MultiIndexIterator<1, int> line({5}, {9});
+		REQUIRE((std::vector<std::array<int, 1>>{{5}, {6}, {7}, {8}} == viaForEach(line)));
+	}
+
+	SECTION("Empty")
+	{
+		MultiIndexIterator<2, int> r({0, 5}, {4, 5});
+		REQUIRE(r.empty());
+		REQUIRE(viaForEach(r).empty());
+		REQUIRE(r.begin() == r.end());
+
+		MultiIndexIterator<2, int> inverted({3, 0}, {0, 4});
+		REQUIRE(inverted.empty());
+	}
+
+	SECTION("Tiled")
+	{
+		// Extents that are not multiples of the tile leave partial tiles at the border
+		Index2 const               first{0, 0};
+		Index2 const               last{10, 7};
+		MultiIndexIterator<2, int> r(first, last, TraversalOrder::TILED, {4, 3});
+		auto const                 v = viaIterators(r);
+		REQUIRE(coversBox(v, first, last));
+		checkConsistent(r);
+
+		// The first tile is finished before the next one is started
+		REQUIRE((std::vector<Index2>{{0, 0}, {0, 1}, {0, 2}, {1, 0}} ==
+		         std::vector<Index2>(v.begin(), v.begin() + 4)));
+		REQUIRE((Index2{3, 2} == v[11]));
+		REQUIRE((Index2{0, 3} == v[12]));
+		// The last tile along the second dimension is one wide
+		REQUIRE((Index2{0, 6} == v[24]));
+		REQUIRE((Index2{1, 6} == v[25]));
+
+		MultiIndexIterator<3, int> cube({-3, 0, 2}, {3, 5, 9}, TraversalOrder::TILED,
+		                                {4, 2, 3}, 5);
+		REQUIRE(coversBox(viaIterators(cube), Index3{-3, 0, 2}, Index3{3, 5, 9}));
+		checkConsistent(cube);
+	}
+
+	SECTION("Morton")
+	{
+		MultiIndexIterator<2, int> r({2, 4}, {10, 12}, TraversalOrder::MORTON);
+		auto const                 v = viaIterators(r);
+		REQUIRE(coversBox(v, Index2{2, 4}, Index2{10, 12}));
+		checkConsistent(r);
+		REQUIRE((std::vector<Index2>{{2, 4}, {2, 5}, {3, 4}, {3, 5}, {2, 6}} ==
+		         std::vector<Index2>(v.begin(), v.begin() + 5)));
+
+		MultiIndexIterator<3, int> cube({0, 0, 0}, {4, 4, 4}, TraversalOrder::MORTON);
+		REQUIRE(coversBox(viaIterators(cube), Index3{}, Index3{4, 4, 4}));
+		REQUIRE((Index3{0, 0, 1} == cube[1]));
+		REQUIRE((Index3{1, 0, 0} == cube[4]));
+
+		// Dimensions without a Morton specialization use the generic bit interleaving
+		using Index4 = std::array<int, 4>;
+		MultiIndexIterator<4, int> hyper({}, {4, 4, 4, 4}, TraversalOrder::MORTON);
+		auto const                 h = viaIterators(hyper);
+		REQUIRE(coversBox(h, Index4{}, Index4{4, 4, 4, 4}));
+		REQUIRE((Index4{0, 0, 0, 1} == h[1]));
+		REQUIRE((Index4{1, 0, 0, 0} == h[8]));
+		REQUIRE((Index4{0, 0, 0, 2} == h[16]));
+	}
+
+	SECTION("Hilbert")
+	{
+		for (int n : {1, 2, 8, 16}) {
+			MultiIndexIterator<2, int> r({0, 0}, {n, n}, TraversalOrder::HILBERT);
+			auto const                 v = viaIterators(r);
+			REQUIRE(coversBox(v, Index2{}, Index2{n, n}));
+			checkConsistent(r);
+			for (std::size_t i = 1; v.size() > i; ++i) {
+				REQUIRE(1 == std::abs(v[i][0] - v[i - 1][0]) + std::abs(v[i][1] - v[i - 1][1]));
+			}
+		}
+
+		MultiIndexIterator<3, int> cube({1, 1, 1}, {9, 9, 9}, TraversalOrder::HILBERT);
+		auto const                 v = viaIterators(cube);
+		REQUIRE(coversBox(v, Index3{1, 1, 1}, Index3{9, 9, 9}));
+		for (std::size_t i = 1; v.size() > i; ++i) {
+			int dist{};
+			for (std::size_t d{}; 3 != d; ++d) {
+				dist += std::abs(v[i][d] - v[i - 1][d]);
+			}
+			REQUIRE(1 == dist);
+		}
+	}
+
+	SECTION("Parallel for")
+	{
+		for (auto order : {TraversalOrder::ROW_MAJOR, TraversalOrder::TILED,
+		                   TraversalOrder::MORTON, TraversalOrder::HILBERT}) {
+			std::vector<int> hits(16 * 16);
+			parallel_for(MultiIndexIterator<2, int>({0, 0}, {16, 16}, order, {5, 3}, 7),
+			             [&hits](Index2 const& i) { ++hits[16 * i[0] + i[1]]; });
+			REQUIRE(std::all_of(hits.begin(), hits.end(), [](int h) { return 1 == h; }));
+		}
+	}
+}
@@ -0,0 +1,99 @@
+// UFO
+#include <ufo/utility/aligned_vector.hpp>
+#include <ufo/utility/cache_line.hpp>
+#include <ufo/utility/per_thread.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("PerThread")
+{
+	using namespace ufo;
+
+	SECTION("Cache aligned")
+	{
+		STATIC_REQUIRE(CACHE_LINE_SIZE == alignof(CacheAligned<char>));
+		STATIC_REQUIRE(0 == sizeof(CacheAligned<char>) % CACHE_LINE_SIZE);
+
+		CacheAligned<int> a[2]{1, 2};
+		REQUIRE(CACHE_LINE_SIZE <= reinterpret_cast<std::uintptr_t>(&a[1]) -
+		                               reinterpret_cast<std::uintptr_t>(&a[0]));
+		REQUIRE(2 == *a[1]);
+	}
+
+	SECTION("Aligned vector")
+	{
+		AlignedVector<float> v(3);
+		REQUIRE(0 == reinterpret_cast<std::uintptr_t>(v.data()) % CACHE_LINE_SIZE);
+		AlignedVector<double, 32> w(100);
+		REQUIRE(0 == reinterpret_cast<std::uintptr_t>(w.data()) % 32);
+	}
+
+	SECTION("Thread index")
+	{
+		std::size_t const main = threadIndex();
+		REQUIRE(main == threadIndex());
+
+		std::size_t other{};
+		std::thread([&other] { other = threadIndex(); }).join();
+		REQUIRE(main != other);
+	}
+
+	SECTION("Combine")
+	{
+		PerThread<int> counts(10);
+		// Nothing used yet
+		REQUIRE(10 == counts.combine(std::plus<>{}));
+
+		std::vector<std::thread> threads;
+		for (int t{}; 4 != t; ++t) {
+			threads.emplace_back([&counts] {
+				for (int i{}; 1000 != i; ++i) {
+					++counts.local();
+				}
+			});
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		// Each used slot starts at 10, unused slots are not folded in
+		int used{};
+		counts.combineEach([&used](int x) {
+			REQUIRE(0 == (x - 10) % 1000);
+			++used;
+		});
+		REQUIRE(1 <= used);
+		REQUIRE(4 >= used);
+		REQUIRE(4000 + 10 * used == counts.combine(std::plus<>{}));
+		REQUIRE(4000 + 10 * used == counts.combine(std::plus<>{}, 0));
+
+		counts.clear();
+		REQUIRE(10 == counts.combine(std::plus<>{}));
+		counts.local() += 5;
+		REQUIRE(15 == counts.combine(std::plus<>{}));
+	}
+
+	SECTION("Many threads")
+	{
+		PerThread<std::set<int>> seen;
+		std::vector<std::thread> threads;
+		for (int t{}; 40 != t; ++t) {
+			threads.emplace_back([&seen, t] { seen.local().insert(t); });
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		std::set<int> all;
+		seen.combineEach([&all](std::set<int> const& s) { all.insert(s.begin(), s.end()); });
+		REQUIRE(40 == all.size());
+	}
+}
@@ -0,0 +1,118 @@
+// UFO
+#include <ufo/utility/permutation.hpp>
+#include <ufo/utility/span.hpp>
+#include <ufo/utility/tuple_iterator.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+template <class Keys>
+std::vector<std::size_t> stableSortedIndices(Keys const& keys)
+{
+	std::vector<std::size_t> perm(keys.size());
+	std::iota(perm.begin(), perm.end(), std::size_t(0));
+	std::stable_sort(perm.begin(), perm.end(),
+	                 [&keys](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+	return perm;
+}
+}  // namespace
+
+TEST_CASE("Permutation")
+{
+	using namespace ufo;
+
+	std::mt19937 gen(42);
+
+	SECTION("Sort permutation")
+	{
+		// Few distinct keys, so stability matters, and enough of them for the radix sort
+		for (std::size_t n : {0, 1, 50, 1000, 100000}) {
+			std::vector<std::uint32_t> keys(n);
+			for (auto& k : keys) {
+				k = gen() % 97;
+			}
+			REQUIRE(stableSortedIndices(keys) == sortPermutation(keys));
+		}
+
+		std::vector<int> signed_keys(5000);
+		for (auto& k : signed_keys) {
+			k = static_cast<int>(gen() % 2001) - 1000;
+		}
+		REQUIRE(stableSortedIndices(signed_keys) == sortPermutation(signed_keys));
+
+		std::vector<std::string> words{"pear", "apple", "fig", "apple", "banana", "fig"};
+		REQUIRE((std::vector<std::size_t>{1, 3, 4, 2, 5, 0} == sortPermutation(words)));
+
+		// The output is resized
+		std::vector<std::size_t> perm(3, 99);
+		sortPermutation(std::vector<double>{2.5, -1.0}, perm);
+		REQUIRE((std::vector<std::size_t>{1, 0} == perm));
+	}
+
+	SECTION("Apply permutation")
+	{
+		std::vector<std::string>       v{"a", "b", "c", "d"};
+		std::vector<std::size_t> const perm{2, 0, 3, 1};
+		applyPermutation(v, Span<std::size_t const>(perm.data(), perm.size()));
+		REQUIRE((std::vector<std::string>{"c", "a", "d", "b"} == v));
+
+		// Move-only elements
+		std::vector<std::unique_ptr<int>> p;
+		for (int i{}; 4 != i; ++i) {
+			p.push_back(std::make_unique<int>(i));
+		}
+		applyPermutation(p, Span<std::size_t const>(perm.data(), perm.size()));
+		REQUIRE(2 == *p[0]);
+		REQUIRE(1 == *p[3]);
+
+		std::vector<int> large(20000);
+		std::iota(large.begin(), large.end(), 0);
+		std::vector<std::size_t> rev(large.size());
+		std::iota(rev.rbegin(), rev.rend(), std::size_t(0));
+		applyPermutation(large, Span<std::size_t const>(rev.data(), rev.size()));
+		REQUIRE(std::is_sorted(large.rbegin(), large.rend()));
+	}
+
+	SECTION("Sort by key")
+	{
+		std::vector<std::uint64_t> codes(3000);
+		std::vector<int>           ids(codes.size());
+		std::vector<std::string>   names(codes.size());
+		for (std::size_t i{}; codes.size() != i; ++i) {
+			codes[i] = gen() % 500;
+			ids[i]   = static_cast<int>(i);
+			names[i] = std::to_string(i);
+		}
+		auto const expected = stableSortedIndices(codes);
+
+		TupleIterator<std::vector<std::uint64_t>, std::vector<int>,
+		              std::vector<std::string>>
+		    zip(codes, ids, names);
+		sortByKey<0>(zip);
+
+		REQUIRE(std::is_sorted(codes.begin(), codes.end()));
+		for (std::size_t i{}; codes.size() != i; ++i) {
+			REQUIRE(static_cast<int>(expected[i]) == ids[i]);
+			REQUIRE(std::to_string(expected[i]) == names[i]);
+		}
+
+		// Sorting by a non-arithmetic column
+		sortByKey<2>(zip);
+		REQUIRE(std::is_sorted(names.begin(), names.end()));
+		for (std::size_t i{}; codes.size() != i; ++i) {
+			REQUIRE(std::to_string(ids[i]) == names[i]);
+		}
+	}
+}
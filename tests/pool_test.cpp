@@ -0,0 +1,297 @@
+// UFO
+#include <ufo/utility/monotonic_arena.hpp>
+#include <ufo/utility/pool.hpp>
+#include <ufo/utility/resource_allocator.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Upstream resource counting the calls and bytes it sees
+class CountingResource final : public std::pmr::memory_resource
+{
+ public:
+	std::size_t allocations{};
+	std::size_t deallocations{};
+	std::size_t bytes{};
+
+ protected:
+	void* do_allocate(std::size_t n, std::size_t alignment) override
+	{
+		++allocations;
+		bytes += n;
+		return std::pmr::new_delete_resource()->allocate(n, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t n, std::size_t alignment) override
+	{
+		++deallocations;
+		bytes -= n;
+		std::pmr::new_delete_resource()->deallocate(p, n, alignment);
+	}
+
+	bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+
+bool aligned(void const* p, std::size_t alignment)
+{
+	return 0 == reinterpret_cast<std::uintptr_t>(p) % alignment;
+}
+
+struct Throws {
+	explicit Throws(bool fail)
+	{
+		if (fail) {
+			throw std::runtime_error("Throws");
+		}
+	}
+};
+}  // namespace
+
+TEST_CASE("MonotonicArena")
+{
+	using namespace ufo;
+
+	CountingResource upstream;
+
+	SECTION("Allocate and reset")
+	{
+		MonotonicArena arena(256, &upstream);
+		REQUIRE(0 == upstream.allocations);
+
+		void* a = arena.allocate(10, 1);
+		void* b = arena.allocate(24, 8);
+		void* c = arena.allocate(64, 64);
+		REQUIRE(aligned(b, 8));
+		REQUIRE(aligned(c, 64));
+		REQUIRE(static_cast<char*>(a) + 10 <= static_cast<char*>(b));
+		REQUIRE(98 == arena.used());
+		REQUIRE(1 == upstream.allocations);
+
+		// Deallocating does nothing
+		arena.deallocate(b, 24, 8);
+		REQUIRE(98 == arena.used());
+
+		arena.reset();
+		REQUIRE(0 == arena.used());
+		REQUIRE(a == arena.allocate(10, 1));
+		REQUIRE(1 == upstream.allocations);
+	}
+
+	SECTION("Reset merges blocks")
+	{
+		MonotonicArena arena(128, &upstream);
+		for (int i{}; 100 != i; ++i) {
+			(void)arena.allocate(40, 8);
+		}
+		REQUIRE(1 < upstream.allocations);
+		REQUIRE(4000 <= arena.capacity());
+
+		std::size_t const capacity = arena.capacity();
+		arena.reset();
+		REQUIRE(capacity <= arena.capacity());
+		REQUIRE(1 == upstream.allocations - upstream.deallocations);
+
+		// The next round fits in the single merged block
+		std::size_t const before = upstream.allocations;
+		for (int i{}; 100 != i; ++i) {
+			(void)arena.allocate(40, 8);
+		}
+		REQUIRE(before == upstream.allocations);
+	}
+
+	SECTION("Large allocations and release")
+	{
+		{
+			MonotonicArena arena(64, &upstream);
+			void*          p = arena.allocate(10000, 16);
+			REQUIRE(aligned(p, 16));
+			REQUIRE(10000 <= arena.capacity());
+
+			auto* v = arena.create<std::uint64_t>(42u);
+			REQUIRE(42 == *v);
+			REQUIRE(aligned(v, alignof(std::uint64_t)));
+
+			arena.release();
+			REQUIRE(0 == arena.capacity());
+			REQUIRE(0 == upstream.bytes);
+			(void)arena.allocate(8, 8);
+		}
+		// The destructor gives everything back
+		REQUIRE(0 == upstream.bytes);
+		REQUIRE(upstream.allocations == upstream.deallocations);
+	}
+
+	SECTION("Allocator")
+	{
+		MonotonicArena arena(1024, &upstream);
+		std::vector<int, ResourceAllocator<int, MonotonicArena>> v(arena);
+		for (int i{}; 1000 != i; ++i) {
+			v.push_back(i);
+		}
+		REQUIRE(999 == v.back());
+		REQUIRE(&arena == v.get_allocator().resource());
+
+		std::pmr::vector<int> pv(&arena);
+		pv.assign(100, 7);
+		REQUIRE(7 == pv[99]);
+	}
+}
+
+TEST_CASE("Pools")
+{
+	using namespace ufo;
+
+	CountingResource upstream;
+
+	SECTION("Pool resource")
+	{
+		{
+			PoolResource pool(24, 8, 4, &upstream);
+			REQUIRE(24 == pool.blockSize());
+
+			std::vector<void*> blocks;
+			for (int i{}; 10 != i; ++i) {
+				blocks.push_back(pool.allocate(24, 8));
+				REQUIRE(aligned(blocks.back(), 8));
+			}
+			REQUIRE(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+			std::size_t const slabs = upstream.allocations;
+			// Slabs of 4 and then 8 blocks
+			REQUIRE(2 == slabs);
+
+			// Freed blocks are reused without going upstream
+			for (void* p : blocks) {
+				pool.deallocate(p, 24, 8);
+			}
+			for (int i{}; 10 != i; ++i) {
+				(void)pool.allocate(16, 8);
+			}
+			REQUIRE(slabs == upstream.allocations);
+
+			// Too large or too aligned go upstream
+			void* big = pool.allocate(100, 8);
+			REQUIRE(slabs + 1 == upstream.allocations);
+			pool.deallocate(big, 100, 8);
+			void* wide = pool.allocate(8, 64);
+			REQUIRE(aligned(wide, 64));
+			pool.deallocate(wide, 8, 64);
+			REQUIRE(slabs + 2 == upstream.allocations);
+		}
+		REQUIRE(0 == upstream.bytes);
+	}
+
+	SECTION("Object pool")
+	{
+		ObjectPool<std::uint64_t> pool(8, &upstream);
+		auto*                     a = pool.create(1u);
+		auto*                     b = pool.create(2u);
+		REQUIRE(1 == *a);
+		REQUIRE(2 == *b);
+		pool.destroy(a);
+		REQUIRE(a == pool.create(3u));
+
+		ObjectPool<Throws> throwing(8, &upstream);
+		REQUIRE_THROWS_AS(throwing.create(true), std::runtime_error);
+		// The block of the failed construction was given back
+		Throws* t = throwing.create(false);
+		REQUIRE(nullptr != t);
+		throwing.destroy(t);
+	}
+
+	SECTION("Node containers")
+	{
+		PoolResource pool(64, alignof(std::max_align_t), 64, &upstream);
+		{
+			using MapAllocator = ResourceAllocator<std::pair<int const, int>, PoolResource>;
+
+			std::list<int, ResourceAllocator<int, PoolResource>> l(pool);
+			std::map<int, int, std::less<>, MapAllocator>        m(pool);
+			for (int i{}; 1000 != i; ++i) {
+				l.push_back(i);
+				m[i] = i;
+			}
+			REQUIRE(1000 == l.size());
+			REQUIRE(999 == m.rbegin()->second);
+
+			std::size_t const before = upstream.allocations;
+			l.clear();
+			m.clear();
+			for (int i{}; 1000 != i; ++i) {
+				l.push_back(i);
+			}
+			REQUIRE(before == upstream.allocations);
+		}
+		pool.release();
+		REQUIRE(0 == upstream.bytes);
+	}
+
+	SECTION("Thread cached pool")
+	{
+		ThreadCachedPool pool(32, 16, 8);
+		REQUIRE(32 == pool.blockSize());
+
+		// Blocks are freed by other threads than the ones allocating them
+		std::vector<std::vector<void*>> blocks(4);
+		std::vector<std::thread>        threads;
+		for (std::size_t t{}; blocks.size() != t; ++t) {
+			threads.emplace_back([&pool, &blocks, t] {
+				for (int i{}; 1000 != i; ++i) {
+					void* p = pool.allocate(32, 16);
+					*static_cast<std::size_t*>(p) = t;
+					blocks[t].push_back(p);
+				}
+			});
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+		threads.clear();
+
+		std::set<void*> unique;
+		for (auto const& b : blocks) {
+			unique.insert(b.begin(), b.end());
+		}
+		REQUIRE(4000 == unique.size());
+		for (std::size_t t{}; blocks.size() != t; ++t) {
+			for (void* p : blocks[t]) {
+				REQUIRE(aligned(p, 16));
+				REQUIRE(t == *static_cast<std::size_t*>(p));
+			}
+		}
+
+		for (std::size_t t{}; blocks.size() != t; ++t) {
+			threads.emplace_back([&pool, &blocks, t] {
+				for (void* p : blocks[(t + 1) % blocks.size()]) {
+					pool.deallocate(p, 32, 16);
+				}
+				for (int i{}; 1000 != i; ++i) {
+					pool.deallocate(pool.allocate(32, 16), 32, 16);
+				}
+			});
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		void* big = pool.allocate(1000, 16);
+		pool.deallocate(big, 1000, 16);
+	}
+}
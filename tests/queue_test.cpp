@@ -0,0 +1,330 @@
+// UFO
+#include <ufo/utility/mpmc_queue.hpp>
+#include <ufo/utility/spsc_queue.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Nothrow movable, but the copy constructor throws once `throw_after` more copies have
+// been made
+struct Throwing {
+	static inline int live{};
+	static inline int throw_after = -1;
+
+	int value;
+
+	explicit Throwing(int v) noexcept : value(v) { ++live; }
+
+	Throwing(Throwing const& other) : value(other.value)
+	{
+		if (0 == throw_after--) {
+			throw std::runtime_error("Throwing");
+		}
+		++live;
+	}
+
+	Throwing(Throwing&& other) noexcept : value(other.value) { ++live; }
+
+	Throwing& operator=(Throwing const&) = default;
+	Throwing& operator=(Throwing&&)      = default;
+
+	~Throwing() { --live; }
+};
+}  // namespace
+
+TEST_CASE("MPMCQueue")
+{
+	using namespace ufo;
+
+	SECTION("Capacity")
+	{
+		REQUIRE(2 == MPMCQueue<int>(0).capacity());
+		REQUIRE(2 == MPMCQueue<int>(1).capacity());
+		REQUIRE(8 == MPMCQueue<int>(5).capacity());
+		REQUIRE(8 == MPMCQueue<int>(8).capacity());
+	}
+
+	SECTION("Push and pop")
+	{
+		MPMCQueue<int> q(4);
+		int            v{};
+		REQUIRE(q.empty());
+		REQUIRE(!q.tryPop(v));
+
+		// Wrap around a few times
+		for (int lap{}; 3 != lap; ++lap) {
+			for (int i{}; 4 != i; ++i) {
+				REQUIRE(q.tryPush(10 * lap + i));
+			}
+			REQUIRE(!q.tryPush(-1));
+			REQUIRE(4 == q.size());
+			for (int i{}; 4 != i; ++i) {
+				REQUIRE(q.tryPop(v));
+				REQUIRE(10 * lap + i == v);
+			}
+			REQUIRE(q.empty());
+		}
+	}
+
+	SECTION("Bulk")
+	{
+		MPMCQueue<int>   q(8);
+		std::vector<int> in(10);
+		std::iota(in.begin(), in.end(), 0);
+
+		REQUIRE(q.tryPush(-1));
+		REQUIRE(7 == q.tryPushBulk(in.begin(), in.size()));
+		REQUIRE(0 == q.tryPushBulk(in.begin(), in.size()));
+
+		std::vector<int> out(10, -2);
+		REQUIRE(8 == q.tryPopBulk(out.begin(), out.size()));
+		REQUIRE(-1 == out[0]);
+		for (int i{}; 7 != i; ++i) {
+			REQUIRE(i == out[i + 1]);
+		}
+		REQUIRE(-2 == out[8]);
+		REQUIRE(0 == q.tryPopBulk(out.begin(), out.size()));
+	}
+
+	SECTION("Remaining elements are destroyed")
+	{
+		MPMCQueue<std::unique_ptr<int>> q(4);
+		REQUIRE(q.tryPush(std::make_unique<int>(1)));
+		REQUIRE(q.tryEmplace(new int(2)));
+		REQUIRE(q.tryPush(std::make_unique<int>(3)));
+
+		std::unique_ptr<int> p;
+		REQUIRE(q.tryPop(p));
+		REQUIRE(1 == *p);
+	}
+
+	SECTION("Throwing copies")
+	{
+		{
+			MPMCQueue<Throwing> q(4);
+			Throwing const      a(1);
+
+			Throwing::throw_after = 0;
+			REQUIRE_THROWS_AS(q.tryPush(a), std::runtime_error);
+			Throwing::throw_after = 0;
+			REQUIRE_THROWS_AS(q.push(a), std::runtime_error);
+			Throwing::throw_after = -1;
+			REQUIRE(q.empty());
+
+			// The queue still works, and nothing was left half constructed
+			REQUIRE(q.tryPush(Throwing(2)));
+			Throwing v(0);
+			REQUIRE(q.tryPop(v));
+			REQUIRE(2 == v.value);
+			REQUIRE(!q.tryPop(v));
+
+			std::vector<Throwing> in;
+			for (int i{}; 4 != i; ++i) {
+				in.emplace_back(10 + i);
+			}
+			Throwing::throw_after = 2;
+			REQUIRE_THROWS_AS(q.tryPushBulk(in.begin(), in.size()), std::runtime_error);
+			Throwing::throw_after = -1;
+			REQUIRE(2 == q.size());
+			REQUIRE(q.tryPush(a));
+			for (int expected : {10, 11, 1}) {
+				REQUIRE(q.tryPop(v));
+				REQUIRE(expected == v.value);
+			}
+			REQUIRE(!q.tryPop(v));
+
+			REQUIRE(q.tryPush(a));
+		}
+		REQUIRE(0 == Throwing::live);
+	}
+
+	SECTION("Concurrent producers and consumers")
+	{
+		MPMCQueue<std::uint64_t> q(64);
+		constexpr std::uint64_t  N = 20000;
+
+		std::vector<std::thread>   threads;
+		std::vector<std::uint64_t> sums(2);
+		for (std::uint64_t t{}; 2 != t; ++t) {
+			threads.emplace_back([&q, t] {
+				std::vector<std::uint64_t> batch(7);
+				for (std::uint64_t i = t * N; (t + 1) * N != i;) {
+					if (i % 3) {
+						q.push(i++);
+						continue;
+					}
+					std::size_t const n = static_cast<std::size_t>(
+					    std::min<std::uint64_t>(batch.size(), (t + 1) * N - i));
+					std::iota(batch.begin(), batch.begin() + n, i);
+					std::size_t pushed{};
+					while (n != pushed) {
+						pushed += q.tryPushBulk(batch.begin() + pushed, n - pushed);
+					}
+					i += n;
+				}
+			});
+		}
+		for (std::size_t t{}; 2 != t; ++t) {
+			threads.emplace_back([&q, &sums, t] {
+				std::vector<std::uint64_t> batch(5);
+				for (std::uint64_t count{}; N != count;) {
+					if (count % 2) {
+						std::uint64_t v;
+						q.pop(v);
+						sums[t] += v;
+						++count;
+						continue;
+					}
+					std::size_t const n =
+					    q.tryPopBulk(batch.begin(), std::min<std::uint64_t>(5, N - count));
+					sums[t] += std::accumulate(batch.begin(), batch.begin() + n,
+					                           std::uint64_t(0));
+					count += n;
+				}
+			});
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		REQUIRE((2 * N - 1) * 2 * N / 2 == sums[0] + sums[1]);
+		REQUIRE(q.empty());
+	}
+}
+
+TEST_CASE("SPSCQueue")
+{
+	using namespace ufo;
+
+	SECTION("Push and pop")
+	{
+		SPSCQueue<int> q(3);
+		REQUIRE(4 == q.capacity());
+		REQUIRE(nullptr == q.front());
+
+		for (int lap{}; 3 != lap; ++lap) {
+			for (int i{}; 4 != i; ++i) {
+				REQUIRE(q.tryPush(10 * lap + i));
+			}
+			REQUIRE(!q.tryPush(-1));
+			REQUIRE(4 == q.size());
+
+			REQUIRE(10 * lap == *q.front());
+			q.popFront();
+			int v{};
+			for (int i = 1; 4 != i; ++i) {
+				REQUIRE(q.tryPop(v));
+				REQUIRE(10 * lap + i == v);
+			}
+			REQUIRE(!q.tryPop(v));
+			REQUIRE(q.empty());
+		}
+	}
+
+	SECTION("Bulk")
+	{
+		SPSCQueue<int>   q(8);
+		std::vector<int> in(10);
+		std::iota(in.begin(), in.end(), 0);
+
+		REQUIRE(8 == q.tryPushBulk(in.begin(), in.size()));
+		REQUIRE(0 == q.tryPushBulk(in.begin(), in.size()));
+
+		std::vector<int> out(3);
+		REQUIRE(3 == q.tryPopBulk(out.begin(), out.size()));
+		REQUIRE(std::vector<int>{0, 1, 2} == out);
+		REQUIRE(3 == q.tryPushBulk(in.begin(), in.size()));
+
+		out.assign(10, -1);
+		REQUIRE(8 == q.tryPopBulk(out.begin(), out.size()));
+		REQUIRE(std::vector<int>{3, 4, 5, 6, 7, 0, 1, 2, -1, -1} == out);
+	}
+
+	SECTION("Remaining elements are destroyed")
+	{
+		SPSCQueue<std::unique_ptr<int>> q(4);
+		REQUIRE(q.tryPush(std::make_unique<int>(1)));
+		REQUIRE(q.tryEmplace(new int(2)));
+
+		std::unique_ptr<int> p;
+		REQUIRE(q.tryPop(p));
+		REQUIRE(1 == *p);
+	}
+
+	SECTION("Throwing copies")
+	{
+		{
+			SPSCQueue<Throwing>   q(8);
+			std::vector<Throwing> in;
+			for (int i{}; 5 != i; ++i) {
+				in.emplace_back(i);
+			}
+
+			// The elements copied before the throw are destroyed and none are pushed
+			Throwing::throw_after = 3;
+			REQUIRE_THROWS_AS(q.tryPushBulk(in.begin(), in.size()), std::runtime_error);
+			Throwing::throw_after = -1;
+			REQUIRE(q.empty());
+			REQUIRE(5 == Throwing::live);
+
+			REQUIRE(5 == q.tryPushBulk(in.begin(), in.size()));
+			Throwing v(0);
+			for (int i{}; 5 != i; ++i) {
+				REQUIRE(q.tryPop(v));
+				REQUIRE(i == v.value);
+			}
+			REQUIRE(q.tryPush(v));
+		}
+		REQUIRE(0 == Throwing::live);
+	}
+
+	SECTION("Producer and consumer")
+	{
+		SPSCQueue<std::uint64_t> q(16);
+		constexpr std::uint64_t  N = 100000;
+
+		std::thread producer([&q] {
+			std::vector<std::uint64_t> batch(6);
+			for (std::uint64_t i{}; N != i;) {
+				if (i % 2) {
+					q.push(i++);
+					continue;
+				}
+				std::size_t const n = static_cast<std::size_t>(
+				    std::min<std::uint64_t>(batch.size(), N - i));
+				std::iota(batch.begin(), batch.begin() + n, i);
+				i += q.tryPushBulk(batch.begin(), n);
+			}
+		});
+
+		bool                       ordered = true;
+		std::vector<std::uint64_t> batch(4);
+		for (std::uint64_t next{}; N != next;) {
+			std::size_t const n = q.tryPopBulk(batch.begin(), batch.size());
+			for (std::size_t i{}; n != i; ++i) {
+				ordered = ordered && next++ == batch[i];
+			}
+			if (N != next) {
+				std::uint64_t v;
+				q.pop(v);
+				ordered = ordered && next++ == v;
+			}
+		}
+		producer.join();
+
+		REQUIRE(ordered);
+		REQUIRE(q.empty());
+	}
+}
@@ -0,0 +1,154 @@
+// UFO
+#include <ufo/utility/radix_sort.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Radix sort")
+{
+	using namespace ufo;
+
+	std::mt19937_64 gen(42);
+
+	SECTION("Unsigned")
+	{
+		for (std::size_t n : {0, 1, 64, 65, 1000, 200000}) {
+			std::vector<std::uint64_t> v(n);
+			for (auto& x : v) {
+				x = gen();
+			}
+			auto expected = v;
+			std::sort(expected.begin(), expected.end());
+
+			radixSort(v);
+			REQUIRE(expected == v);
+		}
+	}
+
+	SECTION("Digit widths")
+	{
+		std::vector<std::uint32_t> v(50000);
+		for (auto& x : v) {
+			x = static_cast<std::uint32_t>(gen());
+		}
+		auto expected = v;
+		std::sort(expected.begin(), expected.end());
+
+		auto a = v;
+		auto b = v;
+		auto c = v;
+		radixSort<11>(a);
+		radixSort<16>(b);
+		radixSort<1>(c);
+		REQUIRE(expected == a);
+		REQUIRE(expected == b);
+		REQUIRE(expected == c);
+	}
+
+	SECTION("Signed and floating point")
+	{
+		std::vector<std::int16_t> s(10000);
+		for (auto& x : s) {
+			x = static_cast<std::int16_t>(gen());
+		}
+		auto expected_s = s;
+		std::sort(expected_s.begin(), expected_s.end());
+		radixSort(s);
+		REQUIRE(expected_s == s);
+
+		std::normal_distribution<double> dist(0.0, 1e6);
+		std::vector<double>              d(10000);
+		for (auto& x : d) {
+			x = dist(gen);
+		}
+		d[0] = -std::numeric_limits<double>::infinity();
+		d[1] = std::numeric_limits<double>::infinity();
+		d[2] = 0.0;
+		auto expected_d = d;
+		std::sort(expected_d.begin(), expected_d.end());
+		radixSort(d);
+		REQUIRE(expected_d == d);
+
+		// -0 sorts before +0
+		std::vector<float> z(100, 0.0f);
+		z[70] = -0.0f;
+		radixSort(z);
+		REQUIRE(std::signbit(z[0]));
+		REQUIRE(!std::signbit(z[1]));
+	}
+
+	SECTION("Skipped digits")
+	{
+		// Only the bits 8-15 differ, so a single pass is needed
+		std::vector<std::uint64_t> v(1000);
+		for (auto& x : v) {
+			x = 0xABCD000000000012ull | ((gen() & 0xFF) << 8);
+		}
+		auto expected = v;
+		std::sort(expected.begin(), expected.end());
+		radixSort(v);
+		REQUIRE(expected == v);
+
+		std::vector<std::uint32_t> same(1000, 7);
+		radixSort(same);
+		REQUIRE(std::all_of(same.begin(), same.end(), [](auto x) { return 7 == x; }));
+	}
+
+	SECTION("Records by key are stable")
+	{
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> v(30000);
+		for (std::uint32_t i{}; v.size() != i; ++i) {
+			v[i] = {static_cast<std::uint32_t>(gen() % 1000), i};
+		}
+		auto expected = v;
+		std::stable_sort(expected.begin(), expected.end(),
+		                 [](auto const& a, auto const& b) { return a.first < b.first; });
+
+		RadixSortBuffer<std::pair<std::uint32_t, std::uint32_t>> buffer;
+		radixSort(v, buffer, [](auto const& p) { return p.first; });
+		REQUIRE(expected == v);
+	}
+
+	SECTION("Sort by key")
+	{
+		RadixSortBuffer<std::uint64_t, std::size_t> buffer;
+		buffer.reserve(5000);
+
+		for (std::size_t n : {10, 5000, 20000}) {
+			std::vector<std::uint64_t> keys(n);
+			std::vector<std::size_t>   values(n);
+			for (auto& k : keys) {
+				k = gen() % 64;
+			}
+			std::iota(values.begin(), values.end(), std::size_t(0));
+
+			std::vector<std::size_t> expected(values);
+			std::stable_sort(
+			    expected.begin(), expected.end(),
+			    [&keys](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+			auto sorted_keys = keys;
+			std::sort(sorted_keys.begin(), sorted_keys.end());
+
+			radixSortByKey(keys, values, buffer);
+			REQUIRE(sorted_keys == keys);
+			REQUIRE(expected == values);
+		}
+
+		buffer.clear();
+		std::vector<std::uint8_t> keys{3, 1, 2, 1};
+		std::vector<char>         values{'d', 'b', 'c', 'a'};
+		radixSortByKey(keys, values);
+		REQUIRE((std::vector<char>{'b', 'a', 'c', 'd'} == values));
+	}
+}
@@ -0,0 +1,183 @@
+// UFO
+#include <ufo/utility/io/buffer.hpp>
+#include <ufo/utility/io/rans.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+void roundTrip(std::vector<std::uint8_t> const& data,
+               std::size_t                      block_size = ufo::RANS_BLOCK_SIZE)
+{
+	ufo::Buffer buffer;
+	ufo::ransEncode(data, buffer, block_size);
+	std::size_t const compressed = buffer.size();
+
+	REQUIRE(data.size() == ufo::ransDecodedSize(buffer));
+	std::vector<std::uint8_t> out(data.size(), 0xAB);
+	ufo::ransDecode(buffer, out);
+	REQUIRE(data == out);
+	REQUIRE(compressed == buffer.readPos());
+
+	// Decoding into a buffer
+	buffer.readPos(0);
+	ufo::Buffer decoded;
+	ufo::ransDecode(buffer, decoded);
+	REQUIRE(data.size() == decoded.size());
+	REQUIRE(std::equal(data.begin(), data.end(),
+	                   reinterpret_cast<std::uint8_t const*>(decoded.data())));
+}
+}  // namespace
+
+TEST_CASE("rANS")
+{
+	using namespace ufo;
+
+	std::mt19937 gen(42);
+
+	// Skewed, like child masks of a sparse tree
+	std::geometric_distribution<int> skewed(0.3);
+	std::vector<std::uint8_t>        data(100000);
+	for (auto& x : data) {
+		x = static_cast<std::uint8_t>(skewed(gen));
+	}
+
+	SECTION("Round trip")
+	{
+		roundTrip(data);
+
+		std::vector<std::uint8_t> uniform(50000);
+		for (auto& x : uniform) {
+			x = static_cast<std::uint8_t>(gen());
+		}
+		roundTrip(uniform);
+
+		// All 256 symbols, with most of them at the minimum frequency
+		std::vector<std::uint8_t> rare(data);
+		for (int s{}; 256 != s; ++s) {
+			rare[static_cast<std::size_t>(s) * 300] = static_cast<std::uint8_t>(s);
+		}
+		roundTrip(rare);
+	}
+
+	SECTION("Sizes and blocks")
+	{
+		// Lengths around the number of interleaved states
+		for (std::size_t n : {0, 1, 2, 7, 8, 9, 15, 16, 17, 100, 1001}) {
+			roundTrip(std::vector<std::uint8_t>(data.begin(), data.begin() + n));
+		}
+
+		for (std::size_t block_size : {1, 5, 8, 1000, 65536}) {
+			roundTrip(std::vector<std::uint8_t>(data.begin(), data.begin() + 20000),
+			          block_size);
+		}
+
+		roundTrip(std::vector<std::uint8_t>(5000, 0x42));
+		roundTrip(std::vector<std::uint8_t>(5000, 0xFF));
+	}
+
+	SECTION("Compression")
+	{
+		Buffer buffer;
+		ransEncode(data, buffer);
+		// The entropy of the data is about 2.9 bits per byte
+		REQUIRE(buffer.size() < data.size() * 3 / 8 + 1000);
+
+		std::vector<std::uint8_t> const same(100000, 7);
+		buffer.clear();
+		ransEncode(same, buffer);
+		REQUIRE(buffer.size() < 1000);
+	}
+
+	SECTION("From a buffer")
+	{
+		Buffer in;
+		in.write(std::uint32_t(0xDEADBEEF));
+		in.write(data.data(), 1000);
+		in.readSkip(sizeof(std::uint32_t));
+
+		Buffer out;
+		ransEncode(in, 1000, out);
+		REQUIRE(0 == in.readLeft());
+
+		std::vector<std::uint8_t> decoded(1000);
+		ransDecode(out, decoded);
+		REQUIRE(std::vector<std::uint8_t>(data.begin(), data.begin() + 1000) == decoded);
+
+		in.readPos(sizeof(std::uint32_t));
+		REQUIRE_THROWS_AS(ransEncode(in, 1001, out), std::out_of_range);
+		REQUIRE(sizeof(std::uint32_t) == in.readPos());
+	}
+
+	SECTION("Corrupt input")
+	{
+		std::vector<std::uint8_t> const part(data.begin(), data.begin() + 3000);
+
+		Buffer buffer;
+		ransEncode(part, buffer, 1000);
+
+		std::vector<std::uint8_t> out(part.size() - 1);
+		REQUIRE_THROWS_AS(ransDecode(buffer, out), std::out_of_range);
+
+		// Every truncation is detected
+		out.resize(part.size());
+		for (std::size_t n = 1; buffer.size() > n; n += 1 + n / 16) {
+			Buffer truncated;
+			truncated.write(buffer.data(), n);
+			REQUIRE_THROWS(ransDecode(truncated, out));
+		}
+
+		// A frequency table that does not sum to the scale
+		Buffer table;
+		table.write(std::uint64_t(10));
+		table.write(std::uint32_t(10));
+		for (int i{}; 64 != i; ++i) {
+			table.write(std::uint64_t(0x5555555555555555u));
+		}
+		out.resize(10);
+		REQUIRE_THROWS_AS(ransDecode(table, out), std::runtime_error);
+
+		Buffer header;
+		header.write(std::uint64_t(10));
+		header.write(std::uint32_t(0));
+		REQUIRE_THROWS_AS(ransDecode(header, out), std::runtime_error);
+
+		// A huge size is not allocated up front, and every truncation leaves the output
+		// buffer as it was
+		Buffer huge;
+		huge.write(std::uint64_t(1) << 40);
+		huge.write(std::uint32_t(0xFFFFFFFF));
+		Buffer decoded;
+		REQUIRE_THROWS(ransDecode(huge, decoded));
+		REQUIRE(0 == decoded.size());
+
+		for (std::size_t n = 1; buffer.size() > n; n += 1 + n / 16) {
+			Buffer truncated;
+			truncated.write(buffer.data(), n);
+			decoded.write(std::uint64_t(1));
+			REQUIRE_THROWS(ransDecode(truncated, decoded));
+			REQUIRE(sizeof(std::uint64_t) == decoded.size());
+			decoded.clear();
+		}
+
+		// Flipped bits in the coded words of the last block give wrong data, but are read
+		// in bounds
+		Buffer flipped;
+		flipped.write(buffer.data(), buffer.size());
+		for (std::size_t i = flipped.size() - 100; flipped.size() > i; i += 7) {
+			flipped.data()[i] ^= std::byte{0x10};
+		}
+		out.resize(part.size());
+		REQUIRE_NOTHROW(ransDecode(flipped, out));
+		REQUIRE(part != out);
+	}
+}
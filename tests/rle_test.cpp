@@ -0,0 +1,197 @@
+// UFO
+#include <ufo/utility/io/buffer.hpp>
+#include <ufo/utility/io/rle.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+// Runs of random length, alternating with stretches of random elements
+template <class T, class Gen>
+std::vector<T> runs(Gen& gen, std::size_t n)
+{
+	std::vector<T> v;
+	while (n > v.size()) {
+		std::size_t const len = std::min<std::size_t>(n - v.size(), gen() % 100);
+		if (gen() % 2) {
+			v.insert(v.end(), len, static_cast<T>(gen() % 3));
+		} else {
+			for (std::size_t i{}; len != i; ++i) {
+				v.push_back(static_cast<T>(gen()));
+			}
+		}
+	}
+	return v;
+}
+
+template <class T>
+void roundTrip(std::vector<T> const& data)
+{
+	ufo::Buffer buffer;
+	ufo::rleEncode<T>(data, buffer);
+	std::size_t const encoded = buffer.size();
+
+	REQUIRE(data.size() == ufo::rleDecodedSize(buffer));
+	std::vector<T> out(data.size(), T(0xAB));
+	ufo::rleDecode<T>(buffer, out);
+	REQUIRE(data == out);
+	REQUIRE(encoded == buffer.readPos());
+
+	// Appending to a buffer that already holds data
+	buffer.readPos(0);
+	ufo::Buffer decoded;
+	decoded.write(std::uint8_t(0x55));
+	ufo::rleDecode<T>(buffer, decoded);
+	REQUIRE(1 + data.size() * sizeof(T) == decoded.size());
+	REQUIRE(decoded.size() == decoded.writePos());
+	REQUIRE((data.empty() ||
+	         0 == std::memcmp(decoded.data() + 1, data.data(), data.size() * sizeof(T))));
+}
+
+template <class T, class Gen>
+void checkType(Gen& gen)
+{
+	for (std::size_t n : {0, 1, 2, 3, 4, 5, 31, 32, 33, 64, 1000, 100000}) {
+		roundTrip(runs<T>(gen, n));
+	}
+
+	// A single run, and no runs at all
+	roundTrip(std::vector<T>(12345, T(7)));
+	std::vector<T> ramp(5000);
+	for (std::size_t i{}; ramp.size() != i; ++i) {
+		ramp[i] = static_cast<T>(i);
+	}
+	roundTrip(ramp);
+
+	// Runs just long enough to be coded as runs, at every offset within a vector
+	for (std::size_t offset{}; 40 != offset; ++offset) {
+		std::vector<T> v = ramp;
+		v.resize(100);
+		std::fill_n(v.begin() + offset, 4, T(3));
+		roundTrip(v);
+	}
+}
+}  // namespace
+
+TEST_CASE("RLE")
+{
+	using namespace ufo;
+
+	std::mt19937_64 gen(42);
+
+	SECTION("Round trip")
+	{
+		checkType<std::uint8_t>(gen);
+		checkType<std::uint16_t>(gen);
+		checkType<std::uint32_t>(gen);
+		checkType<std::uint64_t>(gen);
+	}
+
+	SECTION("Compression")
+	{
+		std::vector<std::uint32_t> grid(1000000, 0x7FC00000u);
+		std::fill_n(grid.begin() + 500000, 1000, 0u);
+
+		Buffer buffer;
+		rleEncode<std::uint32_t>(grid, buffer);
+		REQUIRE(50 > buffer.size());
+
+		// Literals cost little more than the elements themselves
+		std::vector<std::uint8_t> random(10000);
+		for (auto& x : random) {
+			x = static_cast<std::uint8_t>(gen());
+		}
+		buffer.clear();
+		rleEncode<std::uint8_t>(random, buffer);
+		REQUIRE(random.size() + 100 > buffer.size());
+	}
+
+	SECTION("From a buffer")
+	{
+		std::vector<std::uint16_t> const data = runs<std::uint16_t>(gen, 500);
+
+		Buffer in;
+		in.write(std::uint8_t(1));
+		in.write(data.data(), data.size() * sizeof(std::uint16_t));
+		in.readSkip(1);
+
+		Buffer out;
+		rleEncode<std::uint16_t>(in, data.size(), out);
+		REQUIRE(0 == in.readLeft());
+
+		std::vector<std::uint16_t> decoded(data.size());
+		rleDecode<std::uint16_t>(out, decoded);
+		REQUIRE(data == decoded);
+
+		in.readPos(1);
+		REQUIRE_THROWS_AS(rleEncode<std::uint16_t>(in, data.size() + 1, out),
+		                  std::out_of_range);
+		REQUIRE(1 == in.readPos());
+	}
+
+	SECTION("Corrupt input")
+	{
+		std::vector<std::uint32_t> const data = runs<std::uint32_t>(gen, 3000);
+
+		Buffer buffer;
+		rleEncode<std::uint32_t>(data, buffer);
+
+		std::vector<std::uint32_t> out(data.size() - 1);
+		REQUIRE_THROWS_AS(rleDecode<std::uint32_t>(buffer, out), std::out_of_range);
+		buffer.readPos(0);
+		std::vector<std::uint16_t> wrong(2 * data.size());
+		REQUIRE_THROWS_AS(rleDecode<std::uint16_t>(buffer, wrong), std::invalid_argument);
+
+		// Every truncation is detected, and leaves the output buffer as it was
+		out.resize(data.size());
+		for (std::size_t n = 1; buffer.size() > n; n += 1 + n / 16) {
+			Buffer truncated;
+			truncated.write(buffer.data(), n);
+			REQUIRE_THROWS(rleDecode<std::uint32_t>(truncated, out));
+
+			truncated.readPos(0);
+			Buffer decoded;
+			decoded.write(std::uint64_t(1));
+			REQUIRE_THROWS(rleDecode<std::uint32_t>(truncated, decoded));
+			REQUIRE(sizeof(std::uint64_t) == decoded.size());
+		}
+
+		// A size that overflows the byte count
+		Buffer huge;
+		huge.write(std::uint64_t(1) << 62);
+		huge.write(std::uint8_t(sizeof(std::uint32_t)));
+		huge.write(buffer.data() + 9, buffer.size() - 9);
+		Buffer decoded;
+		REQUIRE_THROWS_AS(rleDecode<std::uint32_t>(huge, decoded), std::runtime_error);
+		REQUIRE(0 == decoded.size());
+
+		// Runs longer than the data
+		Buffer run;
+		run.write(std::uint64_t(4));
+		run.write(std::uint8_t(1));
+		run.write(std::uint8_t(0));
+		run.write(std::uint8_t(5));
+		run.write(std::uint8_t(9));
+		std::vector<std::uint8_t> bytes(4);
+		REQUIRE_THROWS_AS(rleDecode<std::uint8_t>(run, bytes), std::runtime_error);
+
+		// Varint that never ends
+		Buffer varint;
+		varint.write(std::uint64_t(4));
+		varint.write(std::uint8_t(1));
+		for (int i{}; 20 != i; ++i) {
+			varint.write(std::uint8_t(0xFF));
+		}
+		REQUIRE_THROWS_AS(rleDecode<std::uint8_t>(varint, bytes), std::runtime_error);
+	}
+}
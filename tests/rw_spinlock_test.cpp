@@ -0,0 +1,181 @@
+// UFO
+#include <ufo/utility/cache_line.hpp>
+#include <ufo/utility/rw_spinlock.hpp>
+#include <ufo/utility/seqlock.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+TEST_CASE("RWSpinlock")
+{
+	using namespace ufo;
+
+	STATIC_REQUIRE(CACHE_LINE_SIZE <= alignof(RWSpinlock));
+
+	SECTION("Readers share, writers are exclusive")
+	{
+		RWSpinlock lock;
+		REQUIRE(lock.try_lock_shared());
+		REQUIRE(lock.try_lock_shared());
+		REQUIRE(2 == lock.readers());
+		REQUIRE(!lock.try_lock());
+
+		lock.unlock_shared();
+		lock.unlock_shared();
+		REQUIRE(0 == lock.readers());
+
+		REQUIRE(lock.try_lock());
+		REQUIRE(!lock.try_lock());
+		REQUIRE(!lock.try_lock_shared());
+		lock.unlock();
+		REQUIRE(lock.try_lock_shared());
+		lock.unlock_shared();
+	}
+
+	SECTION("Waiting writer blocks new readers")
+	{
+		RWSpinlock lock;
+		lock.lock_shared();
+
+		std::atomic<bool> written{};
+		std::thread       writer([&] {
+			std::lock_guard guard(lock);
+			written = true;
+		});
+
+		// The writer announces itself before giving up the time slice
+		while (lock.try_lock_shared()) {
+			lock.unlock_shared();
+			std::this_thread::yield();
+		}
+		REQUIRE(!written);
+
+		lock.unlock_shared();
+		writer.join();
+		REQUIRE(written);
+		REQUIRE(lock.try_lock_shared());
+		lock.unlock_shared();
+	}
+
+	SECTION("Concurrent readers and writers")
+	{
+		RWSpinlock                   lock;
+		std::array<std::uint64_t, 4> data{};
+		std::atomic<bool>            torn{};
+
+		std::vector<std::thread> threads;
+		for (int t{}; 2 != t; ++t) {
+			threads.emplace_back([&] {
+				for (int i{}; 10000 != i; ++i) {
+					std::lock_guard guard(lock);
+					for (auto& d : data) {
+						++d;
+					}
+				}
+			});
+			threads.emplace_back([&] {
+				for (int i{}; 10000 != i; ++i) {
+					std::shared_lock guard(lock);
+					for (auto d : data) {
+						torn = torn || d != data[0];
+					}
+				}
+			});
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		REQUIRE(!torn);
+		REQUIRE(2 * 10000 == data[3]);
+	}
+}
+
+TEST_CASE("SeqLock")
+{
+	using namespace ufo;
+
+	struct Pose {
+		double   x, y, z;
+		float    yaw;
+		unsigned id;
+	};
+
+	SECTION("Load and store")
+	{
+		SeqLock<Pose> pose(Pose{1.0, 2.0, 3.0, 0.5f, 7});
+		Pose          p = pose.load();
+		REQUIRE(2.0 == p.y);
+		REQUIRE(7 == p.id);
+
+		pose.store(Pose{4.0, 5.0, 6.0, 1.5f, 8});
+		REQUIRE(pose.tryLoad(p));
+		REQUIRE(6.0 == p.z);
+		REQUIRE(1.5f == p.yaw);
+
+		pose.update([](Pose& q) { ++q.id; });
+		REQUIRE(9 == pose.load().id);
+
+		SeqLock<int> value;
+		REQUIRE(0 == value.load());
+	}
+
+	SECTION("Reads fail during a write")
+	{
+		SeqLock<int> value(1);
+		REQUIRE(value.try_lock());
+		REQUIRE(!value.try_lock());
+
+		int v = 0;
+		REQUIRE(!value.tryLoad(v));
+		value.storeUnsafe(2);
+		REQUIRE(2 == value.loadUnsafe());
+		value.unlock();
+
+		REQUIRE(value.tryLoad(v));
+		REQUIRE(2 == v);
+	}
+
+	SECTION("Readers never see a torn value")
+	{
+		SeqLock<std::array<std::uint64_t, 5>> value;
+		std::atomic<bool>                     done{};
+		std::atomic<bool>                     torn{};
+
+		std::vector<std::thread> readers;
+		for (int t{}; 2 != t; ++t) {
+			readers.emplace_back([&] {
+				while (!done) {
+					auto const a = value.load();
+					for (auto x : a) {
+						torn = torn || x != a[0];
+					}
+				}
+			});
+		}
+
+		std::thread writer([&] {
+			for (std::uint64_t i = 1; 20000 != i; ++i) {
+				value.update([i](auto& a) { a.fill(i); });
+			}
+		});
+
+		writer.join();
+		done = true;
+		for (auto& r : readers) {
+			r.join();
+		}
+
+		REQUIRE(!torn);
+		REQUIRE(19999 == value.load()[4]);
+	}
+}
@@ -0,0 +1,148 @@
+// UFO
+#include <ufo/utility/cache_line.hpp>
+#include <ufo/utility/soa_vector.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("SoAVector")
+{
+	using namespace ufo;
+
+	SECTION("Push back")
+	{
+		SoAVector<int, double, std::uint8_t> v;
+		REQUIRE(v.empty());
+		for (int i{}; 100 != i; ++i) {
+			v.push_back(i, 0.5 * i, static_cast<std::uint8_t>(i));
+		}
+		REQUIRE(100 == v.size());
+		REQUIRE(100 <= v.capacity());
+		for (int i{}; 100 != i; ++i) {
+			auto [a, b, c] = v[i];
+			REQUIRE(i == a);
+			REQUIRE(0.5 * i == b);
+			REQUIRE(static_cast<std::uint8_t>(i) == c);
+		}
+
+		v.pop_back();
+		REQUIRE(99 == v.size());
+		v.clear();
+		REQUIRE(v.empty());
+	}
+
+	SECTION("Push back own element")
+	{
+		SoAVector<int, double> v;
+		v.push_back(7, 1.5);
+		while (v.size() != v.capacity()) {
+			v.push_back(0, 0.0);
+		}
+		// Reallocates while the arguments point into the old columns
+		v.push_back(v.column<0>()[0], v.column<1>()[0]);
+		REQUIRE(7 == std::get<0>(v[v.size() - 1]));
+		REQUIRE(1.5 == std::get<1>(v[v.size() - 1]));
+	}
+
+	SECTION("Columns")
+	{
+		SoAVector<std::uint8_t, std::uint64_t, float> v(33);
+		REQUIRE(33 == v.size());
+		REQUIRE(0 == reinterpret_cast<std::uintptr_t>(v.data<0>()) % CACHE_LINE_SIZE);
+		REQUIRE(0 == reinterpret_cast<std::uintptr_t>(v.data<1>()) % CACHE_LINE_SIZE);
+		REQUIRE(0 == reinterpret_cast<std::uintptr_t>(v.data<2>()) % CACHE_LINE_SIZE);
+		for (auto x : v.column<1>()) {
+			REQUIRE(0 == x);
+		}
+
+		auto c = v.column<1>();
+		for (std::size_t i{}; c.size() != i; ++i) {
+			c[i] = i * i;
+		}
+		REQUIRE(25 == std::get<1>(v[5]));
+
+		v.resize(10);
+		REQUIRE(10 == v.size());
+		v.shrink_to_fit();
+		REQUIRE(10 == v.capacity());
+		REQUIRE(81 == std::get<1>(v[9]));
+	}
+
+	SECTION("Copy and move")
+	{
+		SoAVector<int, float> a;
+		for (int i{}; 20 != i; ++i) {
+			a.push_back(i, static_cast<float>(-i));
+		}
+
+		SoAVector<int, float> b(a);
+		REQUIRE(20 == b.size());
+		REQUIRE(std::equal(a.begin(), a.end(), b.begin()));
+
+		SoAVector<int, float> c(std::move(b));
+		REQUIRE(b.empty());
+		REQUIRE(std::equal(a.begin(), a.end(), c.begin()));
+
+		b = c;
+		REQUIRE(std::equal(a.begin(), a.end(), b.begin()));
+	}
+
+	SECTION("Iterators")
+	{
+		SoAVector<int, int> v;
+		for (int i{}; 10 != i; ++i) {
+			v.push_back(i, 10 * i);
+		}
+		REQUIRE(10 == v.end() - v.begin());
+
+		int i{};
+		for (auto [a, b] : v) {
+			REQUIRE(i == a);
+			REQUIRE(10 * i == b);
+			b = -b;
+			++i;
+		}
+		REQUIRE(-90 == std::get<1>(v[9]));
+		REQUIRE(9 == std::get<0>(*v.rbegin()));
+	}
+
+	SECTION("Sort and permute")
+	{
+		SoAVector<std::uint32_t, int> v;
+		std::uint32_t x = 12345;
+		for (int i{}; 1000 != i; ++i) {
+			x = x * 1664525u + 1013904223u;
+			v.push_back(x >> 8, i);
+		}
+		auto const copy = v;
+
+		v.sort<0>();
+		for (std::size_t i = 1; v.size() != i; ++i) {
+			REQUIRE(std::get<0>(v[i - 1]) <= std::get<0>(v[i]));
+		}
+		// Rows stay together
+		for (auto [key, idx] : v) {
+			REQUIRE(key == std::get<0>(copy[idx]));
+		}
+
+		v.sort<1>(std::greater<>{});
+		for (std::size_t i{}; v.size() != i; ++i) {
+			REQUIRE(static_cast<int>(999 - i) == std::get<1>(v[i]));
+		}
+
+		std::vector<std::size_t> perm(v.size());
+		for (std::size_t i{}; perm.size() != i; ++i) {
+			perm[i] = perm.size() - 1 - i;
+		}
+		v.permute(perm);
+		REQUIRE(std::equal(v.begin(), v.end(), copy.begin()));
+	}
+}
@@ -0,0 +1,142 @@
+// UFO
+#include <ufo/utility/sorting_network.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+template <std::size_t N>
+void checkSort(std::mt19937& gen)
+{
+	std::uniform_int_distribution<int> dist(-5, 5);
+	for (int r{}; 100 != r; ++r) {
+		std::array<int, N> a;
+		for (auto& x : a) {
+			x = dist(gen);
+		}
+		auto expected = a;
+		std::sort(expected.begin(), expected.end());
+		ufo::sortNetwork(a);
+		REQUIRE(expected == a);
+	}
+}
+
+template <std::size_t... Ns>
+void checkSorts(std::mt19937& gen, std::index_sequence<Ns...>)
+{
+	(checkSort<Ns + 1>(gen), ...);
+}
+
+constexpr bool sortsAtCompileTime()
+{
+	std::array<int, 5> a{4, 1, 3, 0, 2};
+	ufo::sortNetwork(a);
+	for (int i{}; 5 != i; ++i) {
+		if (i != a[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+}  // namespace
+
+TEST_CASE("Sorting network")
+{
+	using namespace ufo;
+
+	std::mt19937 gen(42);
+
+	SECTION("Sort")
+	{
+		checkSorts(gen, std::make_index_sequence<20>{});
+		checkSort<32>(gen);
+		STATIC_REQUIRE(sortsAtCompileTime());
+	}
+
+	SECTION("Projection")
+	{
+		std::array<std::pair<float, int>, 8> a{
+		    {{3.f, 0}, {1.f, 1}, {7.f, 2}, {0.f, 3}, {5.f, 4}, {2.f, 5}, {6.f, 6}, {4.f, 7}}};
+		sortNetwork(a, PairFirst{});
+		for (std::size_t i{}; a.size() != i; ++i) {
+			REQUIRE(static_cast<float>(i) == a[i].first);
+		}
+		REQUIRE(3 == a[0].second);
+		REQUIRE(2 == a[7].second);
+	}
+
+#if defined(__SSE2__) || defined(_M_X64)
+	SECTION("Lanes")
+	{
+		__m128 v[4]{_mm_setr_ps(3, 0, 9, 1), _mm_setr_ps(2, 1, 8, 0),
+		            _mm_setr_ps(1, 2, 7, 3), _mm_setr_ps(0, 3, 6, 2)};
+		sortNetwork(v);
+		std::array<std::array<float, 4>, 4> out;
+		for (std::size_t i{}; 4 != i; ++i) {
+			_mm_storeu_ps(out[i].data(), v[i]);
+		}
+		for (std::size_t lane{}; 4 != lane; ++lane) {
+			for (std::size_t i = 1; 4 != i; ++i) {
+				REQUIRE(out[i - 1][lane] <= out[i][lane]);
+			}
+		}
+	}
+#endif
+
+	SECTION("Reduce")
+	{
+		std::uniform_real_distribution<float> dist(-100.f, 100.f);
+		for (int r{}; 100 != r; ++r) {
+			std::array<float, 12> a;
+			for (auto& x : a) {
+				x = dist(gen);
+			}
+			a[r % 12] = a[(r + 5) % 12];  // Ties resolve to the first element
+
+			auto const expected = std::min_element(a.begin(), a.end()) - a.begin();
+			REQUIRE(static_cast<std::size_t>(expected) == reduceArgMin<12>(a.data()));
+			REQUIRE(a[expected] == reduceMin<12>(a.data()));
+
+			// Not a float array, takes the scalar path
+			std::array<double, 12> d;
+			std::copy(a.begin(), a.end(), d.begin());
+			REQUIRE(static_cast<std::size_t>(expected) == reduceArgMin<12>(d.data()));
+		}
+
+		std::array<std::pair<int, char>, 3> p{{{2, 'a'}, {1, 'b'}, {1, 'c'}}};
+		REQUIRE(1 == reduceArgMin<3>(p.data(), PairFirst{}));
+		REQUIRE('b' == reduceMin<3>(p.data(), PairFirst{}).second);
+	}
+
+	SECTION("Reduce NaN")
+	{
+		float const nan = std::numeric_limits<float>::quiet_NaN();
+		float const inf = std::numeric_limits<float>::infinity();
+
+		std::vector<float> a{nan, 3.f, nan, 2.f, 5.f, nan, nan, 4.f};
+		REQUIRE(3 == reduceArgMin<8>(a.data()));
+		REQUIRE(2.f == reduceMin<8>(a.data()));
+
+		std::vector<double> d(a.begin(), a.end());
+		REQUIRE(3 == reduceArgMin<8>(d.data()));
+
+		std::vector<float> n(8, nan);
+		REQUIRE(0 == reduceArgMin<8>(n.data()));
+		REQUIRE(std::isnan(reduceMin<8>(n.data())));
+
+		n[6] = inf;
+		REQUIRE(6 == reduceArgMin<8>(n.data()));
+		REQUIRE(inf == reduceMin<8>(n.data()));
+	}
+}
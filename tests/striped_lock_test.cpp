@@ -0,0 +1,119 @@
+// UFO
+#include <ufo/utility/adaptive_lock.hpp>
+#include <ufo/utility/striped_lock.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("StripedLock")
+{
+	using namespace ufo;
+
+	SECTION("Size")
+	{
+		REQUIRE(1024 == StripedLock<>().size());
+		REQUIRE(1024 == StripedLock<>(1000).size());
+		REQUIRE(1024 == StripedLock<>(1024).size());
+		REQUIRE(2 == StripedLock<>(1).size());
+		REQUIRE(2 == StripedLock<>(0).size());
+	}
+
+	SECTION("Index")
+	{
+		StripedLock<> table(64);
+		int           x;
+		std::string   s("stripe");
+		for (std::uint64_t key{}; 1000 != key; ++key) {
+			REQUIRE(table.size() > table.index(key));
+		}
+		REQUIRE(table.size() > table.index(&x));
+		REQUIRE(table.size() > table.index(s));
+		REQUIRE(table.index(s) == table.index(std::string("stripe")));
+		REQUIRE(&table.stripe(42) == &table.stripe(42));
+	}
+
+	SECTION("Lock and unlock")
+	{
+		StripedLock<> table(16);
+		table.lock(7);
+		REQUIRE(!table.try_lock(7));
+		table.unlock(7);
+		REQUIRE(table.try_lock(7));
+		table.unlock(7);
+	}
+
+	SECTION("Lock all")
+	{
+		StripedLock<> table(16);
+		{
+			// The same stripe is only acquired once
+			auto guard = table.lockAll(1, 2, 1, 2);
+			REQUIRE(2 >= guard.size());
+			REQUIRE(1 <= guard.size());
+			REQUIRE(!table.try_lock(1));
+			REQUIRE(!table.try_lock(2));
+
+			auto moved = std::move(guard);
+			REQUIRE(!table.try_lock(1));
+		}
+		REQUIRE(table.try_lock(1));
+		table.unlock(1);
+		REQUIRE(table.try_lock(2));
+		table.unlock(2);
+	}
+
+	SECTION("Lock range")
+	{
+		StripedLock<>    table(4);
+		std::vector<int> keys(100);
+		std::iota(keys.begin(), keys.end(), 0);
+		{
+			auto guard = table.lockRange(keys.begin(), keys.end());
+			REQUIRE(table.size() >= guard.size());
+			for (int k : keys) {
+				REQUIRE(!table.try_lock(k));
+			}
+		}
+		for (int k : keys) {
+			REQUIRE(table.try_lock(k));
+			table.unlock(k);
+		}
+	}
+
+	SECTION("Concurrent transfers")
+	{
+		StripedLock<AdaptiveLock<>> table(8);
+		std::vector<std::int64_t>   accounts(64, 1000);
+
+		std::vector<std::thread> threads;
+		for (unsigned t{}; 4 != t; ++t) {
+			threads.emplace_back([&, t] {
+				std::mt19937                               gen(t);
+				std::uniform_int_distribution<std::size_t> dist(0, accounts.size() - 1);
+				for (int i{}; 20000 != i; ++i) {
+					std::size_t const from  = dist(gen);
+					std::size_t const to    = dist(gen);
+					auto              guard = table.lockAll(from, to);
+					--accounts[from];
+					++accounts[to];
+				}
+			});
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		REQUIRE(64 * 1000 == std::accumulate(accounts.begin(), accounts.end(),
+		                                     std::int64_t(0)));
+	}
+}
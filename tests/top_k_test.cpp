@@ -0,0 +1,138 @@
+// UFO
+#include <ufo/utility/top_k.hpp>
+
+// Catch2
+#include <catch2/catch_test_macros.hpp>
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// The `k` smallest values of `v`, in ascending order
+std::vector<int> expectedTopK(std::vector<int> v, std::size_t k)
+{
+	std::sort(v.begin(), v.end());
+	v.resize(std::min(k, v.size()));
+	return v;
+}
+
+template <std::size_t K>
+void checkStaticK(std::mt19937& gen)
+{
+	std::uniform_int_distribution<int> dist(-1000, 1000);
+	for (std::size_t n : {std::size_t(0), std::size_t(1), K / 2, K, 2 * K + 1,
+	                      std::size_t(1000)}) {
+		std::vector<int> v(n);
+		for (auto& x : v) {
+			x = dist(gen);
+		}
+
+		std::vector<int> out(K, 12345);
+		auto const       end = ufo::topK<K>(v.begin(), v.end(), out.begin());
+		out.erase(end, out.end());
+		REQUIRE(expectedTopK(v, K) == out);
+	}
+}
+}  // namespace
+
+TEST_CASE("Top k")
+{
+	using namespace ufo;
+
+	std::mt19937 gen(42);
+
+	SECTION("Runtime k")
+	{
+		std::uniform_int_distribution<int> dist(0, 100);
+		std::vector<int>                   v(5000);
+		for (auto& x : v) {
+			x = dist(gen);
+		}
+
+		for (std::size_t k : {0, 1, 7, 100, 2499, 2500, 4999, 5000, 6000}) {
+			std::vector<int> out(k);
+			auto const       end = topK(v.begin(), v.end(), k, out.begin());
+			out.erase(end, out.end());
+			REQUIRE(expectedTopK(v, k) == out);
+		}
+	}
+
+	SECTION("Compile-time k")
+	{
+		checkStaticK<1>(gen);
+		checkStaticK<3>(gen);
+		checkStaticK<4>(gen);
+		checkStaticK<8>(gen);
+		checkStaticK<13>(gen);
+		checkStaticK<32>(gen);
+		checkStaticK<64>(gen);
+		// Falls back to the streaming version
+		checkStaticK<65>(gen);
+	}
+
+	SECTION("Sorted and reversed input")
+	{
+		std::vector<int> v(1000);
+		for (int i{}; 1000 != i; ++i) {
+			v[i] = i;
+		}
+		std::vector<int> out(10);
+		topK<10>(v.rbegin(), v.rend(), out.begin());
+		REQUIRE(expectedTopK(v, 10) == out);
+		topK<10>(v.begin(), v.end(), out.begin());
+		REQUIRE(expectedTopK(v, 10) == out);
+	}
+
+	SECTION("Projection")
+	{
+		// Nearest neighbours of 0.5 among points on a line
+		std::uniform_real_distribution<double> dist(-10.0, 10.0);
+		std::vector<std::pair<double, int>>    points(777);
+		for (int i{}; 777 != i; ++i) {
+			points[i] = {dist(gen), i};
+		}
+		auto const proj = [](std::pair<double, int> const& p) {
+			return std::abs(p.first - 0.5);
+		};
+
+		auto expected = points;
+		std::sort(expected.begin(), expected.end(),
+		          [&proj](auto const& a, auto const& b) { return proj(a) < proj(b); });
+		expected.resize(6);
+
+		std::vector<std::pair<double, int>> out(6);
+		topK<6>(points.begin(), points.end(), out.begin(), proj);
+		REQUIRE(expected == out);
+
+		topK(points.begin(), points.end(), 6, out.begin(), proj);
+		REQUIRE(expected == out);
+	}
+
+	SECTION("Rows")
+	{
+		std::size_t const rows = 37;
+		std::size_t const cols = 300;
+		std::vector<int>  data(rows * cols);
+		for (auto& x : data) {
+			x = static_cast<int>(gen() % 10000);
+		}
+
+		std::vector<int> out_k(rows * 5);
+		std::vector<int> out_static(rows * 5);
+		topKRows(data.data(), rows, cols, 5, out_k.data());
+		topKRows<5>(data.data(), rows, cols, out_static.data());
+
+		for (std::size_t r{}; rows != r; ++r) {
+			auto const expected = expectedTopK(
+			    std::vector<int>(data.begin() + r * cols, data.begin() + (r + 1) * cols), 5);
+			REQUIRE(std::equal(expected.begin(), expected.end(), out_k.begin() + r * 5));
+			REQUIRE(std::equal(expected.begin(), expected.end(), out_static.begin() + r * 5));
+		}
+	}
+}